@@ -0,0 +1,211 @@
+#
+# Gurobify: Gurobify provides an interface to Gurobi from GAP.
+#
+# This file runs the benchmarks. Each benchmark builds a synthetic model and
+# times the construction, update, optimisation and retrieval phases separately.
+# Every measurement is written as one line of JSON to the file named by
+# GurobifyBenchOutput (bench_output.txt by default), so that results of
+# different runs can be compared by other tools.
+#
+# Run it from the package directory with
+#
+#     gap -A -q bench/bench.g
+#
+# or with "make bench". The variables GurobifyBenchOutput, GurobifyBenchSizes,
+# GurobifyBenchSeed and GurobifyBenchRepetitions may be bound beforehand to
+# change the defaults below. If GurobifyBenchTimeLimit is bound, then it is
+# used as the time limit of every optimisation, which is useful when Gurobify
+# is built against the stub of Gurobi in stub/.
+#
+LoadPackage( "Gurobify" );
+
+if not IsBound( GurobifyBenchOutput ) then
+	GurobifyBenchOutput := "bench_output.txt";
+fi;
+if not IsBound( GurobifyBenchSizes ) then
+	GurobifyBenchSizes := [ 50, 100, 200 ];
+fi;
+if not IsBound( GurobifyBenchSeed ) then
+	GurobifyBenchSeed := 1;
+fi;
+if not IsBound( GurobifyBenchRepetitions ) then
+	GurobifyBenchRepetitions := 3;
+fi;
+
+PrintTo( GurobifyBenchOutput, "" );
+
+# Runs func, which must return a value, and returns the wall clock time taken in nanoseconds.
+GurobifyBenchTime := function( func )
+	local start;
+	start := NanosecondsSinceEpoch();
+	func();
+	return NanosecondsSinceEpoch() - start;
+end;
+
+GurobifyBenchEmit := function( benchmark, size, repetition, phase, nanoseconds, model )
+	AppendTo( GurobifyBenchOutput,
+		"{\"benchmark\": \"", benchmark, "\", ",
+		"\"size\": ", size, ", ",
+		"\"repetition\": ", repetition, ", ",
+		"\"phase\": \"", phase, "\", ",
+		"\"nanoseconds\": ", nanoseconds, ", ",
+		"\"variables\": ", GurobiNumberOfVariables( model ), ", ",
+		"\"constraints\": ", GurobiNumberOfConstraints( model ), ", ",
+		"\"nonzeros\": ", GurobiIntegerAttribute( model, "NumNZs" ), ", ",
+		"\"gurobi\": \"", JoinStringsWithSeparator( List( GurobiVersion(), String ), "." ), "\"}\n" );
+end;
+
+# Random constraints with roughly density * n non-zero coefficients in each row.
+GurobifyBenchRandomRows := function( rs, n, m, density )
+	local rows, row, i, j;
+	rows := [];
+	for i in [ 1 .. m ] do
+		row := ListWithIdenticalEntries( n, 0 );
+		for j in [ 1 .. n ] do
+			if Random( rs, 1, 1000 ) <= Int( 1000 * density ) then
+				row[j] := Random( rs, 1, 9 );
+			fi;
+		od;
+		Add( rows, row );
+	od;
+	return rows;
+end;
+
+# A model with n variables of the given type and n/2 random knapsack-like rows.
+GurobifyBenchRandomModel := function( rs, n, type, density )
+	local rows, rhs, objective, model;
+	rows := GurobifyBenchRandomRows( rs, n, QuoInt( n, 2 ), density );
+	rhs := List( rows, r -> QuoInt( Sum( r ), 2 ) );
+	objective := List( [ 1 .. n ], i -> Random( rs, 1, 9 ) );
+	return function()
+		model := GurobiNewModel( ListWithIdenticalEntries( n, type ) );
+		GurobiSetObjectiveFunction( model, objective );
+		GurobiMaximiseModel( model );
+		if type = "CONTINUOUS" then
+			GurobiSetVariableBounds( model, [ 1 .. n ], 0, 1 : undo := false );
+		fi;
+		GurobiAddMultipleConstraints( model, rows, ListWithIdenticalEntries( Size( rows ), "<" ), rhs );
+		return model;
+	end;
+end;
+
+# A Sudoku-like model on a b^2 x b^2 grid, with one binary variable for each cell and value.
+GurobifyBenchSudokuModel := function( b )
+	local n, index, rows, row, r, c, v, i, j;
+	n := b^2;
+	index := function( r, c, v )
+		return ( r - 1 ) * n^2 + ( c - 1 ) * n + v;
+	end;
+	rows := [];
+	for r in [ 1 .. n ] do
+		for c in [ 1 .. n ] do
+			row := ListWithIdenticalEntries( n^3, 0 );
+			for v in [ 1 .. n ] do
+				row[ index( r, c, v ) ] := 1;
+			od;
+			Add( rows, row );
+		od;
+	od;
+	for v in [ 1 .. n ] do
+		for r in [ 1 .. n ] do
+			row := ListWithIdenticalEntries( n^3, 0 );
+			for c in [ 1 .. n ] do
+				row[ index( r, c, v ) ] := 1;
+			od;
+			Add( rows, row );
+		od;
+		for c in [ 1 .. n ] do
+			row := ListWithIdenticalEntries( n^3, 0 );
+			for r in [ 1 .. n ] do
+				row[ index( r, c, v ) ] := 1;
+			od;
+			Add( rows, row );
+		od;
+		for i in [ 0 .. b - 1 ] do
+			for j in [ 0 .. b - 1 ] do
+				row := ListWithIdenticalEntries( n^3, 0 );
+				for r in [ 1 .. b ] do
+					for c in [ 1 .. b ] do
+						row[ index( i * b + r, j * b + c, v ) ] := 1;
+					od;
+				od;
+				Add( rows, row );
+			od;
+		od;
+	od;
+	return function()
+		local model;
+		model := GurobiNewModel( n^3, "BINARY" );
+		GurobiAddMultipleConstraints( model, rows, "=", 1 );
+		return model;
+	end;
+end;
+
+# The Kramer-Mesner style model for Steiner triple systems on v points, without a group:
+# one binary variable for each 3-subset, and one constraint for each 2-subset.
+GurobifyBenchDesignModel := function( v )
+	local blocks, pairs, rows;
+	blocks := Combinations( [ 1 .. v ], 3 );
+	pairs := Combinations( [ 1 .. v ], 2 );
+	rows := List( pairs, p -> List( blocks, function( B )
+		if IsSubset( B, p ) then
+			return 1;
+		fi;
+		return 0;
+	end ) );
+	return function()
+		local model;
+		model := GurobiNewModel( Size( blocks ), "BINARY" );
+		GurobiAddMultipleConstraints( model, rows, "=", 1 );
+		return model;
+	end;
+end;
+
+# Times all the phases for one model. The optional enumerate is the size of solutions to enumerate.
+GurobifyBenchRun := function( benchmark, size, build, enumerate )
+	local repetition, model, time;
+	for repetition in [ 1 .. GurobifyBenchRepetitions ] do
+		time := GurobifyBenchTime( function() model := build(); return true; end );
+		GurobifyBenchEmit( benchmark, size, repetition, "construction", time, model );
+		if IsBound( GurobifyBenchTimeLimit ) then
+			GurobiSetTimeLimit( model, GurobifyBenchTimeLimit );
+		fi;
+		time := GurobifyBenchTime( function() return GurobiUpdateModel( model ); end );
+		GurobifyBenchEmit( benchmark, size, repetition, "update", time, model );
+		time := GurobifyBenchTime( function() return GurobiOptimiseModel( model ); end );
+		GurobifyBenchEmit( benchmark, size, repetition, "optimise", time, model );
+		time := GurobifyBenchTime( function()
+			if GurobiOptimisationStatus( model ) = 2 then
+				GurobiSolution( model );
+				GurobiObjectiveValue( model );
+			fi;
+			GurobiVariableTypes( model );
+			return GurobiObjectiveFunction( model );
+		end );
+		GurobifyBenchEmit( benchmark, size, repetition, "retrieval", time, model );
+		if enumerate <> fail then
+			time := GurobifyBenchTime( function() return GurobiFindAllBinarySolutions( model, enumerate ); end );
+			GurobifyBenchEmit( benchmark, size, repetition, "enumeration", time, model );
+		fi;
+	od;
+end;
+
+GurobifyBenchRandom := RandomSource( IsMersenneTwister, GurobifyBenchSeed );
+
+for GurobifyBenchSize in GurobifyBenchSizes do
+	GurobifyBenchRun( "dense-binary", GurobifyBenchSize,
+		GurobifyBenchRandomModel( GurobifyBenchRandom, GurobifyBenchSize, "BINARY", 1 ), fail );
+	GurobifyBenchRun( "sparse-binary", GurobifyBenchSize,
+		GurobifyBenchRandomModel( GurobifyBenchRandom, GurobifyBenchSize, "BINARY", 1/20 ), fail );
+	GurobifyBenchRun( "dense-continuous", GurobifyBenchSize,
+		GurobifyBenchRandomModel( GurobifyBenchRandom, GurobifyBenchSize, "CONTINUOUS", 1 ), fail );
+	GurobifyBenchRun( "sparse-continuous", GurobifyBenchSize,
+		GurobifyBenchRandomModel( GurobifyBenchRandom, GurobifyBenchSize, "CONTINUOUS", 1/20 ), fail );
+od;
+
+GurobifyBenchRun( "sudoku", 2, GurobifyBenchSudokuModel( 2 ), fail );
+GurobifyBenchRun( "sudoku", 3, GurobifyBenchSudokuModel( 3 ), fail );
+GurobifyBenchRun( "design", 7, GurobifyBenchDesignModel( 7 ), 7 );
+GurobifyBenchRun( "design", 9, GurobifyBenchDesignModel( 9 ), fail );
+
+QUIT;
@@ -91,6 +91,90 @@ DeclareOperation( "GurobiAddMultipleConstraints",
 DeclareOperation( "GurobiAddMultipleConstraints",
 	[ IsGurobiModel, IsList, IsString, IsFloat] );
 
+#! @Chapter Using Gurobify
+#! @Section Adding And Deleting Constraints
+#! @Arguments Model, Variable, Value, ConstraintEquation, ConstraintSense, ConstraintRHSValue[, ConstraintName]
+#! @Returns true
+#! @Description
+#!	Adds an indicator constraint to a model: the constraint given by ConstraintEquation, ConstraintSense and
+#!	ConstraintRHSValue, as for GurobiAddConstraint, only has to hold when the binary variable with index Variable
+#!	takes the value Value, which must be 0 or 1. This avoids a big-M formulation of the same condition.
+DeclareOperation( "GurobiAddIndicatorConstraint",
+	[ IsGurobiModel, IsPosInt, IsInt, IsList, IsString, IsScalar, IsString] );
+
+DeclareOperation( "GurobiAddIndicatorConstraint",
+	[ IsGurobiModel, IsPosInt, IsInt, IsList, IsString, IsScalar] );
+
+#! @Chapter Using Gurobify
+#! @Section Adding And Deleting Constraints
+#! @Arguments Model, Indicators, ConstraintEquations, ConstraintSenses, ConstraintRHSValues[, ConstraintNames]
+#! @Returns true
+#! @Description
+#!	Adds multiple indicator constraints to a model at one time. Indicators is a list of pairs [ Variable, Value ],
+#!	and the i-th entries of the lists determine a single constraint as for GurobiAddIndicatorConstraint.
+DeclareOperation( "GurobiAddIndicatorConstraints",
+	[ IsGurobiModel, IsList, IsList, IsList, IsList, IsList] );
+
+DeclareOperation( "GurobiAddIndicatorConstraints",
+	[ IsGurobiModel, IsList, IsList, IsList, IsList] );
+
+#! @Chapter Using Gurobify
+#! @Section Adding And Deleting Constraints
+#! @Arguments Model, Type, Variables[, Weights]
+#! @Returns true
+#! @Description
+#!	Adds an SOS constraint of type 1 or 2 on the variables with indices in the list Variables. For type 1 at most one
+#!	of these variables may be nonzero, and for type 2 at most two, which must be adjacent when the variables are
+#!	ordered by their weights. Weights must be a list of distinct numbers, one for each variable, and defaults to
+#!	[ 1 .. Length(Variables) ].
+DeclareOperation( "GurobiAddSOSConstraint",
+	[ IsGurobiModel, IsPosInt, IsList, IsList] );
+
+DeclareOperation( "GurobiAddSOSConstraint",
+	[ IsGurobiModel, IsPosInt, IsList] );
+
+#! @Chapter Using Gurobify
+#! @Section Adding And Deleting Constraints
+#! @Arguments Model, Types, VariableSets[, WeightSets]
+#! @Returns true
+#! @Description
+#!	Adds multiple SOS constraints to a model at one time, where the i-th entries of the lists determine a single
+#!	constraint as for GurobiAddSOSConstraint.
+DeclareOperation( "GurobiAddSOSConstraints",
+	[ IsGurobiModel, IsList, IsList, IsList] );
+
+DeclareOperation( "GurobiAddSOSConstraints",
+	[ IsGurobiModel, IsList, IsList] );
+
+#! @Chapter Using Gurobify
+#! @Section Adding And Deleting Constraints
+#! @Arguments Model, Type, Resultant, Operands[, ConstraintName]
+#! @Returns true
+#! @Description
+#!	Adds a general constraint, which sets the variable with index Resultant to a function of the variables with
+#!	indices in the list Operands. Type must be one of "and" or "or", for binary variables, or "max", "min" or "abs",
+#!	where "abs" takes exactly one operand. For "max" and "min" the option constant can be used to give an
+#!	additional constant operand.
+DeclareOperation( "GurobiAddGeneralConstraint",
+	[ IsGurobiModel, IsString, IsPosInt, IsList, IsString] );
+
+DeclareOperation( "GurobiAddGeneralConstraint",
+	[ IsGurobiModel, IsString, IsPosInt, IsList] );
+
+#! @Chapter Using Gurobify
+#! @Section Adding And Deleting Constraints
+#! @Arguments Model, Types, Resultants, OperandSets[, ConstraintNames]
+#! @Returns true
+#! @Description
+#!	Adds multiple general constraints to a model at one time, where the i-th entries of the lists determine
+#!	a single constraint as for GurobiAddGeneralConstraint. The option constants can be used to give a list of
+#!	constant operands, with fail for constraints without one.
+DeclareOperation( "GurobiAddGeneralConstraints",
+	[ IsGurobiModel, IsList, IsList, IsList, IsList] );
+
+DeclareOperation( "GurobiAddGeneralConstraints",
+	[ IsGurobiModel, IsList, IsList, IsList] );
+
 #! @Chapter Using Gurobify
 #! @Section Optimising A Model
 #! @Arguments Model
@@ -170,6 +254,24 @@ DeclareOperation( "GurobiSetObjectiveFunction",
 DeclareOperation( "GurobiObjectiveFunction",
 	[ IsGurobiModel] );
 
+#! @Chapter Using Gurobify
+#! @Section Adding And Modifying Objective Functions
+#! @Arguments Model, Objectives
+#! @Returns true
+#! @Description
+#!	Sets several objective functions for a model, so that a single optimisation optimises them hierarchically
+#!	or blended. Objectives is a list of lists of coefficients as for GurobiSetObjectiveFunction, and the first
+#!	one also becomes the objective function of the model. The objectives with the highest priority are optimised
+#!	first, then those of the next priority without making the earlier ones worse (beyond their tolerances), and so on.
+#!	Objectives of equal priority are blended by adding them up multiplied by their weights.
+#!	By default the priorities decrease along the list, so the objectives are optimised lexicographically,
+#!	each with weight 1, absolute tolerance 1e-6 and relative tolerance 0. These can be changed with the options
+#!	priorities, weights, abstols and reltols, each a list with an entry for every objective.
+#!	All objectives are minimised or maximised as the model is, and an objective with a negative weight is
+#!	optimised in the opposite sense. The values of all objectives are returned by GurobiObjectiveValues.
+DeclareOperation( "GurobiSetObjectiveFunctions",
+	[ IsGurobiModel, IsList] );
+
 #! @Chapter Using Gurobify
 #! @Section Querying Attributes And Parameters
 #! @Arguments Model
@@ -458,6 +560,22 @@ DeclareOperation("GurobiLogToConsole",
 #!	Takes a Gurobi model and repeatedly optimises it, each time adding the previous solution as a
 #!	constraint so that it isn't found again. This continues until all solutions are found, and
 #!	then they are returned as a set. During the process the number of found solutions is displayed.
+#!	With the option iis:=true a record is returned instead, with components solutions (the set of solutions)
+#!	and iis, an irreducible inconsistent subsystem of the model once all solutions have been excluded (see
+#!	GurobiComputeIIS), or fail if the enumeration did not end with an infeasible model. The constraints added
+#!	during the enumeration are named FindAllSolutionsConstr and FindAllSolutionsSizeConstr, the other
+#!	constraints of the IIS conflict with these and can be used to prune similar models.
+#!	With the option checkpoint:=FileName the solutions found are appended to the given checkpoint file (see
+#!	GurobiWriteCheckpoint) every 100 solutions, or every n solutions with the option checkpointinterval:=n, as well
+#!	as when the enumeration finishes or times out. If the file already exists, the enumeration resumes from the
+#!	solutions stored in it, so an interrupted enumeration can be continued on a freshly built model. A checkpoint
+#!	file records the number of variables and the size, and can only be resumed with the same ones.
+#!	With the option workers:=n the enumeration is split between n worker processes, each with its own copy of
+#!	the model. The solutions are partitioned into cubes by fixing the values of a prefix of the variables, and
+#!	each worker takes the next unsolved cube whenever it finishes one. By default the prefix consists of the first
+#!	variables, enough of them to give at least 8 cubes per worker, and another list of at most 20 variables can be
+#!	given with the option prefix:=list. The solutions are returned in the order each worker found them, worker by worker,
+#!	rather than in the order of a single enumeration. The options iis and checkpoint cannot be combined with workers.
 #!	Note:
 #!		- Only for models where every variable is a binary variable.
 #!		- Only finds solution sets of a given size.
@@ -478,9 +596,31 @@ DeclareOperation("GurobiFindAllBinarySolutions",
 #!	This saves on memory, and the remaing solutions may be refound by generating the
 #!	orbit under the group. To invoke this option place a colon after the group argument and then put
 #!	representatives:=true so for example GurobiFindAllSolutions(model, size, gp : representatives:=true);
+#!	The options iis:=true, checkpoint:=FileName and checkpointinterval:=n work as above, where the checkpoint
+#!	file only holds the representatives found by Gurobi and their orbits are recomputed when resuming.
+#!	With the option count:=true only the numbers of solutions are kept, and a record is returned with components
+#!	solutions (the number of all solutions), orbits (the number of orbits) and lengths (the collected orbit lengths),
+#!	as well as representatives if representatives:=true is also given, and iis if iis:=true is given.
+#!	With the options count and representatives the orbits are not stored once their solutions are excluded, so that
+#!	the solutions kept in GAP grow with the number of orbits rather than the number of solutions. The model itself
+#!	still gets a constraint for every solution of every orbit, as without these options.
 DeclareOperation("GurobiFindAllBinarySolutions",
 	[IsGurobiModel, IsPosInt, IsGroup]);
 
+#! @Chapter Using Gurobify
+#! @Section Optimising A Model
+#! @Arguments Solutions, Group
+#! @Returns Record
+#! @Description
+#!	Sorts a list of 0/1 solutions, such as one returned by GurobiFindAllBinarySolutions, into orbits under a
+#!	permutation group acting on the positions of the solutions. The orbits are enumerated in the kernel, each one only once,
+#!	and every solution of the list found in an orbit is assigned to it, which avoids comparing orbits in GAP.
+#!	The result is a record with components representatives (the first solution of each orbit in the list),
+#!	multiplicities (the number of solutions in the list from each orbit) and classes (the position in
+#!	representatives of the orbit of each solution). The option threads:=n computes the orbits in n threads.
+DeclareOperation("GurobiSolutionOrbitRepresentatives",
+	[IsList, IsPermGroup]);
+
 #! @Chapter Using Gurobify
 #! @Section Additional Functionality
 #! @Arguments IndexSet, NumberOfIndices
@@ -605,3 +745,160 @@ DeclareOperation( "GurobiSetThreads",
 #!	Returns number of threads Gurobi is allowed to use. See the Gurobi documentation for more details.
 DeclareOperation("GurobiThreads",
 	[IsGurobiModel]);
+
+#! @Chapter Using Gurobify
+#! @Section Optimising A Model
+#! @Arguments Model, Scenarios
+#! @Returns Record of results
+#! @Description
+#!	Solves many variations of the same model, without copying the model for each of them.
+#!	Scenarios is a list of records, each of which describes one variation of the model. A record may have
+#!	the components Obj, LB, UB and RHS, each of which is a list [ Positions, Values ] giving the new values of
+#!	the corresponding attribute at the given positions. For Obj, LB and UB the positions are the indices of the
+#!	variables, starting from 1 as for IndexSetToCharacteristicVector. For RHS the positions are the positions
+#!	of the constraints, starting from 0 as for GurobiDeleteConstraints. Values may be a list of the same length
+#!	as Positions, or a single value used for every position. For example rec( RHS := [ [0, 2], [3, 5] ] ) solves
+#!	the model with the right hand sides of the first and third constraints changed to 3 and 5.
+#!	<Br/><Br/>
+#!	Each scenario starts from the basis of the previously solved one, and the model is left unchanged at the end.
+#!	The result is a record with components status, objective and runtime, which are lists whose i-th entries
+#!	are the optimisation status code, the objective value (or fail if no optimal solution was found) and the run time
+#!	of the i-th scenario. The option threads:=n spreads the scenarios over n threads, each working on its own copy
+#!	of the model, and the option solutions:=true adds the component solutions, holding the solution of each
+#!	optimal scenario. For example GurobiSolveScenarios(model, scenarios : threads:=4, solutions:=true);
+#!	With more than one thread, each further thread works on a copy of the model in a Gurobi environment of its own,
+#!	and every thread optimises with a single thread of Gurobi (the Threads parameter), so that they do not compete
+#!	for cores.
+#!	The model itself solves scenarios too, so afterwards its solution (such as GurobiSolution) is that of the last
+#!	scenario it solved, not of the model without changes.
+DeclareOperation("GurobiSolveScenarios",
+	[IsGurobiModel, IsList]);
+
+#! @Chapter Using Gurobify
+#! @Section Optimising A Model
+#! @Arguments PresolvedModel, Scenarios
+#! @Returns List of scenarios
+#! @Description
+#!	Takes a model returned by GurobiPresolveModel and a list of scenarios for the original model, as for
+#!	GurobiSolveScenarios, and translates them into scenarios for the presolved model. The positions of Obj, LB and UB
+#!	are mapped to the corresponding variables of the presolved model, and changes to the objective coefficients
+#!	of variables removed by presolve are dropped. Scenarios changing RHS cannot be translated, as presolve changes
+#!	the constraints. Since presolve may rely on the bounds of the original model, LB and UB can only tighten the
+#!	bounds of the presolved model, and cannot change the bounds of variables removed by presolve.
+#!	For example GurobiSolveScenarios(presolved, GurobiPresolvedScenarios(presolved, scenarios)) solves a batch of
+#!	objective functions of the original model against the presolved model.
+DeclareOperation("GurobiPresolvedScenarios",
+	[IsGurobiModel, IsList]);
+
+#! @Chapter Using Gurobify
+#! @Section Optimising A Model
+#! @Arguments Model
+#! @Returns Record of results
+#! @Description
+#!	Optimises a model by solving each of its connected components (see GurobiComponents) as a separate model,
+#!	which is much faster for models made up of independent parts. The result is a record with components status
+#!	(the optimisation status code of the whole model: infeasible if any component is, and optimal only if all
+#!	components are), objective and solution (the objective value and the values of the variables of the model,
+#!	or fail if it was not solved to optimality) and statuses (the status of each component).
+#!	The option threads:=n solves the components in n threads, for example GurobiOptimiseComponents(model : threads:=4);
+#!	each thread then has a Gurobi environment of its own and optimises with a single thread of Gurobi.
+#!	The model itself is not changed, and in particular does not hold the solution afterwards.
+DeclareOperation("GurobiOptimiseComponents",
+	[IsGurobiModel]);
+
+#! @Chapter Using Gurobify
+#! @Section Optimising A Model
+#! @Arguments Model, Candidates
+#! @Returns Record
+#! @Description
+#!	Checks a list of candidate solutions against the constraints of a model, without optimising it. Each candidate is
+#!	a list of values of the variables, such as a 0/1 vector. The result is a record with components feasible, a list
+#!	of true or false for the candidates, and violated, which holds for each candidate the position of the first
+#!	constraint it violates (starting from 0, as for GurobiDeleteConstraints), or fail if it satisfies all constraints.
+#!	The tolerance is the FeasibilityTol parameter of the model, and the bounds of the variables are not checked.
+#!	The constraint matrix is read from Gurobi once and kept until its constraints are changed, so that repeated checks are fast.
+#!	As for other changes, added constraints only count once the model is updated.
+#!	The option threads:=n checks the candidates in n threads.
+DeclareOperation("GurobiCheckSolutions",
+	[IsGurobiModel, IsList]);
+
+#! @Chapter Using Gurobify
+#! @Section Optimising A Model
+#! @Arguments Model
+#! @Returns Set of all solutions.
+#! @Description
+#!	Finds all solutions of a model with only binary variables, by finding all solutions of each of its connected
+#!	components (see GurobiComponents) separately, and returning all their combinations. This needs far fewer
+#!	optimisations than finding the solutions of the whole model, whose number is the product of the numbers of
+#!	solutions of the components. With the option components:=true the combinations are not formed, and instead a
+#!	list of records with components variables and solutions is returned, one for each component. Unlike
+#!	GurobiFindAllBinarySolutions, the solutions may have any size.
+DeclareOperation("GurobiFindAllComponentSolutions",
+	[IsGurobiModel]);
+
+#! @Chapter Using Gurobify
+#! @Section Creating Or Reading A Model
+#! @Arguments Model[, IndexSet, Values]
+#! @Returns A Gurobi model
+#! @Description
+#!	Returns a lazy copy of a model, which is much cheaper to create than a copy made with ShallowCopy.
+#!	The lazy copy shares the underlying Gurobi model with Model, and records fixings of variables and any constraints
+#!	added with GurobiAddConstraint without copying the model. When the lazy copy is optimised or read, its recorded changes are applied
+#!	to the shared model in place, and undone again once another model sharing it is used, so that neither Model nor the lazy copy
+#!	needs a copy of its own. The results of optimising a lazy copy can therefore be read until another model sharing it is used.
+#!	Only once the lazy copy is changed in some other way, for example with GurobiSetVariableNames, is the shared model copied and the
+#!	recorded changes applied to the copy. Likewise if Model is changed while it still shares its model, then it first makes a copy of its own,
+#!	so that lazy copies are never affected by changes to other models. A lazy copy of a lazy copy shares the same model, and inherits the recorded changes.
+#!	The shared model is freed once the last model referring to it is freed.
+#!	<Br/><Br/>
+#!	Optionally takes a list of variables IndexSet, indexed from 1 as for IndexSetToCharacteristicVector, which are fixed in the copy
+#!	to the given Values. Values may be a list of the same length as IndexSet, or a single value used for every variable.
+#!	This is intended for branching, for example GurobiLazyCopy(model, [3, 7], 0) returns a copy in which the third and seventh variables
+#!	are set to $0$.
+DeclareOperation("GurobiLazyCopy",
+	[IsGurobiModel]);
+
+DeclareOperation("GurobiLazyCopy",
+	[IsGurobiModel, IsList, IsObject]);
+
+#! @Chapter Using Gurobify
+#! @Section Modifying Attributes And Parameters
+#! @Arguments Model, IndexSet, LB, UB
+#! @Returns true
+#! @Description
+#!	Sets the lower bounds and upper bounds of the variables in IndexSet, which are indexed from 1 as for
+#!	IndexSetToCharacteristicVector. Only the given variables are changed. LB and UB may be lists of the same length
+#!	as IndexSet, or single values used for every variable, and may be integers or floats.
+#!	The previous bounds are saved, and may be restored with GurobiUndoVariableBounds. The saved bounds form a stack,
+#!	so that nested changes, for example in a branching search, can be undone in reverse order. If the previous bounds are not
+#!	needed then give the option undo:=false, so that they are not saved.
+DeclareOperation("GurobiSetVariableBounds",
+	[IsGurobiModel, IsList, IsObject, IsObject]);
+
+#! @Chapter Using Gurobify
+#! @Section Modifying Attributes And Parameters
+#! @Arguments Model, IndexSet, Values
+#! @Returns true
+#! @Description
+#!	Fixes the variables in IndexSet to the given Values, by setting both their lower bounds and upper bounds. 
+#!	Values may be a list of the same length as IndexSet, or a single value for every variable.
+#!	For example GurobiFixVariables(model, [2, 5, 11], 1) fixes the given binary variables to $1$. This is the same as
+#!	GurobiSetVariableBounds(model, IndexSet, Values, Values), and so may be undone with GurobiUndoVariableBounds.
+DeclareOperation("GurobiFixVariables",
+	[IsGurobiModel, IsList, IsObject]);
+
+#! @Chapter Using Gurobify
+#! @Section Creating Or Reading A Model
+#! @Arguments NumberOfPoints, Generators, t, k, lambda
+#! @Returns Record
+#! @Description
+#!	Builds the Kramer-Mesner model for simple t-(NumberOfPoints, k, lambda) designs invariant under the group
+#!	generated by Generators, which may be a list of permutations or of lists of images of the points 1, ..., NumberOfPoints.
+#!	The orbits of the group on t-subsets and k-subsets and the orbit incidence matrix are computed in the kernel,
+#!	and the matrix is loaded directly into the model as a sparse block of constraints. The model has a binary
+#!	variable for each orbit on k-subsets and a constraint for each orbit on t-subsets, and its solutions correspond
+#!	to the designs. The result is a record with components model, torbits and korbits, where torbits and korbits
+#!	are the smallest sets of each orbit, in the order of the constraints and variables of the model.
+#!	The option threads:=n computes the orbit incidence matrix in n threads.
+DeclareOperation("GurobiKramerMesnerModel",
+	[IsPosInt, IsList, IsInt, IsPosInt, IsInt]);
@@ -1,17 +1,22 @@
 #!/bin/sh
 gap=../..
-while getopts r:g: flag
+gurobiflag=""
+while getopts r:g:s flag
 do
     case "${flag}" in
         r) gap=${OPTARG};;
         g) gurobi=${OPTARG};;
+        s) gurobiflag="--with-gurobi-stub";;
     esac
 done
+if [ -z "$gurobiflag" ]; then
+    gurobiflag="--with-gurobi=${gurobi}"
+fi
 
 ./autogen.sh
-./configure --with-gaproot=${gap} --with-gurobi=${gurobi}
+./configure --with-gaproot=${gap} ${gurobiflag}
 ./autogen.sh
-./configure --with-gaproot=${gap} --with-gurobi=${gurobi}
+./configure --with-gaproot=${gap} ${gurobiflag}
 make
 
 echo
@@ -22,5 +27,6 @@ echo $gurobi
 echo
 echo "If these are incorrect, please try again with the following flags: "
 echo "-r <path-to-GAP-root> -g <path-to-Gurobi>"
+echo "or -s to build against the bundled stub of Gurobi instead"
 echo "(Refer to the documentation for more details)"
 echo
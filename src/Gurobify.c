@@ -13,41 +13,937 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <strings.h>
 #include <signal.h>
+#include <pthread.h>
+#include <time.h>
+#include <math.h>
+#include <limits.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
 
+/*
+	The environment in which models are created or read, see GurobifyEnv. It is only loaded once needed,
+	and freed again when the last model object is freed, see GurobiFreeFunc.
+*/
 static GRBenv *env = NULL;
+static UInt gurobify_number_of_models = 0;
+
+/*
+	Further environments in which models live, such as that of the winning copy of GurobiRaceModel, see
+	GurobifyKeepEnv. Each of them belongs to a single model and is freed together with it, so copies of
+	that model are created in env instead.
+*/
+static GRBenv **gurobify_kept_envs = NULL;
+static GRBmodel **gurobify_kept_env_owners = NULL;
+static int gurobify_number_of_kept_envs = 0;
+static int gurobify_kept_envs_capacity = 0;
+
 static GRBmodel* current_active_gurobi_model;
 
+// Models being optimised by worker threads, so that ctrl+C can stop all of them.
+static GRBmodel** current_active_gurobi_batch = NULL;
+static int current_active_gurobi_batch_size = 0;
+
+// The process group of the workers of GUROBIENUMERATECUBES and their abort flag, so that ctrl+C can stop them.
+static pid_t current_active_cube_workers = 0;
+static volatile int *current_active_cube_abort = NULL;
+
 void gurobify_signal_handler( int signal ){
-	GRBterminate(current_active_gurobi_model);
+	int i;
+	if (current_active_gurobi_model != NULL)
+		GRBterminate(current_active_gurobi_model);
+	for (i = 0; i < current_active_gurobi_batch_size; i = i+1)
+		GRBterminate(current_active_gurobi_batch[i]);
+	if (current_active_cube_workers > 0){
+		*current_active_cube_abort = 2;
+		kill(-current_active_cube_workers, SIGTERM);
+	}
 }
 
 Obj TheTypeGurobiModel;
 
+/*
+	Statistics about the calls of the kernel functions, see GurobiCallStatistics. They are only
+	recorded while switched on with GurobiRecordCallStatistics, and only by the main thread.
+
+	The number of calls and the time spent are recorded by the wrappers installed in the table of
+	exported functions at the end of this file. Inside the kernel functions, GUROBIFY_TIMED adds
+	the time spent in the Gurobi library, and GurobifyCountBytes the size of the data converted
+	between GAP objects and the arrays passed to Gurobi, to the statistic of the current call.
+*/
+
+#define GUROBIFY_MAX_STATISTICS 128
+
+typedef struct {
+	const char *name;
+	UInt calls;
+	double time;
+	double gurobi_time;
+	UInt bytes;
+} GurobifyStatistic;
+
+static GurobifyStatistic gurobify_statistics[GUROBIFY_MAX_STATISTICS];
+static int gurobify_number_of_statistics = 0;
+static int gurobify_statistics_enabled = 0;
+static int gurobify_current_statistic = -1;
+static double gurobify_current_start;
+static double gurobify_gurobi_start;
+
+static double GurobifyNow(void)
+{
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec + 1e-9 * t.tv_nsec;
+}
+
+static int GurobifyRegisterStatistic(const char *name)
+{
+	if (gurobify_number_of_statistics == GUROBIFY_MAX_STATISTICS)
+		return -1;
+	gurobify_statistics[gurobify_number_of_statistics].name = name;
+	gurobify_number_of_statistics = gurobify_number_of_statistics + 1;
+	return gurobify_number_of_statistics - 1;
+}
+
+static double GurobifyEnterStatistic(int i)
+{
+	gurobify_statistics[i].calls = gurobify_statistics[i].calls + 1;
+	gurobify_current_statistic = i;
+	gurobify_current_start = GurobifyNow();
+	return gurobify_current_start;
+}
+
+static void GurobifyLeaveStatistic(int i, double start)
+{
+	gurobify_statistics[i].time = gurobify_statistics[i].time + (GurobifyNow() - start);
+	gurobify_current_statistic = -1;
+}
+
+/*
+	ErrorMayQuit does not return to the wrapper of the kernel function, so the exit of the current call
+	is recorded before the error is raised. Every ErrorMayQuit in this file goes through here.
+*/
+
+static void GurobifyErrorMayQuit(const Char *message, Int arg1, Int arg2)
+{
+	if (gurobify_current_statistic >= 0)
+		GurobifyLeaveStatistic(gurobify_current_statistic, gurobify_current_start);
+	ErrorMayQuit(message, arg1, arg2);
+}
+
+#define ErrorMayQuit GurobifyErrorMayQuit
+
+static void GurobifyCountBytes(UInt bytes)
+{
+	if (gurobify_statistics_enabled && gurobify_current_statistic >= 0)
+		gurobify_statistics[gurobify_current_statistic].bytes = gurobify_statistics[gurobify_current_statistic].bytes + bytes;
+}
+
+static int GurobifyStopGurobiTime(int error)
+{
+	if (gurobify_current_statistic >= 0)
+		gurobify_statistics[gurobify_current_statistic].gurobi_time =
+				gurobify_statistics[gurobify_current_statistic].gurobi_time + (GurobifyNow() - gurobify_gurobi_start);
+	return error;
+}
+
+// Evaluates a call to the Gurobi library, which returns an error code, recording the time it takes.
+#define GUROBIFY_TIMED(call) \
+	(gurobify_statistics_enabled ? (gurobify_gurobi_start = GurobifyNow(), GurobifyStopGurobiTime(call)) : (call))
+
+/*
+	Returns the environment, loading it if necessary. Loading the environment checks the licence, which may
+	take a while and holds a licence token, so it is not done when the package is loaded but only when the
+	first model is created or read. While statistics are recorded, each loading counts as a call of GRBloadenv.
+*/
+
+static GRBenv *GurobifyEnv(void)
+{
+	static int statistic = -1;
+	double start, elapsed;
+	int error;
+
+	if (env != NULL)
+		return env;
+
+	start = GurobifyNow();
+	error = GUROBIFY_TIMED(GRBloadenv(&env, NULL));     // We are not interested in a log file, so the second argument of GRBloadenv is NULL
+	if (! error && env != NULL)
+		error = GRBsetintparam(env, "LogToConsole", 0);
+	if (gurobify_statistics_enabled){
+		elapsed = GurobifyNow() - start;
+		if (statistic < 0)
+			statistic = GurobifyRegisterStatistic("GRBloadenv");
+		if (statistic >= 0){
+			gurobify_statistics[statistic].calls = gurobify_statistics[statistic].calls + 1;
+			gurobify_statistics[statistic].time = gurobify_statistics[statistic].time + elapsed;
+			gurobify_statistics[statistic].gurobi_time = gurobify_statistics[statistic].gurobi_time + elapsed;
+		}
+	}
+	if (error || env == NULL){
+		if (env != NULL)
+			GRBfreeenv(env);
+		env = NULL;
+		ErrorMayQuit( "Error: failed to create new environment.", 0, 0 );
+	}
+	return env;
+}
+
+/*
+	Keeps an environment, in which only the given model lives, until that model is freed with GurobifyFreeModel
+	or the last model object is freed. Returns a Gurobi error code.
+*/
+
+static int GurobifyKeepEnv(GRBenv *kept, GRBmodel *owner)
+{
+	if (gurobify_number_of_kept_envs == gurobify_kept_envs_capacity){
+		int capacity = 2*gurobify_kept_envs_capacity + 8;
+		GRBenv **kept_envs = (GRBenv**) realloc(gurobify_kept_envs, capacity*sizeof(GRBenv*));
+		if (kept_envs == NULL)
+			return GRB_ERROR_OUT_OF_MEMORY;
+		gurobify_kept_envs = kept_envs;
+		GRBmodel **owners = (GRBmodel**) realloc(gurobify_kept_env_owners, capacity*sizeof(GRBmodel*));
+		if (owners == NULL)
+			return GRB_ERROR_OUT_OF_MEMORY;
+		gurobify_kept_env_owners = owners;
+		gurobify_kept_envs_capacity = capacity;
+	}
+	gurobify_kept_envs[gurobify_number_of_kept_envs] = kept;
+	gurobify_kept_env_owners[gurobify_number_of_kept_envs] = owner;
+	gurobify_number_of_kept_envs = gurobify_number_of_kept_envs + 1;
+	return 0;
+}
+
+/* The position of the kept environment which belongs to a model, or -1 if it lives in env */
+static int GurobifyKeptEnv(GRBmodel *model)
+{
+	int i;
+	for (i = 0; i < gurobify_number_of_kept_envs; i = i+1)
+		if (gurobify_kept_env_owners[i] == model)
+			return i;
+	return -1;
+}
+
+static void GurobifyReleaseEnv(int i)
+{
+	GRBfreeenv(gurobify_kept_envs[i]);
+	gurobify_number_of_kept_envs = gurobify_number_of_kept_envs - 1;
+	gurobify_kept_envs[i] = gurobify_kept_envs[gurobify_number_of_kept_envs];
+	gurobify_kept_env_owners[i] = gurobify_kept_env_owners[gurobify_number_of_kept_envs];
+}
+
+/* Frees a model, together with its environment if it is a kept one */
+static void GurobifyFreeModel(GRBmodel *model)
+{
+	int i = GurobifyKeptEnv(model);
+	GRBfreemodel(model);
+	if (i >= 0)
+		GurobifyReleaseEnv(i);
+}
+
+/*
+	Copies a model into env, with its parameters. This is used for models living in a kept environment,
+	which is freed together with them. Returns NULL on failure.
+*/
+
+static GRBmodel *GurobifyCopyToEnv(GRBmodel *model)
+{
+	GRBmodel *copy = GRBcopymodeltoenv(model, GurobifyEnv());
+	if (copy != NULL && GRBcopyparams(GRBgetenv(copy), GRBgetenv(model))){
+		GRBfreemodel(copy);
+		copy = NULL;
+	}
+	return copy;
+}
+
+/* Copies a model, in its own environment unless that is a kept one */
+static GRBmodel *GurobifyCopyModel(GRBmodel *model)
+{
+	if (GurobifyKeptEnv(model) >= 0)
+		return GurobifyCopyToEnv(model);
+	return GRBcopymodel(model);
+}
+
+/*
+	A scratch arena for the temporary arrays of the kernel functions, such as the coefficients of a
+	constraint converted from a GAP list. It is reset by the wrappers of the exported functions each
+	time one is called, so arrays taken from it are only valid until the function returns, and must
+	not be freed. They are not leaked when a function stops with ErrorMayQuit, and repeated calls
+	reuse the same memory instead of allocating it. Only the main thread may use the arena.
+
+	When an array does not fit, it is allocated separately and kept in a list until the next reset,
+	which replaces the arena by one large enough for all of them, up to GUROBIFY_SCRATCH_KEEP bytes.
+*/
+
+#define GUROBIFY_SCRATCH_KEEP (64 << 20)
+
+typedef struct GurobifyScratchBlock {
+	struct GurobifyScratchBlock *next;
+	double data[];
+} GurobifyScratchBlock;
+
+static char *gurobify_scratch = NULL;
+static size_t gurobify_scratch_capacity = 0;
+static size_t gurobify_scratch_used = 0;
+static size_t gurobify_scratch_overflow = 0;
+static GurobifyScratchBlock *gurobify_scratch_blocks = NULL;
+
+static void GurobifyScratchReset(void)
+{
+	size_t capacity;
+	GurobifyScratchBlock *block;
+
+	if (gurobify_scratch_blocks != NULL){
+		capacity = gurobify_scratch_used + gurobify_scratch_overflow;
+		if (capacity > GUROBIFY_SCRATCH_KEEP)
+			capacity = GUROBIFY_SCRATCH_KEEP;
+		while (gurobify_scratch_blocks != NULL){
+			block = gurobify_scratch_blocks;
+			gurobify_scratch_blocks = block->next;
+			free(block);
+		}
+		if (capacity > gurobify_scratch_capacity){
+			free(gurobify_scratch);
+			gurobify_scratch = (char*) malloc(capacity);
+			gurobify_scratch_capacity = (gurobify_scratch == NULL) ? 0 : capacity;
+		}
+	}
+	gurobify_scratch_used = 0;
+	gurobify_scratch_overflow = 0;
+}
+
+/* Returns an array of the given size from the arena, suitably aligned for any element type */
+static void *GurobifyScratch(size_t bytes)
+{
+	void *result;
+	GurobifyScratchBlock *block;
+
+	bytes = (bytes + 15) & ~(size_t) 15;
+	if (bytes == 0)
+		bytes = 16;
+	if (gurobify_scratch_used + bytes <= gurobify_scratch_capacity){
+		result = gurobify_scratch + gurobify_scratch_used;
+		gurobify_scratch_used = gurobify_scratch_used + bytes;
+		return result;
+	}
+	block = (GurobifyScratchBlock*) malloc(sizeof(GurobifyScratchBlock) + bytes);
+	if (block == NULL)
+		ErrorMayQuit( "Error: not enough memory for temporary arrays.", 0, 0 );
+	block->next = gurobify_scratch_blocks;
+	gurobify_scratch_blocks = block;
+	gurobify_scratch_overflow = gurobify_scratch_overflow + bytes;
+	return block->data;
+}
+
+/*
+	A Gurobi model which is shared between several GAP objects, see GurobiLazyCopy.
+	The model is freed when the last object referring to it is freed.
+
+	When one of the objects is optimised or read, its recorded changes are applied to the shared model
+	in place, and the bounds they replace and the constraints they add are kept here. The changes stay
+	applied, so that the results can be read, until another object sharing the model is used.
+*/
+
+typedef struct {
+	GRBmodel *model;
+	int references;
+
+	const void *applied;
+	int number_of_saved_bounds;
+	int *saved_indices;
+	double *saved_lb;
+	double *saved_ub;
+	int first_added_row;
+	int number_of_added_rows;
+} GurobifySharedModel;
+
+/* A row of the progress of an optimisation, see GurobiLogProgress */
+
+typedef struct {
+	double time;
+	double nodes;
+	double incumbent;
+	double bound;
+} GurobifyProgressRow;
+
+/*
+	Additional data kept for a GAP Gurobi model object. This is only allocated when needed.
+
+	A lazy copy has no model of its own. Instead it refers to a shared model and records
+	the changes made to it (bound changes and additional constraints), which are only
+	applied once the copy is actually needed, for example when it is optimised.
+*/
+
+typedef struct {
+	GurobifySharedModel *shared;
+
+	int number_of_bound_changes;
+	int bound_capacity;
+	int *bound_indices;
+	double *bound_lb;
+	double *bound_ub;
+
+	int number_of_rows;
+	int row_capacity;
+	int number_of_nonzeros;
+	int nonzero_capacity;
+	int *row_begin;
+	int *row_indices;
+	double *row_values;
+	char *row_sense;
+	double *row_rhs;
+	char **row_names;
+
+	// Bounds saved by GUROBISETVARIABLEBOUNDS, in frames which are restored by GurobiUndoVariableBounds.
+	int number_of_saved_bounds;
+	int saved_capacity;
+	int *saved_indices;
+	double *saved_lb;
+	double *saved_ub;
+	int number_of_frames;
+	int frame_capacity;
+	int *frame_begin;
+
+	// Recorded by GurobifyOptimiseCallback during the last call of GurobiOptimiseModel.
+	int presolve_seen;
+	int presolve_removed_variables;
+	int presolve_removed_constraints;
+
+	// Ring buffers of the log and progress captured by GurobifyOptimiseCallback, see GurobiCaptureLog.
+	int log_capacity;
+	int number_of_messages;
+	int first_message;
+	char **messages;
+	int number_of_progress_rows;
+	int first_progress_row;
+	GurobifyProgressRow *progress;
+
+	// For a model returned by GurobiPresolveModel, the index (from 0) in the original model of each variable.
+	int number_of_presolved_variables;
+	int *original_variables;
+
+	// The constraint matrix by rows, read once by GurobiCheckSolutions and dropped whenever the constraints change, see GurobifyDropMatrix.
+	// While changed constraints wait for an update, Gurobi still shows the old ones, so the matrix is read afresh for every check.
+	int matrix_valid;
+	int matrix_pending;
+	int matrix_rows;
+	int matrix_columns;
+	int *matrix_begin;
+	int *matrix_indices;
+	double *matrix_values;
+	char *matrix_sense;
+	double *matrix_rhs;
+} GurobifyModelData;
+
+#define IS_MODEL(o) (TNUM_OBJ(o) == T_GUROBI)
+
+UInt T_GUROBI = 0;
+
 void SET_MODEL(Obj o, GRBmodel* p) {
     ADDR_OBJ(o)[0] = (Obj)p;
 }
 
+GurobifyModelData* GET_DATA(Obj o) {
+    return (GurobifyModelData*)(ADDR_OBJ(o)[1]);
+}
+
+/* Returns the additional data of a model, allocating it if necessary */
+GurobifyModelData* GET_OR_NEW_DATA(Obj o) {
+    GurobifyModelData *data = GET_DATA(o);
+    if (data == NULL){
+        data = (GurobifyModelData*) calloc(1, sizeof(GurobifyModelData));
+        if (data == NULL)
+            ErrorMayQuit( "Error: out of memory", 0, 0 );
+        ADDR_OBJ(o)[1] = (Obj)data;
+    }
+    return data;
+}
+
+/* Drops the cached constraint matrix, see GurobiCheckSolutions */
+static void GurobifyFreeMatrix(GurobifyModelData *data)
+{
+    free(data->matrix_begin);
+    free(data->matrix_indices);
+    free(data->matrix_values);
+    free(data->matrix_sense);
+    free(data->matrix_rhs);
+    data->matrix_begin = NULL;
+    data->matrix_indices = NULL;
+    data->matrix_values = NULL;
+    data->matrix_sense = NULL;
+    data->matrix_rhs = NULL;
+    data->matrix_valid = 0;
+}
+
+/* Forgets the captured log and progress, but keeps capturing them */
+static void GurobifyClearLog(GurobifyModelData *data)
+{
+    int i;
+    for (i = 0; i < data->number_of_messages; i = i+1)
+        free(data->messages[(data->first_message + i) % data->log_capacity]);
+    data->number_of_messages = 0;
+    data->first_message = 0;
+    data->number_of_progress_rows = 0;
+    data->first_progress_row = 0;
+}
+
+static void GurobifyFreeLog(GurobifyModelData *data)
+{
+    GurobifyClearLog(data);
+    free(data->messages);
+    free(data->progress);
+    data->messages = NULL;
+    data->progress = NULL;
+    data->log_capacity = 0;
+}
+
+/* Returns the position in a ring buffer for a new entry, making room by dropping the oldest entry if it is full */
+static int GurobifyRingPosition(int capacity, int *number, int *first)
+{
+    int position;
+    if (*number < capacity){
+        position = (*first + *number) % capacity;
+        *number = *number + 1;
+    }
+    else {
+        position = *first;
+        *first = (*first + 1) % capacity;
+    }
+    return position;
+}
+
+static void GurobifyLogMessage(GurobifyModelData *data, const char *message)
+{
+    int length = strlen(message);
+    char *copy;
+    // Messages usually end with a newline, which is not kept.
+    if (length > 0 && message[length-1] == '\n')
+        length = length - 1;
+    copy = (char*) malloc(length+1);
+    if (copy == NULL)
+        return;
+    memcpy(copy, message, length);
+    copy[length] = '\0';
+    if (data->number_of_messages == data->log_capacity)
+        free(data->messages[data->first_message]);
+    data->messages[GurobifyRingPosition(data->log_capacity, &data->number_of_messages, &data->first_message)] = copy;
+}
+
+/* Adds a row of progress if the incumbent or bound changed, or at least a second has passed since the last row */
+static void GurobifyLogProgress(GurobifyModelData *data, GurobifyProgressRow *row)
+{
+    GurobifyProgressRow *last;
+    if (data->number_of_progress_rows > 0){
+        last = &data->progress[(data->first_progress_row + data->number_of_progress_rows - 1) % data->log_capacity];
+        if (row->incumbent == last->incumbent && row->bound == last->bound && row->time < last->time + 1.0)
+            return;
+    }
+    data->progress[GurobifyRingPosition(data->log_capacity, &data->number_of_progress_rows, &data->first_progress_row)] = *row;
+}
+
+/* Whether the model is a lazy copy which has recorded changes not yet applied */
+static int GurobifyHasPendingChanges(GurobifyModelData *data)
+{
+    return data != NULL && (data->number_of_bound_changes > 0 || data->number_of_rows > 0);
+}
+
+static void GurobifyFreePendingChanges(GurobifyModelData *data)
+{
+    int i;
+    for (i = 0; i < data->number_of_rows; i = i+1)
+        free(data->row_names[i]);
+    free(data->bound_indices);
+    free(data->bound_lb);
+    free(data->bound_ub);
+    free(data->row_begin);
+    free(data->row_indices);
+    free(data->row_values);
+    free(data->row_sense);
+    free(data->row_rhs);
+    free(data->row_names);
+    data->bound_indices = NULL;
+    data->bound_lb = NULL;
+    data->bound_ub = NULL;
+    data->row_begin = NULL;
+    data->row_indices = NULL;
+    data->row_values = NULL;
+    data->row_sense = NULL;
+    data->row_rhs = NULL;
+    data->row_names = NULL;
+    data->number_of_bound_changes = 0;
+    data->bound_capacity = 0;
+    data->number_of_rows = 0;
+    data->row_capacity = 0;
+    data->number_of_nonzeros = 0;
+    data->nonzero_capacity = 0;
+}
+
+/* Forgets the changes applied to a shared model, without undoing them */
+static void GurobifyForgetApplied(GurobifySharedModel *shared)
+{
+    free(shared->saved_indices);
+    free(shared->saved_lb);
+    free(shared->saved_ub);
+    shared->saved_indices = NULL;
+    shared->saved_lb = NULL;
+    shared->saved_ub = NULL;
+    shared->number_of_saved_bounds = 0;
+    shared->number_of_added_rows = 0;
+    shared->applied = NULL;
+}
+
+/* Undoes the changes of a lazy copy applied to a shared model, returning a Gurobi error code */
+static int GurobifyRevertShared(GurobifySharedModel *shared)
+{
+    int error = 0;
+    int i;
+
+    if (shared->applied == NULL)
+        return 0;
+
+    if (shared->number_of_added_rows > 0){
+        int *rows = (int*) malloc(shared->number_of_added_rows*sizeof(int));
+        if (rows == NULL)
+            error = GRB_ERROR_OUT_OF_MEMORY;
+        for (i = 0; i < shared->number_of_added_rows && ! error; i = i+1)
+            rows[i] = shared->first_added_row + i;
+        if (! error)
+            error = GUROBIFY_TIMED(GRBdelconstrs(shared->model, shared->number_of_added_rows, rows));
+        free(rows);
+    }
+    if (shared->number_of_saved_bounds > 0 && ! error)
+        error = GUROBIFY_TIMED(GRBsetdblattrlist(shared->model, "LB", shared->number_of_saved_bounds, shared->saved_indices, shared->saved_lb));
+    if (shared->number_of_saved_bounds > 0 && ! error)
+        error = GUROBIFY_TIMED(GRBsetdblattrlist(shared->model, "UB", shared->number_of_saved_bounds, shared->saved_indices, shared->saved_ub));
+    if (! error)
+        error = GUROBIFY_TIMED(GRBupdatemodel(shared->model));
+
+    GurobifyForgetApplied(shared);
+    return error;
+}
+
+/* Releases the reference of an object to a shared model, first undoing its changes if they are applied */
+static void GurobifyReleaseShared(GurobifySharedModel *shared, GurobifyModelData *data)
+{
+    shared->references = shared->references - 1;
+    if (shared->references == 0){
+        GurobifyForgetApplied(shared);
+        GurobifyFreeModel(shared->model);
+        free(shared);
+    }
+    else if (shared->applied == data)
+        GurobifyRevertShared(shared);
+}
+
+/* Records a change of the bounds of a variable in a lazy copy */
+static int GurobifyRecordBoundChange(GurobifyModelData *data, int index, double lb, double ub)
+{
+    if (data->shared != NULL && data->shared->applied == data && GurobifyRevertShared(data->shared))
+        return 1;
+    if (data->number_of_bound_changes == data->bound_capacity){
+        int capacity = 2*data->bound_capacity + 8;
+        int *indices = (int*) realloc(data->bound_indices, capacity*sizeof(int));
+        if (indices == NULL)
+            return 1;
+        data->bound_indices = indices;
+        double *lbs = (double*) realloc(data->bound_lb, capacity*sizeof(double));
+        if (lbs == NULL)
+            return 1;
+        data->bound_lb = lbs;
+        double *ubs = (double*) realloc(data->bound_ub, capacity*sizeof(double));
+        if (ubs == NULL)
+            return 1;
+        data->bound_ub = ubs;
+        data->bound_capacity = capacity;
+    }
+    data->bound_indices[data->number_of_bound_changes] = index;
+    data->bound_lb[data->number_of_bound_changes] = lb;
+    data->bound_ub[data->number_of_bound_changes] = ub;
+    data->number_of_bound_changes = data->number_of_bound_changes + 1;
+    return 0;
+}
+
+/* Records an additional constraint of a lazy copy */
+static int GurobifyRecordRow(GurobifyModelData *data, int numnz, int *cind, double *cval, char sense, double rhs, const char *name)
+{
+    int i;
+    GurobifyFreeMatrix(data);
+    if (data->shared != NULL && data->shared->applied == data && GurobifyRevertShared(data->shared))
+        return 1;
+    if (data->number_of_rows + 1 >= data->row_capacity){
+        int capacity = 2*data->row_capacity + 8;
+        int *begin = (int*) realloc(data->row_begin, (capacity+1)*sizeof(int));
+        if (begin == NULL)
+            return 1;
+        data->row_begin = begin;
+        char *senses = (char*) realloc(data->row_sense, capacity*sizeof(char));
+        if (senses == NULL)
+            return 1;
+        data->row_sense = senses;
+        double *rhss = (double*) realloc(data->row_rhs, capacity*sizeof(double));
+        if (rhss == NULL)
+            return 1;
+        data->row_rhs = rhss;
+        char **names = (char**) realloc(data->row_names, capacity*sizeof(char*));
+        if (names == NULL)
+            return 1;
+        data->row_names = names;
+        data->row_capacity = capacity;
+    }
+    if (data->number_of_nonzeros + numnz > data->nonzero_capacity){
+        int capacity = 2*data->nonzero_capacity + numnz + 8;
+        int *indices = (int*) realloc(data->row_indices, capacity*sizeof(int));
+        if (indices == NULL)
+            return 1;
+        data->row_indices = indices;
+        double *values = (double*) realloc(data->row_values, capacity*sizeof(double));
+        if (values == NULL)
+            return 1;
+        data->row_values = values;
+        data->nonzero_capacity = capacity;
+    }
+    data->row_begin[data->number_of_rows] = data->number_of_nonzeros;
+    for (i = 0; i < numnz; i = i+1){
+        data->row_indices[data->number_of_nonzeros + i] = cind[i];
+        data->row_values[data->number_of_nonzeros + i] = cval[i];
+    }
+    data->row_sense[data->number_of_rows] = sense;
+    data->row_rhs[data->number_of_rows] = rhs;
+    data->row_names[data->number_of_rows] = strdup(name);
+    data->number_of_nonzeros = data->number_of_nonzeros + numnz;
+    data->number_of_rows = data->number_of_rows + 1;
+    return 0;
+}
+
+/*
+	Applies the recorded changes of a lazy copy to a model. If a variable has had its bounds changed
+	several times then only the last change is used. If shared is not NULL then the changes are applied
+	to the shared model in place, keeping what is needed to undo them with GurobifyRevertShared.
+*/
+
+static int GurobifyApplyPendingChanges(GRBmodel *model, GurobifyModelData *data, GurobifySharedModel *shared)
+{
+    int error = 0;
+    int i, n, number_of_variables;
+
+    if (data->number_of_bound_changes > 0){
+        error = GRBgetintattr(model, "NumVars", &number_of_variables);
+        if (error)
+            return error;
+        char *seen = (char*) calloc(number_of_variables+1, sizeof(char));
+        int *indices = (int*) malloc(data->number_of_bound_changes*sizeof(int));
+        double *lb = (double*) malloc(data->number_of_bound_changes*sizeof(double));
+        double *ub = (double*) malloc(data->number_of_bound_changes*sizeof(double));
+        if (seen == NULL || indices == NULL || lb == NULL || ub == NULL)
+            error = 1;
+        n = 0;
+        for (i = data->number_of_bound_changes - 1; i >= 0 && ! error; i = i-1){
+            if (seen[data->bound_indices[i]])
+                continue;
+            seen[data->bound_indices[i]] = 1;
+            indices[n] = data->bound_indices[i];
+            lb[n] = data->bound_lb[i];
+            ub[n] = data->bound_ub[i];
+            n = n+1;
+        }
+        if (shared != NULL && ! error){
+            shared->saved_lb = (double*) malloc(n*sizeof(double));
+            shared->saved_ub = (double*) malloc(n*sizeof(double));
+            shared->saved_indices = (int*) malloc(n*sizeof(int));
+            if (shared->saved_lb == NULL || shared->saved_ub == NULL || shared->saved_indices == NULL)
+                error = 1;
+            if (! error)
+                error = GUROBIFY_TIMED(GRBgetdblattrlist(model, "LB", n, indices, shared->saved_lb));
+            if (! error)
+                error = GUROBIFY_TIMED(GRBgetdblattrlist(model, "UB", n, indices, shared->saved_ub));
+            if (! error){
+                memcpy(shared->saved_indices, indices, n*sizeof(int));
+                shared->number_of_saved_bounds = n;
+            }
+        }
+        if (! error)
+            error = GUROBIFY_TIMED(GRBsetdblattrlist(model, "LB", n, indices, lb));
+        if (! error)
+            error = GUROBIFY_TIMED(GRBsetdblattrlist(model, "UB", n, indices, ub));
+        free(seen);
+        free(indices);
+        free(lb);
+        free(ub);
+    }
+
+    if (data->number_of_rows > 0 && ! error){
+        if (shared != NULL)
+            error = GRBgetintattr(model, "NumConstrs", &shared->first_added_row);
+        data->row_begin[data->number_of_rows] = data->number_of_nonzeros;
+        if (! error)
+            error = GUROBIFY_TIMED(GRBaddconstrs(model, data->number_of_rows, data->number_of_nonzeros, data->row_begin,
+                        data->row_indices, data->row_values, data->row_sense, data->row_rhs, data->row_names));
+        if (shared != NULL && ! error)
+            shared->number_of_added_rows = data->number_of_rows;
+    }
+
+    if (! error)
+        error = GUROBIFY_TIMED(GRBupdatemodel(model));
+
+    return error;
+}
+
+/*
+	Gives a lazy copy a model of its own. If no other object refers to the shared model any more,
+	then it is taken over instead of being copied.
+*/
+
+static GRBmodel* GurobifyMaterialise(Obj o)
+{
+    GurobifyModelData *data = GET_DATA(o);
+    GurobifySharedModel *shared = data->shared;
+    GRBmodel *model;
+
+    if (GurobifyRevertShared(shared))
+        ErrorMayQuit( "Error: unable to undo the changes of a lazy copy", 0, 0 );
+    if (shared->references == 1){
+        model = shared->model;
+        free(shared);
+    }
+    else{
+        model = GurobifyCopyModel(shared->model);
+        if (model == NULL)
+            ErrorMayQuit( "Error: unable to copy model", 0, 0 );
+        shared->references = shared->references - 1;
+    }
+    data->shared = NULL;
+    SET_MODEL(o, model);
+
+    int error = GurobifyApplyPendingChanges(model, data, NULL);
+    GurobifyFreePendingChanges(data);
+    if (error)
+        ErrorMayQuit( "Error: unable to apply the changes of a lazy copy", 0, 0 );
+
+    return model;
+}
+
+/*
+	Returns the shared model of a lazy copy with the changes of the copy applied in place, after undoing
+	the changes of any other object sharing the model.
+*/
+
+static GRBmodel* GurobifyUseShared(Obj o)
+{
+    GurobifyModelData *data = GET_DATA(o);
+    GurobifySharedModel *shared = data->shared;
+    int error;
+
+    if (shared->applied == data)
+        return shared->model;
+    error = GurobifyRevertShared(shared);
+    if (error)
+        ErrorMayQuit( "Error: unable to undo the changes of a lazy copy", 0, 0 );
+    if (! GurobifyHasPendingChanges(data))
+        return shared->model;
+
+    shared->applied = data;
+    error = GurobifyApplyPendingChanges(shared->model, data, shared);
+    if (error){
+        GurobifyRevertShared(shared);
+        ErrorMayQuit( "Error: unable to apply the changes of a lazy copy", 0, 0 );
+    }
+    return shared->model;
+}
+
+/*
+	Returns the model of an object, which may then be changed. A lazy copy is given its own model first.
+	Functions which change the constraints must also call GurobifyDropMatrix.
+*/
+
 GRBmodel* GET_MODEL(Obj o) {
-    return (GRBmodel*)(ADDR_OBJ(o)[0]);
+    GRBmodel *model = (GRBmodel*)(ADDR_OBJ(o)[0]);
+    if (model == NULL)
+        model = GurobifyMaterialise(o);
+    return model;
 }
 
-#define IS_MODEL(o) (TNUM_OBJ(o) == T_GUROBI)
+/*
+	Returns the model of an object for reading or optimising only. A lazy copy uses the shared model,
+	with its changes applied in place.
+*/
 
-UInt T_GUROBI = 0;
+GRBmodel* GET_MODEL_READ(Obj o) {
+    GRBmodel *model = (GRBmodel*)(ADDR_OBJ(o)[0]);
+    if (model != NULL)
+        return model;
+    return GurobifyUseShared(o);
+}
+
+/* Whether the object is a lazy copy which does not yet have a model of its own */
+#define IS_LAZY_MODEL(o) (ADDR_OBJ(o)[0] == NULL)
+
+/*
+	Drops the cached constraint matrix of an object, once its rows, coefficients, senses or right hand sides change.
+	The changes of a lazy copy are applied with an update when it is next used, those of other models wait for
+	GurobifyMatrixUpdated.
+*/
+static void GurobifyDropMatrix(Obj o)
+{
+    GurobifyModelData *data = GET_OR_NEW_DATA(o);
+    if (data->matrix_valid)
+        GurobifyFreeMatrix(data);
+    data->matrix_pending = ! IS_LAZY_MODEL(o);
+}
+
+/* Allows the constraint matrix of an object to be cached again, once the model has been updated */
+static void GurobifyMatrixUpdated(Obj o)
+{
+    GurobifyModelData *data = GET_DATA(o);
+    if (data == NULL || ! data->matrix_pending)
+        return;
+    if (data->matrix_valid)
+        GurobifyFreeMatrix(data);
+    data->matrix_pending = 0;
+}
 
 Obj NewModel(GRBmodel* C)
 {
     Obj o;
-    o = NewBag(T_GUROBI, 1 * sizeof(Obj));
+    o = NewBag(T_GUROBI, 2 * sizeof(Obj));
     SET_MODEL(o, C);
+    gurobify_number_of_models = gurobify_number_of_models + 1;
     return o;
 }
 
 /* Free function */
 void GurobiFreeFunc(Obj o)
 {
-    GRBfreemodel(GET_MODEL(o));
+    GRBmodel *model = (GRBmodel*)(ADDR_OBJ(o)[0]);
+    GurobifyModelData *data = GET_DATA(o);
+    if (model != NULL)
+        GurobifyFreeModel(model);
+    if (data != NULL){
+        if (data->shared != NULL)
+            GurobifyReleaseShared(data->shared, data);
+        GurobifyFreePendingChanges(data);
+        free(data->saved_indices);
+        free(data->saved_lb);
+        free(data->saved_ub);
+        free(data->frame_begin);
+        free(data->original_variables);
+        GurobifyFreeLog(data);
+        GurobifyFreeMatrix(data);
+        free(data);
+    }
+    // Once no models are left, the environment is released, so that the licence token is returned.
+    gurobify_number_of_models = gurobify_number_of_models - 1;
+    if (gurobify_number_of_models == 0){
+        while (gurobify_number_of_kept_envs > 0)
+            GurobifyReleaseEnv(0);
+        if (env != NULL)
+            GRBfreeenv(env);
+        env = NULL;
+    }
 }
 
 /* Type object function for the object */
@@ -59,8 +955,8 @@ Obj GurobiTypeFunc(Obj o)
 Obj GurobiCopyFunc(Obj o, Int mut)
 {
 
-	GRBmodel *model = GET_MODEL(o);
-	GRBmodel *copy = GRBcopymodel(model);
+	GRBmodel *model = GET_MODEL_READ(o);
+	GRBmodel *copy = GurobifyCopyModel(model);
     return NewModel(copy);
 }
 
@@ -74,6 +970,78 @@ Int GurobiIsMutableObjFuncs(Obj o)
 }
 
 
+/*
+	Reads a value which may be given either as an integer or as a float.
+	Returns 1 if successful, and 0 if the value is neither.
+*/
+
+static int GurobifyGetDouble(Obj value, double *result)
+{
+	if (IS_INTOBJ(value)){
+		*result = (double) INT_INTOBJ(value);
+		return 1;
+	}
+	if (IS_MACFLOAT(value)){
+		*result = VAL_MACFLOAT(value);
+		return 1;
+	}
+	return 0;
+}
+
+
+/*
+	A sparse list of (index, value) pairs, as used for changing only some entries of an attribute array.
+	The arrays are taken from the scratch arena, so they need not be freed.
+*/
+
+typedef struct {
+	int length;
+	int *indices;
+	double *values;
+} GurobifySparseVector;
+
+/*
+	Converts a list of positions and either a list of values of the same length, or a single value
+	which is used for every position, into a sparse vector. Each position p is stored as p - offset,
+	so that an offset of 1 converts GAP variable indices to Gurobi indices, and an offset of 0 leaves
+	constraint positions unchanged. Every converted index must lie in [0, bound).
+*/
+
+static void GurobifyReadSparseVector(Obj Positions, Obj Values, int offset, int bound, GurobifySparseVector *v)
+{
+	int i;
+	int length;
+	double value;
+
+	if (! IS_SMALL_LIST(Positions))
+		ErrorMayQuit( "Error: Positions must be a list of integers.", 0, 0 );
+
+	length = LEN_LIST(Positions);
+	if (IS_SMALL_LIST(Values) && LEN_LIST(Values) != length)
+		ErrorMayQuit( "Error: Positions and Values must have the same length.", 0, 0 );
+
+	v->length = length;
+	v->indices = (int*) GurobifyScratch((length+1)*sizeof(int));
+	v->values = (double*) GurobifyScratch((length+1)*sizeof(double));
+	GurobifyCountBytes(length*(sizeof(int) + sizeof(double)));
+
+	for (i = 0; i < length; i = i+1){
+		Obj position = ELM_LIST(Positions, i+1);
+		if (! IS_INTOBJ(position) || INT_INTOBJ(position) - offset < 0 || INT_INTOBJ(position) - offset >= bound)
+			ErrorMayQuit( "Error: Position out of range.", 0, 0 );
+		v->indices[i] = INT_INTOBJ(position) - offset;
+
+		if (IS_SMALL_LIST(Values)){
+			if (! GurobifyGetDouble(ELM_LIST(Values, i+1), &value))
+				ErrorMayQuit( "Error: Values must be integers or floats.", 0, 0 );
+		}
+		else if (! GurobifyGetDouble(Values, &value))
+			ErrorMayQuit( "Error: Values must be integers or floats.", 0, 0 );
+		v->values[i] = value;
+	}
+}
+
+
 
 
 /*
@@ -100,7 +1068,7 @@ Obj GurobiReadModel(Obj self, Obj ModelFile )
         ErrorMayQuit( "Error: File name must be a string.", 0, 0 );
 
     char *lp_file_name = CSTR_STRING(ModelFile);
-    error = GRBreadmodel(env, lp_file_name, &model);
+    error = GUROBIFY_TIMED(GRBreadmodel(GurobifyEnv(), lp_file_name, &model));
     if (error)
         ErrorMayQuit( "Error: model was not read correctly.", 0, 0 );
 
@@ -127,15 +1095,12 @@ Obj GUROBINEWMODEL(Obj self, Obj VariableTypes)
 
     GRBmodel *model = NULL;
     int error = 0;
-	error = GRBnewmodel(env, &model, "", 0, NULL, NULL, NULL, NULL, NULL);
-		if (error)
-	        ErrorMayQuit( "Error: Unable to create new model.", 0, 0 );
 
     if ( ! IS_PLIST(VariableTypes) )
         ErrorMayQuit( "Error: VariableTypes and Varnames msut be lists!", 0, 0 );
 
 	int number_of_variables = LEN_PLIST(VariableTypes);
-	char vtype[number_of_variables];
+	char *vtype = (char*) GurobifyScratch((number_of_variables+1)*sizeof(char));
 
 	int i;
 	for (i = 0; i < number_of_variables; i = i+1){
@@ -164,7 +1129,13 @@ Obj GUROBINEWMODEL(Obj self, Obj VariableTypes)
 			ErrorMayQuit( "Error: VariableTypes must contain only 'CONTINUOUS', 'BINARY', 'INTEGER', 'SEMICONT', or 'SEMIINT' ", 0, 0 );
 	}		
 
-	error = GRBaddvars(model, number_of_variables, 0, NULL, NULL, NULL, NULL, NULL, NULL, vtype, NULL);
+	// The model is only created once the types are known to be valid, so that it is not left behind by an error.
+	error = GUROBIFY_TIMED(GRBnewmodel(GurobifyEnv(), &model, "", 0, NULL, NULL, NULL, NULL, NULL));
+		if (error)
+	        ErrorMayQuit( "Error: Unable to create new model.", 0, 0 );
+
+	GurobifyCountBytes(number_of_variables*sizeof(char));
+	error = GUROBIFY_TIMED(GRBaddvars(model, number_of_variables, 0, NULL, NULL, NULL, NULL, NULL, NULL, vtype, NULL));
     if (error)
         ErrorMayQuit( "Error: Unable to add variables.", 0, 0 );
 
@@ -191,6 +1162,7 @@ Obj GUROBISETVARIABLENAMES(Obj self, Obj GAPmodel, Obj VariableNames)
 		if (! IS_STRING(ELM_PLIST(VariableNames, i+1)))
 	        ErrorMayQuit( "Error: Variable names must be strings.", 0, 0 );
 
+		GurobifyCountBytes(GET_LEN_STRING(ELM_PLIST(VariableNames, i+1)));
 		error = GRBsetstrattrelement(model, "VarName", i, CSTR_STRING(ELM_PLIST(VariableNames, i+1)));
 	    if (error)
 	        ErrorMayQuit( "Error: Unable to set variable names.", 0, 0 );
@@ -199,6 +1171,78 @@ Obj GUROBISETVARIABLENAMES(Obj self, Obj GAPmodel, Obj VariableNames)
     return True;
 }
 
+/*
+This function is not documented.
+
+	Creates a lazy copy of a model, in which the variables in IndexSet (indexed from 1) are fixed to Values.
+	Values is either a list of the same length as IndexSet, or a single value for every variable.
+	The copy shares the model of the original object, and only records changes made to it until it is used.
+*/
+
+Obj GUROBILAZYCOPY(Obj self, Obj GAPmodel, Obj IndexSet, Obj Values)
+{
+	if (! IS_MODEL(GAPmodel))
+        ErrorMayQuit( "Error: Must pass a valid Gurobi model", 0, 0 );
+
+	int error;
+	int i;
+	GurobifyModelData *data = GET_OR_NEW_DATA(GAPmodel);
+
+	// The model of the original object is shared with the copy. Both optimise it in place, so it is only copied once one of them is changed.
+	if (! IS_LAZY_MODEL(GAPmodel)){
+		GRBmodel *model = GET_MODEL(GAPmodel);
+		error = GUROBIFY_TIMED(GRBupdatemodel(model));
+		if (error)
+			ErrorMayQuit( "Error: Unable to update model.", 0, 0 );
+		GurobifySharedModel *shared = (GurobifySharedModel*) calloc(1, sizeof(GurobifySharedModel));
+		if (shared == NULL)
+			ErrorMayQuit( "Error: out of memory", 0, 0 );
+		shared->model = model;
+		shared->references = 1;
+		data->shared = shared;
+		SET_MODEL(GAPmodel, NULL);
+	}
+
+	int number_of_variables;
+	error = GRBgetintattr(data->shared->model, "NumVars", &number_of_variables);
+	if (error)
+		ErrorMayQuit( "Error: unable to obtain number of variables", 0, 0 );
+
+	GurobifySparseVector fixings;
+	GurobifyReadSparseVector(IndexSet, Values, 1, number_of_variables, &fixings);
+
+	Obj copy = NewModel(NULL);
+	GurobifyModelData *copy_data = GET_OR_NEW_DATA(copy);
+	data = GET_DATA(GAPmodel);
+	copy_data->shared = data->shared;
+	copy_data->shared->references = copy_data->shared->references + 1;
+
+	error = 0;
+	for (i = 0; i < data->number_of_bound_changes && ! error; i = i+1)
+		error = GurobifyRecordBoundChange(copy_data, data->bound_indices[i], data->bound_lb[i], data->bound_ub[i]);
+	if (data->number_of_rows > 0)
+		data->row_begin[data->number_of_rows] = data->number_of_nonzeros;
+	for (i = 0; i < data->number_of_rows && ! error; i = i+1)
+		error = GurobifyRecordRow(copy_data, data->row_begin[i+1] - data->row_begin[i],
+					data->row_indices + data->row_begin[i], data->row_values + data->row_begin[i],
+					data->row_sense[i], data->row_rhs[i], data->row_names[i]);
+	for (i = 0; i < fixings.length && ! error; i = i+1)
+		error = GurobifyRecordBoundChange(copy_data, fixings.indices[i], fixings.values[i], fixings.values[i]);
+	if (data->original_variables != NULL && ! error){
+		copy_data->original_variables = (int*) malloc(data->number_of_presolved_variables*sizeof(int) + 1);
+		if (copy_data->original_variables == NULL)
+			error = 1;
+		else {
+			memcpy(copy_data->original_variables, data->original_variables, data->number_of_presolved_variables*sizeof(int));
+			copy_data->number_of_presolved_variables = data->number_of_presolved_variables;
+		}
+	}
+	if (error)
+		ErrorMayQuit( "Error: out of memory", 0, 0 );
+
+	return copy;
+}
+
 /*
 	#! @Chapter Using Gurobify
 	#! @Section Optimising A Model
@@ -214,6 +1258,36 @@ Obj GUROBISETVARIABLENAMES(Obj self, Obj GAPmodel, Obj VariableNames)
 	DeclareGlobalFunction("GurobiOptimiseModel");
 */
 
+/*
+	The callback installed while GurobiOptimiseModel runs. It records the number of variables
+	and constraints removed by presolve, see GurobiSolveStatistics, and if requested with
+	GurobiCaptureLog, the log and the progress of the optimisation.
+*/
+
+static int GurobifyOptimiseCallback(CB_ARGS)
+{
+	GurobifyModelData *data = (GurobifyModelData*) usrdata;
+	GurobifyProgressRow row;
+	char *message;
+	if (where == GRB_CB_PRESOLVE){
+		if (GRBcbget(cbdata, where, GRB_CB_PRE_COLDEL, &data->presolve_removed_variables) == 0
+				&& GRBcbget(cbdata, where, GRB_CB_PRE_ROWDEL, &data->presolve_removed_constraints) == 0)
+			data->presolve_seen = 1;
+	}
+	else if (where == GRB_CB_MESSAGE && data->log_capacity > 0){
+		if (GRBcbget(cbdata, where, GRB_CB_MSG_STRING, &message) == 0)
+			GurobifyLogMessage(data, message);
+	}
+	else if (where == GRB_CB_MIP && data->log_capacity > 0){
+		if (GRBcbget(cbdata, where, GRB_CB_RUNTIME, &row.time) == 0
+				&& GRBcbget(cbdata, where, GRB_CB_MIP_NODCNT, &row.nodes) == 0
+				&& GRBcbget(cbdata, where, GRB_CB_MIP_OBJBST, &row.incumbent) == 0
+				&& GRBcbget(cbdata, where, GRB_CB_MIP_OBJBND, &row.bound) == 0)
+			GurobifyLogProgress(data, &row);
+	}
+	return 0;
+}
+
 Obj GurobiOptimiseModel(Obj self, Obj GAPmodel )
 {
 
@@ -223,7 +1297,7 @@ Obj GurobiOptimiseModel(Obj self, Obj GAPmodel )
 	if (! IS_MODEL(GAPmodel))
         ErrorMayQuit( "Error: Must pass a valid Gurobi model", 0, 0 );
 
-    GRBmodel *model = GET_MODEL(GAPmodel);
+    GRBmodel *model = GET_MODEL_READ(GAPmodel);
 
     int optimstatus;
 	double objval;
@@ -233,14 +1307,24 @@ Obj GurobiOptimiseModel(Obj self, Obj GAPmodel )
 //-------------------------------------------------------------------------------------
 // Optimise the model
 
+    GurobifyModelData *data = GET_OR_NEW_DATA(GAPmodel);
+    data->presolve_seen = 0;
+    if (data->log_capacity > 0)
+        GurobifyClearLog(data);
+    error = GRBsetcallbackfunc(model, GurobifyOptimiseCallback, data);
+    if (error)
+        ErrorMayQuit( "Error: unable to set callback", 0, 0 );
+
     current_active_gurobi_model = model;
     void (*current_signal_handler)(int);
     current_signal_handler = signal(SIGINT,gurobify_signal_handler);
-    error = GRBoptimize(model);
+    error = GUROBIFY_TIMED(GRBoptimize(model));
     signal(SIGINT,current_signal_handler);
+    GRBsetcallbackfunc(model, NULL, NULL);
 
     if (error)
         ErrorMayQuit( "Error: model was not able to be optimised", 0, 0 );
+    GurobifyMatrixUpdated(GAPmodel);
 
 //-------------------------------------------------------------------------------------
 // Evaluate the outcome of the optimisation
@@ -249,9 +1333,136 @@ Obj GurobiOptimiseModel(Obj self, Obj GAPmodel )
     if (error)
         ErrorMayQuit( "Error: unable to obtain optimisation status", 0, 0 );
 
+    // The progress ends with the final state, which short optimisations may not report to the callback.
+    if (data->log_capacity > 0){
+        GurobifyProgressRow row;
+        row.incumbent = GRB_INFINITY;
+        row.bound = GRB_INFINITY;
+        if (GRBgetdblattr(model, "Runtime", &row.time) == 0 && GRBgetdblattr(model, "NodeCount", &row.nodes) == 0){
+            GRBgetdblattr(model, "ObjVal", &row.incumbent);
+            GRBgetdblattr(model, "ObjBound", &row.bound);
+            data->progress[GurobifyRingPosition(data->log_capacity, &data->number_of_progress_rows, &data->first_progress_row)] = row;
+        }
+    }
+
     return INTOBJ_INT(optimstatus);
 }
 
+/*
+	#! @Chapter Using Gurobify
+	#! @Section Additional Functionality
+	#! @Arguments Model, Capacity
+	#! @Returns true
+	#! @Description
+	#!	Captures the log and the progress of each optimisation of Model with GurobiOptimiseModel,
+	#!	which can be retrieved afterwards with GurobiLogMessages and GurobiLogProgress. At most Capacity
+	#!	lines of the log and Capacity rows of progress are kept, the oldest ones being dropped first.
+	#!	Capturing starts afresh with every optimisation. A Capacity of 0 stops capturing.
+	#!	The log is captured whether or not it is also printed (see GurobiSetLogToConsole), but not if the
+	#!	Gurobi parameter OutputFlag is 0.
+	DeclareGlobalFunction("GurobiCaptureLog");
+*/
+
+Obj GurobiCaptureLog(Obj self, Obj GAPmodel, Obj Capacity)
+{
+	if (! IS_MODEL(GAPmodel))
+        ErrorMayQuit( "Error: Must pass a valid Gurobi model", 0, 0 );
+	if (! IS_INTOBJ(Capacity) || INT_INTOBJ(Capacity) < 0)
+        ErrorMayQuit( "Error: Capacity must be a non-negative integer.", 0, 0 );
+
+	GurobifyModelData *data = GET_OR_NEW_DATA(GAPmodel);
+	GurobifyFreeLog(data);
+	if (INT_INTOBJ(Capacity) == 0)
+		return True;
+
+	data->messages = (char**) malloc(INT_INTOBJ(Capacity)*sizeof(char*));
+	data->progress = (GurobifyProgressRow*) malloc(INT_INTOBJ(Capacity)*sizeof(GurobifyProgressRow));
+	if (data->messages == NULL || data->progress == NULL){
+		GurobifyFreeLog(data);
+		ErrorMayQuit( "Error: out of memory", 0, 0 );
+	}
+	data->log_capacity = INT_INTOBJ(Capacity);
+	return True;
+}
+
+/*
+	#! @Chapter Using Gurobify
+	#! @Section Additional Functionality
+	#! @Arguments Model
+	#! @Returns list of strings
+	#! @Description
+	#!	Returns the lines of the log of the last optimisation of Model captured since calling GurobiCaptureLog.
+	DeclareGlobalFunction("GurobiLogMessages");
+*/
+
+Obj GurobiLogMessages(Obj self, Obj GAPmodel)
+{
+	int i;
+
+	if (! IS_MODEL(GAPmodel))
+        ErrorMayQuit( "Error: Must pass a valid Gurobi model", 0, 0 );
+
+	GurobifyModelData *data = GET_DATA(GAPmodel);
+	if (data == NULL || data->log_capacity == 0)
+		return NEW_PLIST(T_PLIST, 0);
+
+	Obj messages = NEW_PLIST(T_PLIST, data->number_of_messages);
+	for (i = 0; i < data->number_of_messages; i = i+1){
+		// MakeString may trigger a garbage collection, but data is not a bag, so it does not move.
+		Obj message = MakeString(data->messages[(data->first_message + i) % data->log_capacity]);
+		ASS_LIST(messages, i+1, message);
+	}
+	return messages;
+}
+
+/*
+	#! @Chapter Using Gurobify
+	#! @Section Additional Functionality
+	#! @Arguments Model
+	#! @Returns list of records
+	#! @Description
+	#!	Returns the progress of the last optimisation of Model captured since calling GurobiCaptureLog, as a list
+	#!	of records with components time (the run time in seconds), nodes (the number of explored nodes),
+	#!	incumbent (the objective value of the best solution found so far), bound (the best objective bound) and
+	#!	gap (the relative gap between incumbent and bound). A row is recorded whenever the incumbent or the bound
+	#!	changes, but at most every second otherwise, and the last row is the state at the end of the optimisation.
+	#!	The components incumbent and gap are fail as long as no solution is known, and so is bound when it is not.
+	DeclareGlobalFunction("GurobiLogProgress");
+*/
+
+Obj GurobiLogProgress(Obj self, Obj GAPmodel)
+{
+	int i;
+	GurobifyProgressRow row;
+
+	if (! IS_MODEL(GAPmodel))
+        ErrorMayQuit( "Error: Must pass a valid Gurobi model", 0, 0 );
+
+	GurobifyModelData *data = GET_DATA(GAPmodel);
+	if (data == NULL || data->log_capacity == 0)
+		return NEW_PLIST(T_PLIST, 0);
+
+	Obj progress = NEW_PLIST(T_PLIST, data->number_of_progress_rows);
+	for (i = 0; i < data->number_of_progress_rows; i = i+1){
+		row = data->progress[(data->first_progress_row + i) % data->log_capacity];
+		int has_incumbent = fabs(row.incumbent) < GRB_INFINITY;
+		int has_bound = fabs(row.bound) < GRB_INFINITY;
+		Obj entry = NEW_PREC(5);
+		AssPRec(entry, RNamName("time"), NEW_MACFLOAT(row.time));
+		AssPRec(entry, RNamName("nodes"), NEW_MACFLOAT(row.nodes));
+		AssPRec(entry, RNamName("incumbent"), has_incumbent ? NEW_MACFLOAT(row.incumbent) : Fail);
+		AssPRec(entry, RNamName("bound"), has_bound ? NEW_MACFLOAT(row.bound) : Fail);
+		if (! has_incumbent || ! has_bound || (row.incumbent == 0 && row.bound != 0))
+			AssPRec(entry, RNamName("gap"), Fail);
+		else if (row.incumbent == row.bound)
+			AssPRec(entry, RNamName("gap"), NEW_MACFLOAT(0.0));
+		else
+			AssPRec(entry, RNamName("gap"), NEW_MACFLOAT(fabs(row.incumbent - row.bound) / fabs(row.incumbent)));
+		ASS_LIST(progress, i+1, entry);
+	}
+	return progress;
+}
+
 /*
 	#! @Chapter Using Gurobify
 	#! @Section Optimising A Model
@@ -279,6 +1490,389 @@ Obj GurobiReset(Obj self, Obj GAPmodel)
 }
 
 
+/*
+	#! @Chapter Using Gurobify
+	#! @Section Querying Attributes And Parameters
+	#! @Arguments Model
+	#! @Returns record
+	#! @Description
+	#!	Returns a record with the statistics of a model and its last optimisation, obtained in a single call.
+	#!	The components are named after the Gurobi attributes Status, ObjVal, ObjBound, MIPGap, Runtime,
+	#!	Work, NodeCount, IterCount, SolCount, NumVars, NumConstrs, NumNZs, NumBinVars, NumIntVars and
+	#!	ModelSense. A component is only present if the attribute is currently available, so for example
+	#!	ObjVal is missing if no solution was found (and Work is missing for versions of Gurobi without it).
+	#!	If the last optimisation with GurobiOptimiseModel performed presolve, then the record also has
+	#!	components PresolveNumVars and PresolveNumConstrs, the numbers of variables and constraints
+	#!	remaining after presolve.
+	DeclareGlobalFunction("GurobiSolveStatistics");
+*/
+
+static const char *gurobify_solve_integer_attributes[] = {
+	"Status", "SolCount", "NumVars", "NumConstrs", "NumNZs", "NumBinVars", "NumIntVars", "ModelSense", NULL
+};
+
+static const char *gurobify_solve_double_attributes[] = {
+	"ObjVal", "ObjBound", "MIPGap", "Runtime", "Work", "NodeCount", "IterCount", NULL
+};
+
+Obj GurobiSolveStatistics(Obj self, Obj GAPmodel)
+{
+	int i;
+	int int_value;
+	double double_value;
+	int number_of_variables = -1;
+	int number_of_constraints = -1;
+
+	if (! IS_MODEL(GAPmodel))
+        ErrorMayQuit( "Error: Must pass a valid Gurobi model", 0, 0 );
+
+	GRBmodel *model = GET_MODEL_READ(GAPmodel);
+	Obj statistics = NEW_PREC(0);
+
+	for (i = 0; gurobify_solve_integer_attributes[i] != NULL; i = i+1){
+		if (GRBgetintattr(model, gurobify_solve_integer_attributes[i], &int_value) != 0)
+			continue;
+		AssPRec(statistics, RNamName(gurobify_solve_integer_attributes[i]), INTOBJ_INT(int_value));
+		if (strcmp(gurobify_solve_integer_attributes[i], "NumVars") == 0)
+			number_of_variables = int_value;
+		else if (strcmp(gurobify_solve_integer_attributes[i], "NumConstrs") == 0)
+			number_of_constraints = int_value;
+	}
+	for (i = 0; gurobify_solve_double_attributes[i] != NULL; i = i+1){
+		if (GRBgetdblattr(model, gurobify_solve_double_attributes[i], &double_value) != 0)
+			continue;
+		AssPRec(statistics, RNamName(gurobify_solve_double_attributes[i]), NEW_MACFLOAT(double_value));
+	}
+
+	GurobifyModelData *data = GET_DATA(GAPmodel);
+	if (data != NULL && data->presolve_seen && number_of_variables >= 0 && number_of_constraints >= 0){
+		AssPRec(statistics, RNamName("PresolveNumVars"),
+				INTOBJ_INT(number_of_variables - data->presolve_removed_variables));
+		AssPRec(statistics, RNamName("PresolveNumConstrs"),
+				INTOBJ_INT(number_of_constraints - data->presolve_removed_constraints));
+	}
+
+	return statistics;
+}
+
+/*
+	#! @Chapter Using Gurobify
+	#! @Section Additional Functionality
+	#! @Arguments Model
+	#! @Returns record or fail
+	#! @Description
+	#!	Takes an infeasible Gurobi model and computes an irreducible inconsistent subsystem (IIS), that is,
+	#!	a set of constraints and variable bounds which cannot be satisfied together, but can be once any one of
+	#!	them is removed. The IIS is returned as a record with components constraints (the positions of the
+	#!	constraints, counted from 0 as in GurobiDeleteConstraints), constraintnames (their names), lowerbounds and
+	#!	upperbounds (the indices of the variables whose bounds belong to the IIS). If the model is feasible,
+	#!	fail is returned. The constraint names help to identify the constraints after the model has changed.
+	DeclareGlobalFunction("GurobiComputeIIS");
+*/
+
+Obj GurobiComputeIIS(Obj self, Obj GAPmodel)
+{
+	int i;
+	int error;
+	int number_of_variables;
+	int number_of_constraints;
+	char *constraint_name;
+
+	if (! IS_MODEL(GAPmodel))
+        ErrorMayQuit( "Error: Must pass a valid Gurobi model", 0, 0 );
+
+	GRBmodel *model = GET_MODEL(GAPmodel);
+	error = GUROBIFY_TIMED(GRBcomputeIIS(model));
+	if (error == GRB_ERROR_IIS_NOT_INFEASIBLE)
+		return Fail;
+	if (error)
+		ErrorMayQuit( "Error: Unable to compute an IIS.", 0, 0 );
+
+	error = GRBgetintattr(model, "NumVars", &number_of_variables);
+	if (! error)
+		error = GRBgetintattr(model, "NumConstrs", &number_of_constraints);
+	if (error)
+		ErrorMayQuit( "Error: Unable to obtain the size of the model.", 0, 0 );
+
+	int *in_iis = (int*) GurobifyScratch((number_of_variables + number_of_constraints + 1)*sizeof(int));
+
+	Obj iis = NEW_PREC(4);
+	Obj constraints = NEW_PLIST(T_PLIST, 0);
+	Obj constraint_names = NEW_PLIST(T_PLIST, 0);
+	Obj lower_bounds = NEW_PLIST(T_PLIST, 0);
+	Obj upper_bounds = NEW_PLIST(T_PLIST, 0);
+	AssPRec(iis, RNamName("constraints"), constraints);
+	AssPRec(iis, RNamName("constraintnames"), constraint_names);
+	AssPRec(iis, RNamName("lowerbounds"), lower_bounds);
+	AssPRec(iis, RNamName("upperbounds"), upper_bounds);
+
+	error = GRBgetintattrarray(model, "IISConstr", 0, number_of_constraints, in_iis);
+	for (i = 0; ! error && i < number_of_constraints; i = i+1){
+		if (! in_iis[i])
+			continue;
+		ASS_LIST(constraints, LEN_LIST(constraints)+1, INTOBJ_INT(i));
+		error = GRBgetstrattrelement(model, "ConstrName", i, &constraint_name);
+		if (! error){
+			Obj name = MakeString(constraint_name);
+			ASS_LIST(constraint_names, LEN_LIST(constraint_names)+1, name);
+		}
+	}
+	if (! error)
+		error = GRBgetintattrarray(model, "IISLB", 0, number_of_variables, in_iis);
+	for (i = 0; ! error && i < number_of_variables; i = i+1)
+		if (in_iis[i])
+			ASS_LIST(lower_bounds, LEN_LIST(lower_bounds)+1, INTOBJ_INT(i+1));
+	if (! error)
+		error = GRBgetintattrarray(model, "IISUB", 0, number_of_variables, in_iis);
+	for (i = 0; ! error && i < number_of_variables; i = i+1)
+		if (in_iis[i])
+			ASS_LIST(upper_bounds, LEN_LIST(upper_bounds)+1, INTOBJ_INT(i+1));
+	if (error)
+		ErrorMayQuit( "Error: Unable to obtain the IIS.", 0, 0 );
+
+	return iis;
+}
+
+/*
+	#! @Chapter Using Gurobify
+	#! @Section Additional Functionality
+	#! @Arguments Model, Penalties
+	#! @Returns record
+	#! @Description
+	#!	Finds the least violation of the constraints of a Gurobi model needed to make it feasible, weighting the
+	#!	violation of each constraint by a penalty. Penalties is either a single number used for every constraint,
+	#!	or a list with one penalty for each constraint. The model itself is not changed, the feasibility
+	#!	relaxation is solved on a copy. Returns a record with component status, the optimisation status of the
+	#!	relaxation, and if it was solved to optimality also the components violation (the total weighted violation),
+	#!	violations (a list with the violation of each constraint, 0 for satisfied constraints) and solution
+	#!	(the values of the variables).
+	DeclareGlobalFunction("GurobiFeasibilityRelaxation");
+*/
+
+Obj GurobiFeasibilityRelaxation(Obj self, Obj GAPmodel, Obj Penalties)
+{
+	int i, j;
+	int error;
+	int status;
+	int number_of_variables;
+	int number_of_constraints;
+	int number_of_nonzeros;
+	double total_violation;
+	Obj penalty;
+
+	if (! IS_MODEL(GAPmodel))
+        ErrorMayQuit( "Error: Must pass a valid Gurobi model", 0, 0 );
+
+	GRBmodel *model = GET_MODEL_READ(GAPmodel);
+	error = GRBupdatemodel(model);
+	if (! error)
+		error = GRBgetintattr(model, "NumVars", &number_of_variables);
+	if (! error)
+		error = GRBgetintattr(model, "NumConstrs", &number_of_constraints);
+	if (! error)
+		error = GRBgetintattr(model, "NumNZs", &number_of_nonzeros);
+	if (error)
+		ErrorMayQuit( "Error: Unable to obtain the size of the model.", 0, 0 );
+
+	if (IS_SMALL_LIST(Penalties) && LEN_LIST(Penalties) != number_of_constraints)
+		ErrorMayQuit( "Error: Penalties must have one entry for each constraint.", 0, 0 );
+
+	double *penalties = (double*) GurobifyScratch((number_of_constraints + 1)*sizeof(double));
+	for (i = 0; i < number_of_constraints; i = i+1){
+		penalty = IS_SMALL_LIST(Penalties) ? ELM_LIST(Penalties, i+1) : Penalties;
+		if (IS_INTOBJ(penalty))
+			penalties[i] = INT_INTOBJ(penalty);
+		else if (IS_MACFLOAT(penalty))
+			penalties[i] = VAL_MACFLOAT(penalty);
+		else {
+			ErrorMayQuit( "Error: Penalties must be a number or a list of numbers.", 0, 0 );
+		}
+	}
+
+	GRBmodel *relaxation = GRBcopymodel(model);
+	if (relaxation == NULL){
+		ErrorMayQuit( "Error: Unable to copy the model.", 0, 0 );
+	}
+	// Only the constraints are relaxed, the bounds of the variables are kept.
+	error = GRBfeasrelax(relaxation, 0, 0, NULL, NULL, penalties, NULL);
+	if (! error)
+		error = GUROBIFY_TIMED(GRBoptimize(relaxation));
+	if (! error)
+		error = GRBgetintattr(relaxation, "Status", &status);
+	if (error){
+		GRBfreemodel(relaxation);
+		ErrorMayQuit( "Error: Unable to solve the feasibility relaxation.", 0, 0 );
+	}
+
+	Obj result = NEW_PREC(4);
+	AssPRec(result, RNamName("status"), INTOBJ_INT(status));
+	if (status != GRB_OPTIMAL){
+		GRBfreemodel(relaxation);
+		return result;
+	}
+
+	// The violations are measured on the constraints of the original model, as the relaxation has extra variables.
+	double *solution = (double*) GurobifyScratch((number_of_variables + 1)*sizeof(double));
+	double *rhs = (double*) GurobifyScratch((number_of_constraints + 1)*sizeof(double));
+	char *sense = (char*) GurobifyScratch(number_of_constraints + 1);
+	int *row_begin = (int*) GurobifyScratch((number_of_constraints + 1)*sizeof(int));
+	int *row_index = (int*) GurobifyScratch((number_of_nonzeros + 1)*sizeof(int));
+	double *row_value = (double*) GurobifyScratch((number_of_nonzeros + 1)*sizeof(double));
+	error = GRBgetdblattrarray(relaxation, "X", 0, number_of_variables, solution);
+	if (! error)
+		error = GRBgetdblattr(relaxation, "ObjVal", &total_violation);
+	if (! error)
+		error = GRBgetdblattrarray(model, "RHS", 0, number_of_constraints, rhs);
+	if (! error)
+		error = GRBgetcharattrarray(model, "Sense", 0, number_of_constraints, sense);
+	if (! error && number_of_constraints > 0)
+		error = GRBgetconstrs(model, &number_of_nonzeros, row_begin, row_index, row_value, 0, number_of_constraints);
+	GRBfreemodel(relaxation);
+
+	if (! error){
+		Obj violations = NEW_PLIST(T_PLIST, number_of_constraints);
+		for (i = 0; i < number_of_constraints; i = i+1){
+			int row_end = (i+1 < number_of_constraints) ? row_begin[i+1] : number_of_nonzeros;
+			double activity = 0;
+			double violation = 0;
+			for (j = row_begin[i]; j < row_end; j = j+1)
+				activity = activity + row_value[j]*solution[row_index[j]];
+			if (sense[i] != GRB_GREATER_EQUAL && activity > rhs[i])
+				violation = activity - rhs[i];
+			if (sense[i] != GRB_LESS_EQUAL && activity < rhs[i])
+				violation = rhs[i] - activity;
+			ASS_LIST(violations, i+1, NEW_MACFLOAT(violation));
+		}
+		AssPRec(result, RNamName("violations"), violations);
+		AssPRec(result, RNamName("violation"), NEW_MACFLOAT(total_violation));
+		Obj values = NEW_PLIST(T_PLIST, number_of_variables);
+		for (i = 0; i < number_of_variables; i = i+1)
+			ASS_LIST(values, i+1, NEW_MACFLOAT(solution[i]));
+		AssPRec(result, RNamName("solution"), values);
+	}
+	if (error)
+		ErrorMayQuit( "Error: Unable to obtain the solution of the feasibility relaxation.", 0, 0 );
+
+	return result;
+}
+
+/*
+	#! @Chapter Using Gurobify
+	#! @Section Creating Or Reading A Model
+	#! @Arguments Model
+	#! @Returns Presolved model
+	#! @Description
+	#!	Runs Gurobi's presolve on a model and returns the presolved model as a new Gurobi model, which can be
+	#!	optimised many times without presolving the original model again. Presolve is run without dual reductions
+	#!	and aggregation, so that the presolved model has the same feasible solutions for the remaining variables,
+	#!	whatever the objective function is. GurobiPresolvedVariables maps its variables back to the original ones.
+	#!	Variables removed by presolve have a fixed value, so the objective values of the presolved model can differ
+	#!	from those of the original model by a constant. The variables of the model should either have distinct
+	#!	names or none at all, since they are matched by name.
+	DeclareGlobalFunction("GurobiPresolveModel");
+*/
+
+Obj GurobiPresolveModel(Obj self, Obj GAPmodel)
+{
+	int i;
+	int error;
+	int dual_reductions;
+	int aggregate;
+	int number_of_variables;
+	int number_of_presolved_variables;
+	int original;
+	char *name;
+	char rest;
+
+	if (! IS_MODEL(GAPmodel))
+        ErrorMayQuit( "Error: Must pass a valid Gurobi model", 0, 0 );
+
+	GRBmodel *model = GET_MODEL(GAPmodel);
+	GRBenv *modelenv = GRBgetenv(model);
+	error = GRBgetintparam(modelenv, "DualReductions", &dual_reductions);
+	if (! error)
+		error = GRBgetintparam(modelenv, "Aggregate", &aggregate);
+	if (! error)
+		error = GRBsetintparam(modelenv, "DualReductions", 0);
+	if (! error)
+		error = GRBsetintparam(modelenv, "Aggregate", 0);
+	if (error)
+		ErrorMayQuit( "Error: Unable to set the parameters for presolve.", 0, 0 );
+
+	GRBmodel *presolved = NULL;
+	error = GRBupdatemodel(model);
+	if (! error)
+		error = GRBgetintattr(model, "NumVars", &number_of_variables);
+	if (! error)
+		presolved = GRBpresolvemodel(model);
+	GRBsetintparam(modelenv, "DualReductions", dual_reductions);
+	GRBsetintparam(modelenv, "Aggregate", aggregate);
+	// The presolved model of the winner of a race is moved out of its environment, which is freed with the winner.
+	if (presolved != NULL && GurobifyKeptEnv(model) >= 0){
+		GRBmodel *moved = GurobifyCopyToEnv(presolved);
+		GRBfreemodel(presolved);
+		presolved = moved;
+	}
+	if (presolved == NULL)
+		ErrorMayQuit( "Error: Unable to presolve the model.", 0, 0 );
+
+	// The presolved model is owned by the GAP object from here on, so it is freed even if an error follows.
+	Obj GAPpresolved = NewModel(presolved);
+	error = GRBgetintattr(presolved, "NumVars", &number_of_presolved_variables);
+	if (error)
+		ErrorMayQuit( "Error: unable to obtain number of variables", 0, 0 );
+
+	GurobifyModelData *data = GET_OR_NEW_DATA(GAPpresolved);
+	data->original_variables = (int*) malloc(number_of_presolved_variables*sizeof(int) + 1);
+	if (data->original_variables == NULL)
+		ErrorMayQuit( "Error: out of memory", 0, 0 );
+	data->number_of_presolved_variables = number_of_presolved_variables;
+
+	for (i = 0; i < number_of_presolved_variables; i = i+1){
+		if (GRBgetstrattrelement(presolved, "VarName", i, &name) != 0)
+			ErrorMayQuit( "Error: Unable to obtain the variable names of the presolved model.", 0, 0 );
+		if (GRBgetvarbyname(model, name, &original) != 0)
+			original = -1;
+		// Unnamed variables are called C0, C1, ... after their index in the original model.
+		if (original < 0 && sscanf(name, "C%d%c", &original, &rest) != 1)
+			original = -1;
+		if (original < 0 || original >= number_of_variables)
+			ErrorMayQuit( "Error: Unable to match the variables of the presolved model with the original ones.", 0, 0 );
+		data->original_variables[i] = original;
+	}
+
+	return GAPpresolved;
+}
+
+/*
+	#! @Chapter Using Gurobify
+	#! @Section Querying Attributes And Parameters
+	#! @Arguments PresolvedModel
+	#! @Returns list of indices or fail
+	#! @Description
+	#!	Takes a model returned by GurobiPresolveModel, and returns a list whose i-th entry is the index
+	#!	of the variable of the original model which is the i-th variable of the presolved model. Variables
+	#!	are indexed from 1, as for IndexSetToCharacteristicVector. Returns fail for any other model.
+	DeclareGlobalFunction("GurobiPresolvedVariables");
+*/
+
+Obj GurobiPresolvedVariables(Obj self, Obj GAPmodel)
+{
+	int i;
+
+	if (! IS_MODEL(GAPmodel))
+        ErrorMayQuit( "Error: Must pass a valid Gurobi model", 0, 0 );
+
+	GurobifyModelData *data = GET_DATA(GAPmodel);
+	if (data == NULL || data->original_variables == NULL)
+		return Fail;
+
+	Obj variables = NEW_PLIST(T_PLIST, data->number_of_presolved_variables);
+	for (i = 0; i < data->number_of_presolved_variables; i = i+1)
+		ASS_LIST(variables, i+1, INTOBJ_INT(data->original_variables[i] + 1));
+	return variables;
+}
+
 /*
 	#! @Chapter Using Gurobify
 	#! @Section Modifying Other Attributes And Parameters
@@ -369,7 +1963,7 @@ Obj GurobiIntegerParameter( Obj self, Obj GAPmodel, Obj ParameterName )
 	if (! IS_MODEL(GAPmodel))
         ErrorMayQuit( "Error: Must pass a valid Gurobi model", 0, 0 );
 
-	GRBmodel *model = GET_MODEL(GAPmodel);
+	GRBmodel *model = GET_MODEL_READ(GAPmodel);
 	GRBenv *modelenv = NULL;
 	modelenv = GRBgetenv(model);
 	int error;
@@ -403,7 +1997,7 @@ Obj GurobiDoubleParameter( Obj self, Obj GAPmodel, Obj ParameterName )
 	if (! IS_MODEL(GAPmodel))
         ErrorMayQuit( "Error: Must pass a valid Gurobi model", 0, 0 );
 
-	GRBmodel *model = GET_MODEL(GAPmodel);
+	GRBmodel *model = GET_MODEL_READ(GAPmodel);
 	GRBenv *modelenv = NULL;
 	modelenv = GRBgetenv(model);
 	int error;
@@ -420,55 +2014,267 @@ Obj GurobiDoubleParameter( Obj self, Obj GAPmodel, Obj ParameterName )
 	return NEW_MACFLOAT(current_double_value);
 }
 
+/*
+	Returns a record of the parameters of an environment which differ from their defaults.
+	The parameters of the tuner itself and the log file are left out, as they do not affect optimisation.
+*/
 
+static Obj GurobifyParameterRecord(GRBenv *env)
+{
+	int i;
+	char *name;
+	int int_value, int_min, int_max, int_default;
+	double double_value, double_min, double_max, double_default;
+	char string_value[GRB_MAX_STRLEN];
+	char string_default[GRB_MAX_STRLEN];
+
+	Obj parameters = NEW_PREC(0);
+	int number_of_parameters = GRBgetnumparams(env);
+	for (i = 0; i < number_of_parameters; i = i+1){
+		if (GRBgetparamname(env, i, &name) != 0)
+			continue;
+		if (strncasecmp(name, "Tune", 4) == 0 || strcasecmp(name, "LogFile") == 0)
+			continue;
+		switch (GRBgetparamtype(env, name)){
+			case 1:
+				if (GRBgetintparaminfo(env, name, &int_value, &int_min, &int_max, &int_default) == 0 && int_value != int_default)
+					AssPRec(parameters, RNamName(name), INTOBJ_INT(int_value));
+				break;
+			case 2:
+				if (GRBgetdblparaminfo(env, name, &double_value, &double_min, &double_max, &double_default) == 0 && double_value != double_default)
+					AssPRec(parameters, RNamName(name), NEW_MACFLOAT(double_value));
+				break;
+			case 3:
+				if (GRBgetstrparaminfo(env, name, string_value, string_default) == 0 && strcmp(string_value, string_default) != 0){
+					Obj value = MakeString(string_value);
+					AssPRec(parameters, RNamName(name), value);
+				}
+				break;
+		}
+	}
+	return parameters;
+}
 
 /*
-This function is not documented.
-
-	Adds a constraint to a gurobi model. ConstraintEquation must be a list, with entries indexed
-	by the variable set, such that each entry is the coefficient of the corresponding variable
- 	in the constraint equation. The ConstraintSense must be one of "&lt;", "&gt;" or "=",
-	where Gurobi interprets &lt; as &lt;= and &gt; as &gt;=. The ConstraintRHSValue is the value on the
-	right hand side of the constraint. A constraint may also be given a name, which helps to identify
-	the constraint if it is to be deleted at some point. May also take an empty string "" if no name is needed.
-	Note that a model must be updated or optimised before any additional constraints become effective.
+	#! @Chapter Using Gurobify
+	#! @Section Querying Other Attributes And Parameters
+	#! @Arguments Model
+	#! @Returns record
+	#! @Description
+	#!	Takes a Gurobi model and returns a record of all its parameters which differ from their default values.
+	#!	The record can be applied to other models with GurobiSetParameters.
+	DeclareGlobalFunction("GurobiParameters");
 */
 
-Obj GUROBIADDCONSTRAINT(Obj self, Obj GAPmodel, Obj AdditionalConstraintEquations, Obj AdditionalConstraintSense,
-						Obj AdditionalConstraintRHSValue, Obj ConstraintName)
+Obj GurobiParameters(Obj self, Obj GAPmodel)
 {
-
 	if (! IS_MODEL(GAPmodel))
         ErrorMayQuit( "Error: Must pass a valid Gurobi model", 0, 0 );
 
-	GRBmodel *model = GET_MODEL(GAPmodel);
-
-	if ( ! IS_PLIST(AdditionalConstraintEquations))
-	    ErrorMayQuit( "Error: AdditionalConstraintEquations must be a list.", 0, 0 );
+	GRBmodel *model = GET_MODEL_READ(GAPmodel);
+	return GurobifyParameterRecord(GRBgetenv(model));
+}
 
-	int number_of_variables;
-	number_of_variables = LEN_PLIST(AdditionalConstraintEquations);
+/*
+	#! @Chapter Using Gurobify
+	#! @Section Modifying Other Attributes And Parameters
+	#! @Arguments Model, Parameters
+	#! @Returns true
+	#! @Description
+	#!	Takes a Gurobi model and a record whose components are parameter names, and assigns each
+	#!	parameter its value in the record, such as a record returned by GurobiParameters or GurobiTuneModels.
+	#!	Integer values may be given for double-valued parameters. Parameters not in the record are unchanged.
+	DeclareGlobalFunction("GurobiSetParameters");
+*/
 
+/* Assigns each parameter of an environment its value in a record, see GurobiSetParameters */
+static void GurobifySetParameterRecord(GRBenv *modelenv, Obj Parameters)
+{
+	UInt i;
 	int error;
-	double currentVal;
-	int currentValAsInt;
-	double rhs;
 
-	if (IS_MACFLOAT(AdditionalConstraintRHSValue) ||  IS_INTOBJ(AdditionalConstraintRHSValue) ){
-		if (IS_INTOBJ(AdditionalConstraintRHSValue)){
-			currentValAsInt = INT_INTOBJ(AdditionalConstraintRHSValue);
-			rhs = (double) currentValAsInt;
-		}
-		else{
-			rhs = VAL_MACFLOAT(AdditionalConstraintRHSValue);
+	if (! IS_PREC(Parameters))
+        ErrorMayQuit( "Error: Parameters must be a record.", 0, 0 );
+
+	for (i = 1; i <= LEN_PREC(Parameters); i = i+1){
+		Obj name_string = NAME_RNAM(labs(GET_RNAM_PREC(Parameters, i)));
+		char *name = CSTR_STRING(name_string);
+		Obj value = GET_ELM_PREC(Parameters, i);
+		switch (GRBgetparamtype(modelenv, name)){
+			case 1:
+				if (! IS_INTOBJ(value))
+					ErrorMayQuit( "Error: The value of parameter %g must be an integer.", (Int) name_string, 0 );
+				error = GRBsetintparam(modelenv, name, INT_INTOBJ(value));
+				break;
+			case 2:
+				if (IS_INTOBJ(value))
+					error = GRBsetdblparam(modelenv, name, (double) INT_INTOBJ(value));
+				else if (IS_MACFLOAT(value))
+					error = GRBsetdblparam(modelenv, name, VAL_MACFLOAT(value));
+				else
+					ErrorMayQuit( "Error: The value of parameter %g must be a float.", (Int) name_string, 0 );
+				break;
+			case 3:
+				if (! IS_STRING(value))
+					ErrorMayQuit( "Error: The value of parameter %g must be a string.", (Int) name_string, 0 );
+				error = GRBsetstrparam(modelenv, name, CSTR_STRING(value));
+				break;
+			default:
+				ErrorMayQuit( "Error: Unknown parameter %g.", (Int) name_string, 0 );
 		}
+		if (error)
+			ErrorMayQuit( "Error: Unable to set parameter %g.", (Int) name_string, 0 );
 	}
-	else{
-		ErrorMayQuit( "Error: AdditionalConstraintRHSValue must be an integer or a double.", 0, 0 );
+}
+
+Obj GurobiSetParameters(Obj self, Obj GAPmodel, Obj Parameters)
+{
+	if (! IS_MODEL(GAPmodel))
+        ErrorMayQuit( "Error: Must pass a valid Gurobi model", 0, 0 );
+	if (! IS_PREC(Parameters))
+        ErrorMayQuit( "Error: Parameters must be a record.", 0, 0 );
+
+	GurobifySetParameterRecord(GRBgetenv(GET_MODEL(GAPmodel)), Parameters);
+
+	return True;
+}
+
+/*
+	#! @Chapter Using Gurobify
+	#! @Section Modifying Other Attributes And Parameters
+	#! @Arguments Model, FileName
+	#! @Returns true
+	#! @Description
+	#!	Takes a Gurobi model and sets its parameters from a parameter file (.prm), such as one written by
+	#!	GurobiWriteToFile. Parameters not in the file are unchanged.
+	DeclareGlobalFunction("GurobiReadParameters");
+*/
+
+Obj GurobiReadParameters(Obj self, Obj GAPmodel, Obj FileName)
+{
+	if (! IS_MODEL(GAPmodel))
+        ErrorMayQuit( "Error: Must pass a valid Gurobi model", 0, 0 );
+	if (! IS_STRING(FileName))
+        ErrorMayQuit( "Error: FileName must be a string.", 0, 0 );
+
+	GRBmodel *model = GET_MODEL(GAPmodel);
+	int error = GUROBIFY_TIMED(GRBreadparams(GRBgetenv(model), CSTR_STRING(FileName)));
+	if (error)
+		ErrorMayQuit( "Error: Unable to read parameters.", 0, 0 );
+
+	return True;
+}
+
+/*
+	#! @Chapter Using Gurobify
+	#! @Section Additional Functionality
+	#! @Arguments Models, TimeLimit
+	#! @Returns record or fail
+	#! @Description
+	#!	Runs the Gurobi tuning tool on a list of representative models for at most TimeLimit seconds,
+	#!	starting from the parameters of the first model, and returns the best parameters found as a record
+	#!	of the parameters which differ from their default values (see GurobiParameters). If the tuning tool
+	#!	finds no result, fail is returned. The best parameters are also set for the first model, so
+	#!	that GurobiWriteToFile can save them as a .prm file. They can be applied to other models with GurobiSetParameters.
+	DeclareGlobalFunction("GurobiTuneModels");
+*/
+
+Obj GurobiTuneModels(Obj self, Obj Models, Obj TimeLimit)
+{
+	int i;
+	int error;
+	int result_count;
+	double time_limit;
+	double old_time_limit;
+
+	if (! IS_SMALL_LIST(Models) || LEN_LIST(Models) == 0)
+        ErrorMayQuit( "Error: Models must be a non-empty list of Gurobi models.", 0, 0 );
+	if (IS_INTOBJ(TimeLimit))
+		time_limit = INT_INTOBJ(TimeLimit);
+	else if (IS_MACFLOAT(TimeLimit))
+		time_limit = VAL_MACFLOAT(TimeLimit);
+	else
+        ErrorMayQuit( "Error: TimeLimit must be a number.", 0, 0 );
+
+	int number_of_models = LEN_LIST(Models);
+	for (i = 1; i <= number_of_models; i = i+1)
+		if (! IS_MODEL(ELM_LIST(Models, i)))
+	        ErrorMayQuit( "Error: Models must be a non-empty list of Gurobi models.", 0, 0 );
+
+	GRBmodel **models = (GRBmodel**) GurobifyScratch(number_of_models*sizeof(GRBmodel*));
+	// Tuning changes the parameters of the models, so lazy copies need their own model.
+	for (i = 0; i < number_of_models; i = i+1)
+		models[i] = GET_MODEL(ELM_LIST(Models, i+1));
+
+	GRBmodel *first_model = models[0];
+	GRBenv *modelenv = GRBgetenv(first_model);
+	error = GRBgetdblparam(modelenv, "TuneTimeLimit", &old_time_limit);
+	if (! error)
+		error = GRBsetdblparam(modelenv, "TuneTimeLimit", time_limit);
+	if (! error)
+		error = GUROBIFY_TIMED(GRBtunemodels(number_of_models, models, NULL, NULL));
+	if (! error)
+		error = GRBgetintattr(first_model, "TuneResultCount", &result_count);
+	GRBsetdblparam(modelenv, "TuneTimeLimit", old_time_limit);
+	if (error)
+		ErrorMayQuit( "Error: Unable to tune the models.", 0, 0 );
+
+	if (result_count == 0)
+		return Fail;
+	// The results are sorted, the best one is first.
+	if (GRBgettuneresult(first_model, 0) != 0)
+		ErrorMayQuit( "Error: Unable to obtain the tuning result.", 0, 0 );
+
+	return GurobifyParameterRecord(modelenv);
+}
+
+
+
+/*
+This function is not documented.
+
+	Adds a constraint to a gurobi model. ConstraintEquation must be a list, with entries indexed
+	by the variable set, such that each entry is the coefficient of the corresponding variable
+ 	in the constraint equation. The ConstraintSense must be one of "&lt;", "&gt;" or "=",
+	where Gurobi interprets &lt; as &lt;= and &gt; as &gt;=. The ConstraintRHSValue is the value on the
+	right hand side of the constraint. A constraint may also be given a name, which helps to identify
+	the constraint if it is to be deleted at some point. May also take an empty string "" if no name is needed.
+	Note that a model must be updated or optimised before any additional constraints become effective.
+*/
+
+Obj GUROBIADDCONSTRAINT(Obj self, Obj GAPmodel, Obj AdditionalConstraintEquations, Obj AdditionalConstraintSense,
+						Obj AdditionalConstraintRHSValue, Obj ConstraintName)
+{
+
+	if (! IS_MODEL(GAPmodel))
+        ErrorMayQuit( "Error: Must pass a valid Gurobi model", 0, 0 );
+
+	if ( ! IS_PLIST(AdditionalConstraintEquations))
+	    ErrorMayQuit( "Error: AdditionalConstraintEquations must be a list.", 0, 0 );
+
+	int number_of_variables;
+	number_of_variables = LEN_PLIST(AdditionalConstraintEquations);
+
+	int error;
+	double currentVal;
+	int currentValAsInt;
+	double rhs;
+
+	if (IS_MACFLOAT(AdditionalConstraintRHSValue) ||  IS_INTOBJ(AdditionalConstraintRHSValue) ){
+		if (IS_INTOBJ(AdditionalConstraintRHSValue)){
+			currentValAsInt = INT_INTOBJ(AdditionalConstraintRHSValue);
+			rhs = (double) currentValAsInt;
+		}
+		else{
+			rhs = VAL_MACFLOAT(AdditionalConstraintRHSValue);
+		}
+	}
+	else{
+		ErrorMayQuit( "Error: AdditionalConstraintRHSValue must be an integer or a double.", 0, 0 );
 	}
 
-   	int* constraint_index = (int*) malloc(number_of_variables*sizeof(int));
-   	double* constraint_value = (double*) malloc(number_of_variables*sizeof(double));
+   	int* constraint_index = (int*) GurobifyScratch(number_of_variables*sizeof(int));
+   	double* constraint_value = (double*) GurobifyScratch(number_of_variables*sizeof(double));
 	int non_zero_constraints = 0;
 	int index = 0;
 	int j = 0;
@@ -506,29 +2312,353 @@ Obj GUROBIADDCONSTRAINT(Obj self, Obj GAPmodel, Obj AdditionalConstraintEquation
 		ErrorMayQuit( "Error:  sense must be <,> or = ", 0, 0 );
 	}
 
-	if ( strcmp(sense, "<") == 0 ){
-		error = GRBaddconstr(model, non_zero_constraints , constraint_index, constraint_value, GRB_LESS_EQUAL, rhs, CSTR_STRING(ConstraintName));
-		if (error)
-			ErrorMayQuit( "Error: unable to add constraint ", 0, 0 );
+	char constraint_sense;
+	if ( strcmp(sense, "<") == 0 )
+		constraint_sense = GRB_LESS_EQUAL;
+	else if ( strcmp(sense, ">" ) == 0 )
+		constraint_sense = GRB_GREATER_EQUAL;
+	else if ( strcmp(sense, "=") == 0 )
+		constraint_sense = GRB_EQUAL;
+	else
+		ErrorMayQuit( "Error:  sense must be <,> or = ", 0, 0 );
+
+	GurobifyCountBytes(non_zero_constraints*(sizeof(int) + sizeof(double)));
+
+	// A lazy copy only records the constraint, which is added when the copy is next used.
+	GurobifyDropMatrix(GAPmodel);
+	if (IS_LAZY_MODEL(GAPmodel))
+		error = GurobifyRecordRow(GET_OR_NEW_DATA(GAPmodel), non_zero_constraints, constraint_index, constraint_value,
+					constraint_sense, rhs, CSTR_STRING(ConstraintName));
+	else
+		error = GUROBIFY_TIMED(GRBaddconstr(GET_MODEL(GAPmodel), non_zero_constraints , constraint_index, constraint_value,
+					constraint_sense, rhs, CSTR_STRING(ConstraintName)));
+	if (error)
+		ErrorMayQuit( "Error: unable to add constraint ", 0, 0 );
+
+	return 0;
+}
+
+
+/*
+	Reads a constraint sense "<", ">" or "=" and returns the corresponding Gurobi sense.
+*/
+
+static char GurobifyGetSense(Obj Sense)
+{
+	if (! IS_STRING(Sense))
+		ErrorMayQuit( "Error: sense must be a string.", 0, 0 );
+	if ( strcmp(CSTR_STRING(Sense), "<") == 0 )
+		return GRB_LESS_EQUAL;
+	if ( strcmp(CSTR_STRING(Sense), ">") == 0 )
+		return GRB_GREATER_EQUAL;
+	if ( strcmp(CSTR_STRING(Sense), "=") == 0 )
+		return GRB_EQUAL;
+	ErrorMayQuit( "Error:  sense must be <,> or = ", 0, 0 );
+	return 0;
+}
+
+/*
+	Reads a list of GAP variable indices into a newly allocated array of Gurobi indices,
+	checking that each lies between 1 and number_of_variables.
+*/
+
+static int *GurobifyGetVariables(Obj Variables, int number_of_variables, int *length)
+{
+	int i;
+	int *indices;
+	Obj entry;
+
+	if (! IS_SMALL_LIST(Variables))
+		ErrorMayQuit( "Error: variables must be given as a list of integers.", 0, 0 );
+	*length = LEN_LIST(Variables);
+	indices = (int*) GurobifyScratch((*length+1)*sizeof(int));
+	for (i = 0; i < *length; i = i+1){
+		entry = ELM_LIST(Variables, i+1);
+		if (! IS_INTOBJ(entry) || INT_INTOBJ(entry) < 1 || INT_INTOBJ(entry) > number_of_variables){
+			ErrorMayQuit( "Error: variable index out of range.", 0, 0 );
+		}
+		indices[i] = INT_INTOBJ(entry) - 1;
 	}
-	else if ( strcmp(sense, ">" ) == 0 ){
-		error = GRBaddconstr(model, non_zero_constraints , constraint_index, constraint_value, GRB_GREATER_EQUAL, rhs, CSTR_STRING(ConstraintName));
-		if (error)
-			ErrorMayQuit( "Error: unable to add constraint ", 0, 0 );
+	return indices;
+}
+
+/*
+	Checks that the list arguments of the batch constraint functions all have the same length.
+*/
+
+static int GurobifyBatchLength(Obj First, Obj Second, Obj Third)
+{
+	if (! IS_SMALL_LIST(First) || ! IS_SMALL_LIST(Second) || ! IS_SMALL_LIST(Third))
+		ErrorMayQuit( "Error: constraints must be given as lists.", 0, 0 );
+	if (LEN_LIST(First) != LEN_LIST(Second) || LEN_LIST(First) != LEN_LIST(Third))
+		ErrorMayQuit( "Error: all lists of constraint data must have the same length.", 0, 0 );
+	return LEN_LIST(First);
+}
+
+static char *GurobifyBatchName(Obj Names, int i)
+{
+	Obj name;
+	if (! IS_SMALL_LIST(Names) || LEN_LIST(Names) < i)
+		ErrorMayQuit( "Error: Names must be a list of strings with one entry for each constraint.", 0, 0 );
+	name = ELM_LIST(Names, i);
+	if (! IS_STRING(name))
+		ErrorMayQuit( "Error: Names must be a list of strings with one entry for each constraint.", 0, 0 );
+	return CSTR_STRING(name);
+}
+
+
+/*
+This function is not documented.
 
+	Adds a list of indicator constraints to a model. Indicators is a list of pairs [ Variable, Value ],
+	where Variable is a binary variable and Value is 0 or 1; the linear constraint with the dense coefficient
+	list Equations[i], sense Senses[i] and right hand side RHSs[i] only has to hold when Variable takes the
+	value Value. Names is a list of strings, which may be empty.
+*/
+
+Obj GUROBIADDINDICATORCONSTRAINTS(Obj self, Obj GAPmodel, Obj Indicators, Obj Equations, Obj Senses, Obj RHSs, Obj Names)
+{
+	GRBmodel *model;
+	Obj indicator, equation;
+	int number_of_constraints, number_of_variables, non_zeros;
+	int i, j, error;
+	int binary_variable, binary_value;
+	int *constraint_index;
+	double *constraint_value;
+	double value, rhs;
+	char sense;
+
+	if (! IS_MODEL(GAPmodel))
+		ErrorMayQuit( "Error: Must pass a valid Gurobi model", 0, 0 );
+
+	number_of_constraints = GurobifyBatchLength(Indicators, Equations, Senses);
+	if (! IS_SMALL_LIST(RHSs) || LEN_LIST(RHSs) != number_of_constraints)
+		ErrorMayQuit( "Error: all lists of constraint data must have the same length.", 0, 0 );
+	if (! IS_SMALL_LIST(Names))
+		ErrorMayQuit( "Error: Names must be a list of strings.", 0, 0 );
+
+	model = GET_MODEL(GAPmodel);
+	error = GRBgetintattr(model, "NumVars", &number_of_variables);
+	if (error)
+		ErrorMayQuit( "Error: unable to add indicator constraints.", 0, 0 );
+
+	constraint_index = (int*) GurobifyScratch((number_of_variables+1)*sizeof(int));
+	constraint_value = (double*) GurobifyScratch((number_of_variables+1)*sizeof(double));
+
+	// The whole batch is checked before the first constraint is added, so that an error leaves the model as it was.
+	for (i = 0; i < number_of_constraints; i = i+1){
+		indicator = ELM_LIST(Indicators, i+1);
+		if (! IS_SMALL_LIST(indicator) || LEN_LIST(indicator) != 2 || ! IS_INTOBJ(ELM_LIST(indicator, 1))
+				|| ! IS_INTOBJ(ELM_LIST(indicator, 2)))
+			ErrorMayQuit( "Error: each indicator must be a pair [ Variable, Value ].", 0, 0 );
+		binary_variable = INT_INTOBJ(ELM_LIST(indicator, 1));
+		binary_value = INT_INTOBJ(ELM_LIST(indicator, 2));
+		if (binary_variable < 1 || binary_variable > number_of_variables)
+			ErrorMayQuit( "Error: variable index out of range.", 0, 0 );
+		if (binary_value != 0 && binary_value != 1)
+			ErrorMayQuit( "Error: the value of an indicator must be 0 or 1.", 0, 0 );
+
+		equation = ELM_LIST(Equations, i+1);
+		if (! IS_SMALL_LIST(equation) || LEN_LIST(equation) > number_of_variables)
+			ErrorMayQuit( "Error: each equation must be a list with at most one entry for each variable.", 0, 0 );
+		for (j = 0; j < LEN_LIST(equation); j = j+1)
+			if (! GurobifyGetDouble(ELM_LIST(equation, j+1), &value))
+				ErrorMayQuit( "Error: equations must contain integer or double entries!", 0, 0 );
+
+		GurobifyGetSense(ELM_LIST(Senses, i+1));
+		if (! GurobifyGetDouble(ELM_LIST(RHSs, i+1), &rhs))
+			ErrorMayQuit( "Error: right hand sides must be integers or doubles.", 0, 0 );
+		if (LEN_LIST(Names) != 0)
+			GurobifyBatchName(Names, i+1);
 	}
-	else if ( strcmp(sense, "=") == 0 ){
-		error = GRBaddconstr(model, non_zero_constraints , constraint_index, constraint_value, GRB_EQUAL, rhs, CSTR_STRING(ConstraintName));
+
+	error = 0;
+	for (i = 0; i < number_of_constraints; i = i+1){
+		indicator = ELM_LIST(Indicators, i+1);
+		binary_variable = INT_INTOBJ(ELM_LIST(indicator, 1));
+		binary_value = INT_INTOBJ(ELM_LIST(indicator, 2));
+
+		equation = ELM_LIST(Equations, i+1);
+		non_zeros = 0;
+		for (j = 0; j < LEN_LIST(equation); j = j+1){
+			GurobifyGetDouble(ELM_LIST(equation, j+1), &value);
+			if (value != 0){
+				constraint_index[non_zeros] = j;
+				constraint_value[non_zeros] = value;
+				non_zeros = non_zeros + 1;
+			}
+		}
+
+		sense = GurobifyGetSense(ELM_LIST(Senses, i+1));
+		GurobifyGetDouble(ELM_LIST(RHSs, i+1), &rhs);
+
+		error = GUROBIFY_TIMED(GRBaddgenconstrIndicator(model, LEN_LIST(Names) == 0 ? NULL : GurobifyBatchName(Names, i+1),
+					binary_variable - 1, binary_value, non_zeros, constraint_index, constraint_value, sense, rhs));
 		if (error)
-			ErrorMayQuit( "Error: unable to add constraint ", 0, 0 );
+			break;
 	}
-	else
-			ErrorMayQuit( "Error:  sense must be <,> or = ", 0, 0 );
 
-	free(constraint_index);
-	free(constraint_value);
+	if (error)
+		ErrorMayQuit( "Error: unable to add indicator constraint.", 0, 0 );
 
-	return 0;
+	return True;
+}
+
+
+/*
+This function is not documented.
+
+	Adds a list of SOS constraints to a model in one call. Types is a list of 1s and 2s, Variables[i] is the
+	list of variables of the i-th constraint and Weights[i] a list of distinct weights of the same length,
+	which orders the variables for constraints of type 2.
+*/
+
+Obj GUROBIADDSOS(Obj self, Obj GAPmodel, Obj Types, Obj Variables, Obj Weights)
+{
+	GRBmodel *model;
+	Obj type, weights;
+	int number_of_constraints, number_of_variables, number_of_members, length;
+	int i, j, error;
+	int *types, *begin, *members, *indices;
+	double *weight;
+
+	if (! IS_MODEL(GAPmodel))
+		ErrorMayQuit( "Error: Must pass a valid Gurobi model", 0, 0 );
+
+	number_of_constraints = GurobifyBatchLength(Types, Variables, Weights);
+	model = GET_MODEL(GAPmodel);
+	error = GRBgetintattr(model, "NumVars", &number_of_variables);
+	if (error)
+		ErrorMayQuit( "Error: unable to add SOS constraints.", 0, 0 );
+
+	number_of_members = 0;
+	for (i = 0; i < number_of_constraints; i = i+1){
+		if (! IS_SMALL_LIST(ELM_LIST(Variables, i+1)))
+			ErrorMayQuit( "Error: variables must be given as a list of integers.", 0, 0 );
+		number_of_members = number_of_members + LEN_LIST(ELM_LIST(Variables, i+1));
+	}
+
+	types = (int*) GurobifyScratch((number_of_constraints+1)*sizeof(int));
+	begin = (int*) GurobifyScratch((number_of_constraints+1)*sizeof(int));
+	members = (int*) GurobifyScratch((number_of_members+1)*sizeof(int));
+	weight = (double*) GurobifyScratch((number_of_members+1)*sizeof(double));
+	GurobifyCountBytes(number_of_members*(sizeof(int) + sizeof(double)));
+
+	number_of_members = 0;
+	for (i = 0; i < number_of_constraints; i = i+1){
+		type = ELM_LIST(Types, i+1);
+		if (type != INTOBJ_INT(1) && type != INTOBJ_INT(2))
+			ErrorMayQuit( "Error: SOS types must be 1 or 2.", 0, 0 );
+		types[i] = (type == INTOBJ_INT(1)) ? GRB_SOS_TYPE1 : GRB_SOS_TYPE2;
+		begin[i] = number_of_members;
+
+		indices = GurobifyGetVariables(ELM_LIST(Variables, i+1), number_of_variables, &length);
+		weights = ELM_LIST(Weights, i+1);
+		if (! IS_SMALL_LIST(weights) || LEN_LIST(weights) != length)
+			ErrorMayQuit( "Error: each SOS constraint needs one weight for each variable.", 0, 0 );
+		for (j = 0; j < length; j = j+1){
+			members[number_of_members] = indices[j];
+			if (! GurobifyGetDouble(ELM_LIST(weights, j+1), &weight[number_of_members]))
+				ErrorMayQuit( "Error: weights must be integers or doubles.", 0, 0 );
+			number_of_members = number_of_members + 1;
+		}
+	}
+
+	error = GUROBIFY_TIMED(GRBaddsos(model, number_of_constraints, number_of_members, types, begin, members, weight));
+
+	if (error)
+		ErrorMayQuit( "Error: unable to add SOS constraints.", 0, 0 );
+
+	return True;
+}
+
+
+/*
+This function is not documented.
+
+	Adds a list of general constraints to a model. Types[i] is one of "and", "or", "max", "min" or "abs",
+	and the constraint sets the variable Resultants[i] to the corresponding function of the variables in
+	Operands[i]. For "abs" Operands[i] must contain exactly one variable. Constants[i] is an additional
+	constant operand for "max" and "min" and is ignored otherwise; fail means there is none.
+	Names is a list of strings, which may be empty.
+*/
+
+Obj GUROBIADDGENERALCONSTRAINTS(Obj self, Obj GAPmodel, Obj Types, Obj Resultants, Obj Operands, Obj Constants, Obj Names)
+{
+	GRBmodel *model;
+	Obj type, resultant, constant;
+	int number_of_constraints, number_of_variables, length;
+	int i, error;
+	int *operands;
+	double constant_value;
+	char *type_string, *name;
+
+	if (! IS_MODEL(GAPmodel))
+		ErrorMayQuit( "Error: Must pass a valid Gurobi model", 0, 0 );
+
+	number_of_constraints = GurobifyBatchLength(Types, Resultants, Operands);
+	if (! IS_SMALL_LIST(Constants) || LEN_LIST(Constants) != number_of_constraints)
+		ErrorMayQuit( "Error: all lists of constraint data must have the same length.", 0, 0 );
+	if (! IS_SMALL_LIST(Names))
+		ErrorMayQuit( "Error: Names must be a list of strings.", 0, 0 );
+
+	model = GET_MODEL(GAPmodel);
+	error = GRBgetintattr(model, "NumVars", &number_of_variables);
+	if (error)
+		ErrorMayQuit( "Error: unable to add general constraints.", 0, 0 );
+
+	// The whole batch is checked before the first constraint is added, so that an error leaves the model as it was.
+	for (i = 0; i < number_of_constraints; i = i+1){
+		type = ELM_LIST(Types, i+1);
+		if (! IS_STRING(type))
+			ErrorMayQuit( "Error: the type of a general constraint must be a string.", 0, 0 );
+		type_string = CSTR_STRING(type);
+
+		resultant = ELM_LIST(Resultants, i+1);
+		if (! IS_INTOBJ(resultant) || INT_INTOBJ(resultant) < 1 || INT_INTOBJ(resultant) > number_of_variables)
+			ErrorMayQuit( "Error: variable index out of range.", 0, 0 );
+
+		constant = ELM_LIST(Constants, i+1);
+		if (constant != Fail && ! GurobifyGetDouble(constant, &constant_value))
+			ErrorMayQuit( "Error: constants must be integers, doubles or fail.", 0, 0 );
+
+		if (LEN_LIST(Names) != 0)
+			GurobifyBatchName(Names, i+1);
+		GurobifyGetVariables(ELM_LIST(Operands, i+1), number_of_variables, &length);
+
+		if ( strcmp(type_string, "and") != 0 && strcmp(type_string, "or") != 0 && strcmp(type_string, "max") != 0
+				&& strcmp(type_string, "min") != 0 && ! (strcmp(type_string, "abs") == 0 && length == 1) )
+			ErrorMayQuit( "Error: the type must be \"and\", \"or\", \"max\", \"min\" or \"abs\", and \"abs\" takes exactly one operand.", 0, 0 );
+	}
+
+	for (i = 0; i < number_of_constraints; i = i+1){
+		type_string = CSTR_STRING(ELM_LIST(Types, i+1));
+		resultant = ELM_LIST(Resultants, i+1);
+
+		constant = ELM_LIST(Constants, i+1);
+		if (constant == Fail)
+			constant_value = strcmp(type_string, "max") == 0 ? -GRB_INFINITY : GRB_INFINITY;
+		else
+			GurobifyGetDouble(constant, &constant_value);
+
+		name = LEN_LIST(Names) == 0 ? NULL : GurobifyBatchName(Names, i+1);
+		operands = GurobifyGetVariables(ELM_LIST(Operands, i+1), number_of_variables, &length);
+
+		if ( strcmp(type_string, "and") == 0 )
+			error = GUROBIFY_TIMED(GRBaddgenconstrAnd(model, name, INT_INTOBJ(resultant) - 1, length, operands));
+		else if ( strcmp(type_string, "or") == 0 )
+			error = GUROBIFY_TIMED(GRBaddgenconstrOr(model, name, INT_INTOBJ(resultant) - 1, length, operands));
+		else if ( strcmp(type_string, "max") == 0 )
+			error = GUROBIFY_TIMED(GRBaddgenconstrMax(model, name, INT_INTOBJ(resultant) - 1, length, operands, constant_value));
+		else if ( strcmp(type_string, "min") == 0 )
+			error = GUROBIFY_TIMED(GRBaddgenconstrMin(model, name, INT_INTOBJ(resultant) - 1, length, operands, constant_value));
+		else
+			error = GUROBIFY_TIMED(GRBaddgenconstrAbs(model, name, INT_INTOBJ(resultant) - 1, operands[0]));
+		if (error)
+			ErrorMayQuit( "Error: unable to add general constraint.", 0, 0 );
+	}
+
+	return True;
 }
 
 /*
@@ -559,13 +2689,14 @@ Obj GurobiDeleteSingleConstraintWithName(Obj self, Obj GAPmodel, Obj ConstraintN
 		ErrorMayQuit( "Error: Unable to delete constraint.", 0, 0 );
 
 	// while ( ConstraintNumber != -1 ){
+	GurobifyDropMatrix(GAPmodel);
 	if (ConstraintNumber != -1)
-	 	error = GRBdelconstrs(model, 1, &ConstraintNumber);
+	 	error = GUROBIFY_TIMED(GRBdelconstrs(model, 1, &ConstraintNumber));
 
 	 if ( error )
 	 	ErrorMayQuit( "Error: Unable to delete constraint.", 0, 0 );
 			
-	error = GRBupdatemodel(model);
+	error = GUROBIFY_TIMED(GRBupdatemodel(model));
  	if (error)
  		ErrorMayQuit( "Error: Unable to update model.", 0, 0 );	
 
@@ -602,7 +2733,7 @@ Obj GurobiDeleteConstraints(Obj self, Obj GAPmodel, Obj ConstraintList)
 
 	int length;
 	length = LEN_PLIST(ConstraintList);
-	int constr_index[length];
+	int *constr_index = (int*) GurobifyScratch((length+1)*sizeof(int));
 	int i;
 
 	for (i = 0; i < length; i = i+1 ){
@@ -616,7 +2747,8 @@ Obj GurobiDeleteConstraints(Obj self, Obj GAPmodel, Obj ConstraintList)
 
 
     int error;
-    error = GRBdelconstrs(model, length, constr_index);
+    GurobifyDropMatrix(GAPmodel);
+    error = GUROBIFY_TIMED(GRBdelconstrs(model, length, constr_index));
 	if ( error )
 		ErrorMayQuit( "Error: Unable to delete constraint.", 0, 0 );
 
@@ -714,7 +2846,7 @@ Obj GurobiIntegerAttribute( Obj self, Obj GAPmodel, Obj AttributeName )
 	if (! IS_MODEL(GAPmodel))
         ErrorMayQuit( "Error: Must pass a valid Gurobi model", 0, 0 );
 
-	GRBmodel *model = GET_MODEL(GAPmodel);
+	GRBmodel *model = GET_MODEL_READ(GAPmodel);
 	int error;
 	int current_int_value;
 
@@ -751,7 +2883,7 @@ Obj GurobiStringAttributeElement( Obj self, Obj GAPmodel, Obj position, Obj Attr
     if (! IS_INTOBJ(position) )
         ErrorMayQuit( "Error: Must pass an integer as the position", 0, 0 );
 
-	GRBmodel *model = GET_MODEL(GAPmodel);
+	GRBmodel *model = GET_MODEL_READ(GAPmodel);
 	int error;
 	int i;
 	i = INT_INTOBJ(position);
@@ -788,7 +2920,7 @@ Obj GurobiDoubleAttribute( Obj self, Obj GAPmodel, Obj AttributeName )
 	if (! IS_MODEL(GAPmodel))
         ErrorMayQuit( "Error: Must pass a valid Gurobi model", 0, 0 );
 
-	GRBmodel *model = GET_MODEL(GAPmodel);
+	GRBmodel *model = GET_MODEL_READ(GAPmodel);
 	int error;
 	double current_double_value;
 
@@ -823,7 +2955,7 @@ Obj GurobiIntegerAttributeArray( Obj self, Obj GAPmodel, Obj AttributeName)
 	if (! IS_MODEL(GAPmodel))
         ErrorMayQuit( "Error: Must pass a valid Gurobi model", 0, 0 );
 
-	GRBmodel *model = GET_MODEL(GAPmodel);
+	GRBmodel *model = GET_MODEL_READ(GAPmodel);
 
 	int i;
 	int error;
@@ -832,20 +2964,20 @@ Obj GurobiIntegerAttributeArray( Obj self, Obj GAPmodel, Obj AttributeName)
     	if (error)
 	        ErrorMayQuit( "Error: unable to obtain number of variables", 0, 0 );
 
-	int* sol = (int*) malloc(number_of_variables*sizeof(int));
+	int* sol = (int*) GurobifyScratch(number_of_variables*sizeof(int));
 
 	if (! IS_STRING(AttributeName))
 	    ErrorMayQuit( "Error: AttributeName must be a string.", 0, 0 );
 
-	error = GRBgetintattrarray(model, CSTR_STRING(AttributeName), 0, number_of_variables, sol);		//TODO: check for errors
+	error = GUROBIFY_TIMED(GRBgetintattrarray(model, CSTR_STRING(AttributeName), 0, number_of_variables, sol));		//TODO: check for errors
 	    if (error)
 			ErrorMayQuit( "Error: Unable to get attribute array. Check attribute type and name.", 0, 0 );
 	
+	GurobifyCountBytes(number_of_variables*sizeof(int));
 	Obj solution = NEW_PLIST( T_PLIST , number_of_variables);
 	for (i = 0; i < number_of_variables; i = i+1 ){
 				ASS_LIST(solution, i+1, INTOBJ_INT(sol[i]));
 	}
-	free(sol);
 	return solution;
 }
 
@@ -868,7 +3000,7 @@ Obj GurobiDoubleAttributeArray( Obj self, Obj GAPmodel, Obj AttributeName)
 	if (! IS_MODEL(GAPmodel))
         ErrorMayQuit( "Error: Must pass a valid Gurobi model", 0, 0 );
 
-	GRBmodel *model = GET_MODEL(GAPmodel);
+	GRBmodel *model = GET_MODEL_READ(GAPmodel);
 
 	int i;
 	int error;
@@ -877,21 +3009,20 @@ Obj GurobiDoubleAttributeArray( Obj self, Obj GAPmodel, Obj AttributeName)
     	if (error)
 	        ErrorMayQuit( "Error: unable to obtain number of variables", 0, 0 );
 
-/*	double sol[number_of_variables]; */
-	double* sol = (double*) malloc(number_of_variables*sizeof(double));
+	double* sol = (double*) GurobifyScratch(number_of_variables*sizeof(double));
 
 	if (! IS_STRING(AttributeName))
         ErrorMayQuit( "Error: AttributeName must be a string.", 0, 0 );
 
-	error = GRBgetdblattrarray(model, CSTR_STRING(AttributeName), 0, number_of_variables, sol);		//TODO: check for errors
+	error = GUROBIFY_TIMED(GRBgetdblattrarray(model, CSTR_STRING(AttributeName), 0, number_of_variables, sol));		//TODO: check for errors
 	    if (error)
 			ErrorMayQuit( "Error: Unable to get attribute array. Check attribute type and name.", 0, 0 );
 	
+	GurobifyCountBytes(number_of_variables*sizeof(double));
 	Obj solution = NEW_PLIST( T_PLIST , number_of_variables);
 	for (i = 0; i < number_of_variables; i = i+1 ){
 				ASS_LIST(solution, i+1, NEW_MACFLOAT(sol[i]));
 	}
-	free(sol);
 	return solution;
 }
 
@@ -913,7 +3044,7 @@ Obj GurobiStringAttributeArray( Obj self, Obj GAPmodel, Obj AttributeName)
 	if (! IS_MODEL(GAPmodel))
         ErrorMayQuit( "Error: Must pass a valid Gurobi model", 0, 0 );
 
-	GRBmodel *model = GET_MODEL(GAPmodel);
+	GRBmodel *model = GET_MODEL_READ(GAPmodel);
 
 	int i;
 	int error;
@@ -922,12 +3053,12 @@ Obj GurobiStringAttributeArray( Obj self, Obj GAPmodel, Obj AttributeName)
     	if (error)
 	        ErrorMayQuit( "Error: unable to obtain number of variables", 0, 0 );
 
-	char * attrvals[number_of_variables];
+	char **attrvals = (char**) GurobifyScratch((number_of_variables+1)*sizeof(char*));
 	
 	if (! IS_STRING(AttributeName))
         ErrorMayQuit( "Error: AttributeName must be a string.", 0, 0 );
 
-	error = GRBgetstrattrarray(model, CSTR_STRING(AttributeName), 0, number_of_variables, attrvals );
+	error = GUROBIFY_TIMED(GRBgetstrattrarray(model, CSTR_STRING(AttributeName), 0, number_of_variables, attrvals ));
     if (error)
 		ErrorMayQuit( "Error: Unable to get attribute array. Check attribute type and name.", 0, 0 );
 
@@ -936,6 +3067,7 @@ Obj GurobiStringAttributeArray( Obj self, Obj GAPmodel, Obj AttributeName)
 	for (i = 0; i < number_of_variables; i = i+1 ){
 		Obj name;
         name = MakeString(attrvals[i]);
+		GurobifyCountBytes(strlen(attrvals[i]));
 		ASS_LIST(solution, i+1, name);
 	}
 	return solution;
@@ -969,7 +3101,7 @@ Obj GurobiSetDoubleAttributeArray(Obj self, Obj GAPmodel, Obj AttributeName, Obj
 	int error;
 	int length;
 	length = LEN_PLIST(GAParray);
-	double* vals = (double*) malloc(length*sizeof(double));
+	double* vals = (double*) GurobifyScratch(length*sizeof(double));
 	int i;
 	for (i = 0; i < length; i = i+1 ){
 		if (! IS_MACFLOAT(ELM_PLIST(GAParray, i+1))){
@@ -983,69 +3115,384 @@ Obj GurobiSetDoubleAttributeArray(Obj self, Obj GAPmodel, Obj AttributeName, Obj
 	if (! IS_STRING(AttributeName))
         ErrorMayQuit( "Error: AttributeName must be a string.", 0, 0 );
 
-	error = GRBsetdblattrarray(model, CSTR_STRING(AttributeName), 0, length, vals);
+	GurobifyCountBytes(length*sizeof(double));
+	if (strcmp(CSTR_STRING(AttributeName), "RHS") == 0)
+		GurobifyDropMatrix(GAPmodel);
+	error = GUROBIFY_TIMED(GRBsetdblattrarray(model, CSTR_STRING(AttributeName), 0, length, vals));
 	if (error)
     	ErrorMayQuit( "Error: Unable to set attribute array.", 0, 0 );
-	free(vals);
 	
 	return 0;
 }
 
 
-
 /*
-	#! @Chapter Using Gurobify
-	#! @Section Querying Other Attributes And Parameters
-	#! @Arguments Model, AttributeName
-	#! @Returns attribute array
-	#! @Description
-	#! @Description
-	#!	Takes a Gurobi model and retrieves an attribute array.
-	#!	Can only get values of attributes arrays which have char values.
-	#!	Refer to the Gurobi documentation for a list of attributes and their types.
-		DeclareGlobalFunction("GurobiCharAttributeArray");
+This function is not documented.
+
+	Replaces the objectives of a model by the given ones, which are lists of coefficients of all variables,
+	with their priorities, weights and absolute and relative tolerances. The first objective becomes the
+	objective of the model itself (the Obj attribute).
 */
-Obj GurobiCharAttributeArray( Obj self, Obj GAPmodel, Obj AttributeName)
+
+Obj GUROBISETOBJECTIVES(Obj self, Obj GAPmodel, Obj Objectives, Obj Priorities, Obj Weights, Obj AbsTols, Obj RelTols)
 {
+	int i, j;
+	int error;
+	int number_of_variables, number_of_objectives, length;
+	double weight, abstol, reltol;
 
 	if (! IS_MODEL(GAPmodel))
         ErrorMayQuit( "Error: Must pass a valid Gurobi model", 0, 0 );
+	if (! IS_SMALL_LIST(Objectives) || LEN_LIST(Objectives) == 0)
+        ErrorMayQuit( "Error: Objectives must be a non-empty list.", 0, 0 );
+	number_of_objectives = LEN_LIST(Objectives);
+	if (! IS_SMALL_LIST(Priorities) || LEN_LIST(Priorities) != number_of_objectives
+			|| ! IS_SMALL_LIST(Weights) || LEN_LIST(Weights) != number_of_objectives
+			|| ! IS_SMALL_LIST(AbsTols) || LEN_LIST(AbsTols) != number_of_objectives
+			|| ! IS_SMALL_LIST(RelTols) || LEN_LIST(RelTols) != number_of_objectives)
+        ErrorMayQuit( "Error: There must be a priority, weight and tolerances for each objective.", 0, 0 );
 
 	GRBmodel *model = GET_MODEL(GAPmodel);
+	error = GUROBIFY_TIMED(GRBupdatemodel(model));
+	if (! error)
+		error = GRBgetintattr(model, "NumVars", &number_of_variables);
+	if (error)
+        ErrorMayQuit( "Error: Unable to update model.", 0, 0 );
+
+	int *indices = (int*) GurobifyScratch((number_of_variables+1)*sizeof(int));
+	double *values = (double*) GurobifyScratch((number_of_variables+1)*sizeof(double));
+
+	// All objectives are checked before the number of objectives is changed, so that an error leaves the model as it was.
+	for (i = 0; i < number_of_objectives; i = i+1){
+		Obj objective = ELM_LIST(Objectives, i+1);
+		if (! IS_SMALL_LIST(objective) || LEN_LIST(objective) != number_of_variables)
+	        ErrorMayQuit( "Error: Each objective must have a coefficient for every variable.", 0, 0 );
+		if (! IS_INTOBJ(ELM_LIST(Priorities, i+1)))
+	        ErrorMayQuit( "Error: The priorities must be integers.", 0, 0 );
+		if (! GurobifyGetDouble(ELM_LIST(Weights, i+1), &weight)
+				|| ! GurobifyGetDouble(ELM_LIST(AbsTols, i+1), &abstol)
+				|| ! GurobifyGetDouble(ELM_LIST(RelTols, i+1), &reltol))
+	        ErrorMayQuit( "Error: The weights and tolerances must be numbers.", 0, 0 );
+		for (j = 0; j < number_of_variables; j = j+1)
+			if (! GurobifyGetDouble(ELM_LIST(objective, j+1), &values[0]))
+		        ErrorMayQuit( "Error: The coefficients of an objective must be numbers.", 0, 0 );
+	}
+
+	error = GUROBIFY_TIMED(GRBsetintattr(model, "NumObj", number_of_objectives));
+	if (error)
+        ErrorMayQuit( "Error: Unable to set the number of objectives.", 0, 0 );
+
+	for (i = 0; i < number_of_objectives; i = i+1){
+		Obj objective = ELM_LIST(Objectives, i+1);
+		GurobifyGetDouble(ELM_LIST(Weights, i+1), &weight);
+		GurobifyGetDouble(ELM_LIST(AbsTols, i+1), &abstol);
+		GurobifyGetDouble(ELM_LIST(RelTols, i+1), &reltol);
+
+		length = 0;
+		for (j = 0; j < number_of_variables; j = j+1){
+			GurobifyGetDouble(ELM_LIST(objective, j+1), &values[length]);
+			if (values[length] != 0.0){
+				indices[length] = j;
+				length = length + 1;
+			}
+		}
+		GurobifyCountBytes(length*(sizeof(int) + sizeof(double)));
+		error = GUROBIFY_TIMED(GRBsetobjectiven(model, i, INT_INTOBJ(ELM_LIST(Priorities, i+1)), weight, abstol, reltol,
+					NULL, 0.0, length, indices, values));
+		if (error)
+	        ErrorMayQuit( "Error: Unable to set objective.", 0, 0 );
+	}
+
+	return True;
+}
+
+/*
+	#! @Chapter Using Gurobify
+	#! @Section Adding And Modifying Objective Functions
+	#! @Arguments Model
+	#! @Returns List of floats
+	#! @Description
+	#!	Returns the values of all objectives of a model with several objectives (see GurobiSetObjectiveFunctions)
+	#!	at the solution found by the last optimisation, in the order of the objectives.
+	DeclareGlobalFunction("GurobiObjectiveValues");
+*/
 
+Obj GurobiObjectiveValues(Obj self, Obj GAPmodel)
+{
 	int i;
 	int error;
-	int number_of_variables;
-    error = GRBgetintattr(model, "NumVars", &number_of_variables);
-    	if (error)
-	        ErrorMayQuit( "Error: unable to obtain number of variables", 0, 0 );
-
-	char* attrvals = (char*) malloc(number_of_variables*sizeof(char));
-	
-	if (! IS_STRING(AttributeName))
-        ErrorMayQuit( "Error: AttributeName must be a string.", 0, 0 );
+	int number_of_objectives, objective_number;
+	double value;
 
-	error = GRBgetcharattrarray(model, CSTR_STRING(AttributeName), 0, number_of_variables, attrvals );
-    if (error)
-		ErrorMayQuit( "Error: Unable to get attribute array. Check attribute type and name.", 0, 0 );
+	if (! IS_MODEL(GAPmodel))
+        ErrorMayQuit( "Error: Must pass a valid Gurobi model", 0, 0 );
 
-	Obj solution = NEW_PLIST( T_PLIST , number_of_variables);
+	GRBmodel *model = GET_MODEL_READ(GAPmodel);
+	GRBenv *modelenv = GRBgetenv(model);
 
-	for (i = 0; i < number_of_variables; i = i+1 ){
-		Obj name;
-		name = NEW_STRING(1);
-		SET_LEN_STRING(name,1);
-		COPY_CHARS(name,&attrvals[i],1);
-		ASS_LIST(solution, i+1, name);
+	error = GRBgetintattr(model, "NumObj", &number_of_objectives);
+	if (! error)
+		error = GRBgetintparam(modelenv, "ObjNumber", &objective_number);
+	if (error)
+        ErrorMayQuit( "Error: Unable to obtain the number of objectives.", 0, 0 );
+
+	// The objective whose value ObjNVal gives is chosen by the parameter ObjNumber, which is restored afterwards.
+	Obj values = NEW_PLIST(T_PLIST, number_of_objectives);
+	for (i = 0; i < number_of_objectives && ! error; i = i+1){
+		error = GRBsetintparam(modelenv, "ObjNumber", i);
+		if (! error)
+			error = GRBgetdblattr(model, "ObjNVal", &value);
+		if (! error)
+			ASS_LIST(values, i+1, NEW_MACFLOAT(value));
 	}
-	free(attrvals);
-	
-	return solution;
+	GRBsetintparam(modelenv, "ObjNumber", objective_number);
+	if (error)
+        ErrorMayQuit( "Error: Unable to obtain the objective values.", 0, 0 );
 
+	return values;
 }
 
 
-
+/*
+	Reads the current bounds of some variables, including the recorded changes of a lazy copy.
+	Pending changes of a model are processed first, so that the values read are up to date.
+*/
+
+static int GurobifyGetBounds(Obj GAPmodel, int length, int *indices, double *lb, double *ub)
+{
+	int error;
+	int i, j;
+	GRBmodel *model;
+
+	if (IS_LAZY_MODEL(GAPmodel)){
+		// The bounds are read without the changes of any other object sharing the model.
+		GurobifySharedModel *shared = GET_DATA(GAPmodel)->shared;
+		if (shared->applied != GET_DATA(GAPmodel)){
+			error = GurobifyRevertShared(shared);
+			if (error)
+				return error;
+		}
+		model = shared->model;
+	}
+	else{
+		model = GET_MODEL(GAPmodel);
+		error = GUROBIFY_TIMED(GRBupdatemodel(model));
+		if (error)
+			return error;
+	}
+
+	error = GUROBIFY_TIMED(GRBgetdblattrlist(model, "LB", length, indices, lb));
+	if (! error)
+		error = GUROBIFY_TIMED(GRBgetdblattrlist(model, "UB", length, indices, ub));
+
+	if (! error && IS_LAZY_MODEL(GAPmodel)){
+		GurobifyModelData *data = GET_DATA(GAPmodel);
+		for (j = 0; j < data->number_of_bound_changes; j = j+1){
+			for (i = 0; i < length; i = i+1){
+				if (indices[i] == data->bound_indices[j]){
+					lb[i] = data->bound_lb[j];
+					ub[i] = data->bound_ub[j];
+				}
+			}
+		}
+	}
+	return error;
+}
+
+/* Changes the bounds of some variables, or records the changes in the case of a lazy copy */
+static int GurobifySetBounds(Obj GAPmodel, int length, int *indices, double *lb, double *ub)
+{
+	int error = 0;
+	int i;
+
+	if (IS_LAZY_MODEL(GAPmodel)){
+		GurobifyModelData *data = GET_DATA(GAPmodel);
+		for (i = 0; i < length && ! error; i = i+1)
+			error = GurobifyRecordBoundChange(data, indices[i], lb[i], ub[i]);
+		return error;
+	}
+
+	GRBmodel *model = GET_MODEL(GAPmodel);
+	error = GUROBIFY_TIMED(GRBsetdblattrlist(model, "LB", length, indices, lb));
+	if (! error)
+		error = GUROBIFY_TIMED(GRBsetdblattrlist(model, "UB", length, indices, ub));
+	return error;
+}
+
+/* Pushes a new frame of saved bounds on to the stack of a model */
+static int GurobifySaveBounds(GurobifyModelData *data, int length, int *indices, double *lb, double *ub)
+{
+	int i;
+
+	if (data->number_of_frames == data->frame_capacity){
+		int capacity = 2*data->frame_capacity + 8;
+		int *begin = (int*) realloc(data->frame_begin, capacity*sizeof(int));
+		if (begin == NULL)
+			return 1;
+		data->frame_begin = begin;
+		data->frame_capacity = capacity;
+	}
+	if (data->number_of_saved_bounds + length > data->saved_capacity){
+		int capacity = 2*data->saved_capacity + length + 8;
+		int *saved_indices = (int*) realloc(data->saved_indices, capacity*sizeof(int));
+		if (saved_indices == NULL)
+			return 1;
+		data->saved_indices = saved_indices;
+		double *saved_lb = (double*) realloc(data->saved_lb, capacity*sizeof(double));
+		if (saved_lb == NULL)
+			return 1;
+		data->saved_lb = saved_lb;
+		double *saved_ub = (double*) realloc(data->saved_ub, capacity*sizeof(double));
+		if (saved_ub == NULL)
+			return 1;
+		data->saved_ub = saved_ub;
+		data->saved_capacity = capacity;
+	}
+
+	data->frame_begin[data->number_of_frames] = data->number_of_saved_bounds;
+	data->number_of_frames = data->number_of_frames + 1;
+	for (i = 0; i < length; i = i+1){
+		data->saved_indices[data->number_of_saved_bounds + i] = indices[i];
+		data->saved_lb[data->number_of_saved_bounds + i] = lb[i];
+		data->saved_ub[data->number_of_saved_bounds + i] = ub[i];
+	}
+	data->number_of_saved_bounds = data->number_of_saved_bounds + length;
+	return 0;
+}
+
+/*
+This function is not documented.
+
+	Sets the lower and upper bounds of the variables in IndexSet, which are indexed from 1. LB and UB are
+	either lists of the same length as IndexSet, or single values which are used for every variable.
+	If Save is true then the previous bounds are saved, so that they can be restored with GurobiUndoVariableBounds.
+*/
+
+Obj GUROBISETVARIABLEBOUNDS(Obj self, Obj GAPmodel, Obj IndexSet, Obj LB, Obj UB, Obj Save)
+{
+
+	if (! IS_MODEL(GAPmodel))
+        ErrorMayQuit( "Error: Must pass a valid Gurobi model", 0, 0 );
+
+	int error;
+	int number_of_variables;
+	if (IS_LAZY_MODEL(GAPmodel))
+		error = GRBgetintattr(GET_DATA(GAPmodel)->shared->model, "NumVars", &number_of_variables);
+	else
+		error = GRBgetintattr(GET_MODEL(GAPmodel), "NumVars", &number_of_variables);
+	if (error)
+		ErrorMayQuit( "Error: unable to obtain number of variables", 0, 0 );
+
+	GurobifySparseVector lb, ub;
+	GurobifyReadSparseVector(IndexSet, LB, 1, number_of_variables, &lb);
+	GurobifyReadSparseVector(IndexSet, UB, 1, number_of_variables, &ub);
+
+	if (Save == True){
+		double *old_lb = (double*) GurobifyScratch((lb.length+1)*sizeof(double));
+		double *old_ub = (double*) GurobifyScratch((lb.length+1)*sizeof(double));
+		error = GurobifyGetBounds(GAPmodel, lb.length, lb.indices, old_lb, old_ub);
+		if (! error)
+			error = GurobifySaveBounds(GET_OR_NEW_DATA(GAPmodel), lb.length, lb.indices, old_lb, old_ub);
+		if (error)
+			ErrorMayQuit( "Error: Unable to save variable bounds.", 0, 0 );
+	}
+
+	error = GurobifySetBounds(GAPmodel, lb.length, lb.indices, lb.values, ub.values);
+	if (error)
+		ErrorMayQuit( "Error: Unable to set variable bounds.", 0, 0 );
+
+	return True;
+}
+
+/*
+	#! @Chapter Using Gurobify
+	#! @Section Modifying Other Attributes And Parameters
+	#! @Arguments Model
+	#! @Returns true/false
+	#! @Description
+	#!	Restores the bounds of the variables changed by the most recent call to GurobiSetVariableBounds or
+	#!	GurobiFixVariables which has not already been undone. Returns false if there is nothing to undo.
+	#!	As with other changes, the model must be updated or optimised for the restored bounds to take effect.
+	DeclareGlobalFunction("GurobiUndoVariableBounds");
+*/
+
+Obj GurobiUndoVariableBounds(Obj self, Obj GAPmodel)
+{
+
+	if (! IS_MODEL(GAPmodel))
+        ErrorMayQuit( "Error: Must pass a valid Gurobi model", 0, 0 );
+
+	GurobifyModelData *data = GET_DATA(GAPmodel);
+	if (data == NULL || data->number_of_frames == 0)
+		return False;
+
+	int begin = data->frame_begin[data->number_of_frames - 1];
+	int error = GurobifySetBounds(GAPmodel, data->number_of_saved_bounds - begin, data->saved_indices + begin,
+					data->saved_lb + begin, data->saved_ub + begin);
+	if (error)
+		ErrorMayQuit( "Error: Unable to restore variable bounds.", 0, 0 );
+
+	data->number_of_frames = data->number_of_frames - 1;
+	data->number_of_saved_bounds = begin;
+
+	return True;
+}
+
+
+
+/*
+	#! @Chapter Using Gurobify
+	#! @Section Querying Other Attributes And Parameters
+	#! @Arguments Model, AttributeName
+	#! @Returns attribute array
+	#! @Description
+	#! @Description
+	#!	Takes a Gurobi model and retrieves an attribute array.
+	#!	Can only get values of attributes arrays which have char values.
+	#!	Refer to the Gurobi documentation for a list of attributes and their types.
+		DeclareGlobalFunction("GurobiCharAttributeArray");
+*/
+Obj GurobiCharAttributeArray( Obj self, Obj GAPmodel, Obj AttributeName)
+{
+
+	if (! IS_MODEL(GAPmodel))
+        ErrorMayQuit( "Error: Must pass a valid Gurobi model", 0, 0 );
+
+	GRBmodel *model = GET_MODEL_READ(GAPmodel);
+
+	int i;
+	int error;
+	int number_of_variables;
+    error = GRBgetintattr(model, "NumVars", &number_of_variables);
+    	if (error)
+	        ErrorMayQuit( "Error: unable to obtain number of variables", 0, 0 );
+
+	char* attrvals = (char*) GurobifyScratch(number_of_variables*sizeof(char));
+	
+	if (! IS_STRING(AttributeName))
+        ErrorMayQuit( "Error: AttributeName must be a string.", 0, 0 );
+
+	error = GUROBIFY_TIMED(GRBgetcharattrarray(model, CSTR_STRING(AttributeName), 0, number_of_variables, attrvals ));
+    if (error)
+		ErrorMayQuit( "Error: Unable to get attribute array. Check attribute type and name.", 0, 0 );
+
+	GurobifyCountBytes(number_of_variables*sizeof(char));
+	Obj solution = NEW_PLIST( T_PLIST , number_of_variables);
+
+	for (i = 0; i < number_of_variables; i = i+1 ){
+		Obj name;
+		name = NEW_STRING(1);
+		SET_LEN_STRING(name,1);
+		COPY_CHARS(name,&attrvals[i],1);
+		ASS_LIST(solution, i+1, name);
+	}
+	
+	return solution;
+
+}
+
+
+
 /*
 	#! @Chapter Using Gurobify
 	#! @Section Creating Or Reading A Model
@@ -1077,7 +3524,7 @@ Obj GurobiWriteToFile(Obj self, Obj GAPmodel, Obj FileName)
 	if (error)
 		ErrorMayQuit( "Error: Unable to set model name.", 0, 0 );
 
-	error = GRBwrite(model, file_name);
+	error = GUROBIFY_TIMED(GRBwrite(model, file_name));
 	if (error)
 		ErrorMayQuit( "Error: Unable to write model.", 0, 0 );
 
@@ -1101,97 +3548,2940 @@ Obj GurobiUpdateModel(Obj self, Obj GAPmodel){
 	if (! IS_MODEL(GAPmodel))
         ErrorMayQuit( "Error: Must pass a valid Gurobi model", 0, 0 );
 
+	// The changes of a lazy copy are applied when it is next used.
+	if (IS_LAZY_MODEL(GAPmodel))
+		return True;
+
 	GRBmodel *model = GET_MODEL(GAPmodel);
-	int error = GRBupdatemodel(model);
+	int error = GUROBIFY_TIMED(GRBupdatemodel(model));
 	if (error)
 		ErrorMayQuit( "Error: Unable to update model.", 0, 0 );
+	GurobifyMatrixUpdated(GAPmodel);
 
 	return True;
 }
 
 
 /*
-	#! @Chapter Using Gurobify
-	#! @Section Other
-	#! @Arguments 
-	#! @Returns [ major_version, minor_version, technical_version ]
-	#! @Description
-	#!	This function returns a list [ major_version, minor_version, technical_version ] which
-	#!	indicates the Gurobi library version. For example, if using Gurobi Version 7.5.1, then
-	#!	GurobiVersion() would return [ 7, 5, 1 ].
-	DeclareGlobalFunction("GurobiVersion");
+	Gurobi only supports optimising models concurrently in different threads if they belong to different
+	environments. GurobifyThreadEnv loads a new environment with the parameters of an existing one, except that
+	it uses a single thread, so that several models optimised side by side do not each use every core.
+	GurobifyThreadModel copies a model into such an environment of its own, which is returned in envP and freed
+	with the copy by GurobifyFreeThreadModel. Both return NULL on failure. They do not touch any GAP objects.
 */
 
-Obj GurobiVersion(Obj self){
-	int major, minor, technical;
-	GRBversion(&major, &minor, &technical);
-	Obj version = NEW_PLIST( T_PLIST , 3);
-	ASS_LIST( version, 1 , INTOBJ_INT(major));
-	ASS_LIST( version , 2, INTOBJ_INT(minor));
-	ASS_LIST( version, 3, INTOBJ_INT(technical));
+static GRBenv *GurobifyThreadEnv(GRBenv *env)
+{
+	GRBenv *thread_env = NULL;
+	int error;
 
-	return version;
+	error = GRBloadenv(&thread_env, NULL);
+	if (! error)
+		error = GRBcopyparams(thread_env, env);
+	if (! error)
+		error = GRBsetintparam(thread_env, "Threads", 1);
+	if (error && thread_env != NULL){
+		GRBfreeenv(thread_env);
+		thread_env = NULL;
+	}
+	return thread_env;
 }
 
-typedef Obj (* GVarFunc)(/*arguments*/);
+static void GurobifyFreeThreadModel(GRBmodel *model, GRBenv *thread_env)
+{
+	if (model != NULL)
+		GRBfreemodel(model);
+	if (thread_env != NULL)
+		GRBfreeenv(thread_env);
+}
 
-#define GVAR_FUNC_TABLE_ENTRY(srcfile, name, nparam, params) \
-  {#name, nparam, \
-   params, \
-   (GVarFunc)name, \
-   srcfile ":Func" #name }
+static GRBmodel *GurobifyThreadModel(GRBmodel *model, GRBenv **envP)
+{
+	GRBmodel *copy = NULL;
+
+	*envP = GurobifyThreadEnv(GRBgetenv(model));
+	if (*envP != NULL)
+		copy = GRBcopymodeltoenv(model, *envP);
+	// The copy takes the parameters of the environment it is created in.
+	if (copy == NULL){
+		GurobifyFreeThreadModel(NULL, *envP);
+		*envP = NULL;
+	}
+	return copy;
+}
 
-// Table of functions to export
-static StructGVarFunc GVarFuncs [] = {
-    GVAR_FUNC_TABLE_ENTRY("Gurobify.c", GurobiReadModel, 1, "ModelFile"),
-    GVAR_FUNC_TABLE_ENTRY("Gurobify.c", GUROBINEWMODEL, 1, "VariableTypes"),
-    GVAR_FUNC_TABLE_ENTRY("Gurobify.c", GUROBISETVARIABLENAMES, 2, "model, VariableNames"),
-    GVAR_FUNC_TABLE_ENTRY("Gurobify.c", GurobiOptimiseModel, 1, "model"),
-    GVAR_FUNC_TABLE_ENTRY("Gurobify.c", GurobiReset, 1, "model"),
-    GVAR_FUNC_TABLE_ENTRY("Gurobify.c", GurobiSetIntegerParameter, 3, "model, ParameterName, ParameterValue"),
-    GVAR_FUNC_TABLE_ENTRY("Gurobify.c", GurobiSetDoubleParameter, 3, "model, ParameterName, ParameterValue"),
-    GVAR_FUNC_TABLE_ENTRY("Gurobify.c", GurobiIntegerParameter, 2, "model, ParameterName"),
-    GVAR_FUNC_TABLE_ENTRY("Gurobify.c", GurobiDoubleParameter, 2, "model, ParameterName"),
-    GVAR_FUNC_TABLE_ENTRY("Gurobify.c", GUROBIADDCONSTRAINT, 5, "model, ConstraintEquation, ConstraintSense, ConstraintRHS, ConstraintName"),
-    GVAR_FUNC_TABLE_ENTRY("Gurobify.c", GurobiDeleteSingleConstraintWithName, 2, "model, ConstraintName"),
-    GVAR_FUNC_TABLE_ENTRY("Gurobify.c", GurobiSetIntegerAttribute, 3, "model, AttributeName, AttributeValue"),
-    GVAR_FUNC_TABLE_ENTRY("Gurobify.c", GurobiSetDoubleAttribute, 3, "model, AttributeName, AttributeValue"),
-    GVAR_FUNC_TABLE_ENTRY("Gurobify.c", GurobiIntegerAttribute, 2, "model, AttributeName"),
-    GVAR_FUNC_TABLE_ENTRY("Gurobify.c", GurobiDoubleAttribute, 2, "model, AttributeName"),
-    GVAR_FUNC_TABLE_ENTRY("Gurobify.c", GurobiIntegerAttributeArray, 2, "model, AttributeName"),
-    GVAR_FUNC_TABLE_ENTRY("Gurobify.c", GurobiDoubleAttributeArray, 2, "model, AttributeName"),
-    GVAR_FUNC_TABLE_ENTRY("Gurobify.c", GurobiStringAttributeArray, 2, "model, AttributeName"),
-    GVAR_FUNC_TABLE_ENTRY("Gurobify.c", GurobiCharAttributeArray, 2, "model, AttributeName"),
-    GVAR_FUNC_TABLE_ENTRY("Gurobify.c", GurobiWriteToFile, 2, "model, FileName"),
-    GVAR_FUNC_TABLE_ENTRY("Gurobify.c", GurobiUpdateModel, 1, "model"),
-    GVAR_FUNC_TABLE_ENTRY("Gurobify.c", GurobiSetDoubleAttributeArray, 3, "model, AttributeName, AttributeArray"),
-    GVAR_FUNC_TABLE_ENTRY("Gurobify.c", GurobiStringAttributeElement, 3, "model, position, AttributeName"),
-    GVAR_FUNC_TABLE_ENTRY("Gurobify.c", GurobiDeleteConstraints, 2, "model, ConstraintList"),
-    GVAR_FUNC_TABLE_ENTRY("Gurobify.c", GurobiVersion, 0, ""),
+/*
+	The modifications which make up a single scenario of GUROBISOLVESCENARIOS, one sparse vector
+	for each of the attributes in gurobify_scenario_attributes.
+*/
 
-  { 0 } /* Finish with an empty entry */
+#define GUROBIFY_SCENARIO_ATTRIBUTES 4
 
-};
+static const char *gurobify_scenario_attributes[GUROBIFY_SCENARIO_ATTRIBUTES] = { "Obj", "LB", "UB", "RHS" };
 
-/******************************************************************************
-*F  InitKernel( <module> )  . . . . . . . . initialise kernel data structures
+typedef struct {
+	GurobifySparseVector changes[GUROBIFY_SCENARIO_ATTRIBUTES];
+} GurobifyScenario;
+
+typedef struct {
+	GurobifyScenario *scenarios;
+	int number_of_scenarios;
+	int number_of_variables;
+	int largest_scenario;		// the largest number of changes of a single scenario
+	int next_scenario;
+	pthread_mutex_t lock;
+	int *status;
+	double *objective;
+	double *runtime;
+	double *solutions;			// NULL unless the solutions are wanted
+} GurobifyBatch;
+
+typedef struct {
+	GRBmodel *model;
+	GurobifyBatch *batch;
+	double *saved;				// room for the previous values of the largest scenario
+	int error;
+} GurobifyBatchWorker;
+
+/*
+	Solves a single scenario on the given model, and then restores the changed attributes
+	to their previous values, which are kept in saved meanwhile. The model keeps its basis,
+	so the next scenario starts warm. Does not touch any GAP objects or allocate memory, so
+	it may be called from a worker thread.
 */
-static Int InitKernel( StructInitInfo *module )
+
+static int GurobifySolveScenario(GRBmodel *model, GurobifyBatch *batch, int s, double *saved_values)
 {
-    /* init filters and functions                                          */
-    InitHdlrFuncsFromTable( GVarFuncs );
+	GurobifyScenario *scenario = &batch->scenarios[s];
+	double *saved[GUROBIFY_SCENARIO_ATTRIBUTES];
+	int a;
+	int error = 0;
+	int optimstatus;
+	// Only the attributes before number_saved have been saved (and changed), so only these are restored.
+	int number_saved = 0;
+
+	for (a = 0; a < GUROBIFY_SCENARIO_ATTRIBUTES && ! error; a = a+1){
+		GurobifySparseVector *v = &scenario->changes[a];
+		saved[a] = saved_values;
+		saved_values = saved_values + v->length;
+		if (v->length > 0)
+			error = GRBgetdblattrlist(model, gurobify_scenario_attributes[a], v->length, v->indices, saved[a]);
+		if (error)
+			break;
+		number_saved = a+1;
+		if (v->length > 0)
+			error = GRBsetdblattrlist(model, gurobify_scenario_attributes[a], v->length, v->indices, v->values);
+	}
 
-	
-    InitCopyGVar( "TheTypeGurobiModel", &TheTypeGurobiModel );
+	if (! error)
+		error = GRBoptimize(model);
+	if (! error)
+		error = GRBgetintattr(model, GRB_INT_ATTR_STATUS, &optimstatus);
+	if (! error){
+		batch->status[s] = optimstatus;
+		if (GRBgetdblattr(model, "ObjVal", &batch->objective[s]))
+			batch->objective[s] = GRB_INFINITY;
+		GRBgetdblattr(model, "Runtime", &batch->runtime[s]);
+		if (batch->solutions != NULL && optimstatus == GRB_OPTIMAL)
+			error = GRBgetdblattrarray(model, "X", 0, batch->number_of_variables,
+						batch->solutions + (size_t) s * batch->number_of_variables);
+	}
 
-    int error = 0;
-    error = GRBloadenv(&env, NULL);     // We are not interested in a log file, so the second argument of GRBloadenv is NULL
-    if (error || env == NULL)
-        ErrorMayQuit( "Error: failed to create new environment.", 0, 0 );
-    /* return success*/
-	error = GRBsetintparam(env, "LogToConsole", 0);
+	for (a = 0; a < number_saved; a = a+1){
+		GurobifySparseVector *v = &scenario->changes[a];
+		if (v->length > 0)
+			GRBsetdblattrlist(model, gurobify_scenario_attributes[a], v->length, v->indices, saved[a]);
+	}
+	GRBupdatemodel(model);
+
+	return error;
+}
+
+static void *GurobifyBatchWorkerMain(void *arg)
+{
+	GurobifyBatchWorker *worker = (GurobifyBatchWorker*) arg;
+	GurobifyBatch *batch = worker->batch;
+	int s;
+
+	while (! worker->error){
+		pthread_mutex_lock(&batch->lock);
+		s = batch->next_scenario;
+		batch->next_scenario = batch->next_scenario + 1;
+		pthread_mutex_unlock(&batch->lock);
+		if (s >= batch->number_of_scenarios)
+			break;
+		worker->error = GurobifySolveScenario(worker->model, batch, s, worker->saved);
+	}
+	return NULL;
+}
+
+/*
+This function is not documented.
+
+	Solves a list of scenarios, each of which is a record describing a modification of the base model.
+	The record components Obj, LB, UB and RHS are optional, and each is a list [ Positions, Values ]
+	of changes to the corresponding attribute. Variables are indexed from 1 and constraints by their
+	position starting from 0. The model is unchanged afterwards. If Threads is greater than 1 then
+	the scenarios are spread over that many copies of the model. Returns a record with the lists
+	status, objective, runtime and, if WithSolutions is true, solutions.
+*/
+
+Obj GUROBISOLVESCENARIOS(Obj self, Obj GAPmodel, Obj Scenarios, Obj Threads, Obj WithSolutions)
+{
+
+	if (! IS_MODEL(GAPmodel))
+        ErrorMayQuit( "Error: Must pass a valid Gurobi model", 0, 0 );
+
+	GRBmodel *model = GET_MODEL(GAPmodel);
+
+	if (! IS_SMALL_LIST(Scenarios))
+		ErrorMayQuit( "Error: Scenarios must be a list of records.", 0, 0 );
+
+	if (! IS_INTOBJ(Threads) || INT_INTOBJ(Threads) < 1)
+		ErrorMayQuit( "Error: Threads must be a positive integer.", 0, 0 );
+
+	int error;
+	int i, a;
+	int number_of_variables, number_of_constraints;
+	error = GUROBIFY_TIMED(GRBupdatemodel(model));
+	if (! error)
+		error = GRBgetintattr(model, "NumVars", &number_of_variables);
+	if (! error)
+		error = GRBgetintattr(model, "NumConstrs", &number_of_constraints);
+	if (error)
+		ErrorMayQuit( "Error: unable to obtain size of model", 0, 0 );
+
+	GurobifyBatch batch;
+	batch.number_of_scenarios = LEN_LIST(Scenarios);
+	batch.number_of_variables = number_of_variables;
+	batch.largest_scenario = 0;
+	batch.next_scenario = 0;
+	batch.scenarios = (GurobifyScenario*) GurobifyScratch((batch.number_of_scenarios+1)*sizeof(GurobifyScenario));
+	memset(batch.scenarios, 0, (batch.number_of_scenarios+1)*sizeof(GurobifyScenario));
+
+	for (i = 0; i < batch.number_of_scenarios; i = i+1){
+		Obj scenario = ELM_LIST(Scenarios, i+1);
+		if (! IS_PREC(scenario))
+			ErrorMayQuit( "Error: Scenarios must be a list of records.", 0, 0 );
+		for (a = 0; a < GUROBIFY_SCENARIO_ATTRIBUTES; a = a+1){
+			UInt rnam = RNamName(gurobify_scenario_attributes[a]);
+			if (! IsbPRec(scenario, rnam))
+				continue;
+			Obj change = ElmPRec(scenario, rnam);
+			if (! IS_SMALL_LIST(change) || LEN_LIST(change) != 2)
+				ErrorMayQuit( "Error: each change must be a list [ Positions, Values ].", 0, 0 );
+			if (a == 3)
+				GurobifyReadSparseVector(ELM_LIST(change, 1), ELM_LIST(change, 2), 0, number_of_constraints,
+							&batch.scenarios[i].changes[a]);
+			else
+				GurobifyReadSparseVector(ELM_LIST(change, 1), ELM_LIST(change, 2), 1, number_of_variables,
+							&batch.scenarios[i].changes[a]);
+		}
+		int number_of_changes = 0;
+		for (a = 0; a < GUROBIFY_SCENARIO_ATTRIBUTES; a = a+1)
+			number_of_changes = number_of_changes + batch.scenarios[i].changes[a].length;
+		if (number_of_changes > batch.largest_scenario)
+			batch.largest_scenario = number_of_changes;
+	}
+
+	batch.status = (int*) GurobifyScratch((batch.number_of_scenarios+1)*sizeof(int));
+	batch.objective = (double*) GurobifyScratch((batch.number_of_scenarios+1)*sizeof(double));
+	batch.runtime = (double*) GurobifyScratch((batch.number_of_scenarios+1)*sizeof(double));
+	batch.solutions = NULL;
+	if (WithSolutions == True)
+		batch.solutions = (double*) GurobifyScratch(((size_t) batch.number_of_scenarios * number_of_variables + 1)*sizeof(double));
+
+	int number_of_threads = INT_INTOBJ(Threads);
+	if (number_of_threads > batch.number_of_scenarios)
+		number_of_threads = batch.number_of_scenarios;
+	if (number_of_threads < 1)
+		number_of_threads = 1;
+
+	// The first worker uses the model itself, the others work on copies in environments of their own.
+	// While other threads run, the model itself is also optimised with a single thread.
+	GurobifyBatchWorker* workers = (GurobifyBatchWorker*) GurobifyScratch(number_of_threads*sizeof(GurobifyBatchWorker));
+	GRBmodel** models = (GRBmodel**) GurobifyScratch(number_of_threads*sizeof(GRBmodel*));
+	GRBenv** envs = (GRBenv**) GurobifyScratch(number_of_threads*sizeof(GRBenv*));
+	pthread_t* threads = (pthread_t*) GurobifyScratch(number_of_threads*sizeof(pthread_t));
+	for (i = 0; i < number_of_threads; i = i+1)
+		workers[i].saved = (double*) GurobifyScratch((batch.largest_scenario+1)*sizeof(double));
+	int model_threads = 0;
+	if (number_of_threads > 1){
+		GRBgetintparam(GRBgetenv(model), "Threads", &model_threads);
+		GRBsetintparam(GRBgetenv(model), "Threads", 1);
+	}
+	for (i = 0; i < number_of_threads; i = i+1){
+		envs[i] = NULL;
+		models[i] = (i == 0) ? model : GurobifyThreadModel(model, &envs[i]);
+		workers[i].model = models[i];
+		workers[i].batch = &batch;
+		workers[i].error = (models[i] == NULL);
+	}
+
+	pthread_mutex_init(&batch.lock, NULL);
+	current_active_gurobi_batch = models;
+	current_active_gurobi_batch_size = number_of_threads;
+	void (*current_signal_handler)(int);
+	current_signal_handler = signal(SIGINT,gurobify_signal_handler);
+	if (number_of_threads == 1)
+		GurobifyBatchWorkerMain(&workers[0]);
+	else{
+		for (i = 0; i < number_of_threads; i = i+1)
+			pthread_create(&threads[i], NULL, GurobifyBatchWorkerMain, &workers[i]);
+		for (i = 0; i < number_of_threads; i = i+1)
+			pthread_join(threads[i], NULL);
+	}
+	signal(SIGINT,current_signal_handler);
+	current_active_gurobi_batch = NULL;
+	current_active_gurobi_batch_size = 0;
+	pthread_mutex_destroy(&batch.lock);
+
+	error = 0;
+	for (i = 0; i < number_of_threads; i = i+1){
+		if (workers[i].error)
+			error = 1;
+		if (i > 0)
+			GurobifyFreeThreadModel(models[i], envs[i]);
+	}
+	if (number_of_threads > 1)
+		GRBsetintparam(GRBgetenv(model), "Threads", model_threads);
+
+	Obj status = NEW_PLIST(T_PLIST, batch.number_of_scenarios);
+	Obj objective = NEW_PLIST(T_PLIST, batch.number_of_scenarios);
+	Obj runtime = NEW_PLIST(T_PLIST, batch.number_of_scenarios);
+	Obj solutions = NEW_PLIST(T_PLIST, batch.number_of_scenarios);
+	if (! error){
+		for (i = 0; i < batch.number_of_scenarios; i = i+1){
+			ASS_LIST(status, i+1, INTOBJ_INT(batch.status[i]));
+			ASS_LIST(runtime, i+1, NEW_MACFLOAT(batch.runtime[i]));
+			if (batch.status[i] == GRB_OPTIMAL)
+				ASS_LIST(objective, i+1, NEW_MACFLOAT(batch.objective[i]));
+			else
+				ASS_LIST(objective, i+1, Fail);
+			if (batch.solutions != NULL){
+				if (batch.status[i] == GRB_OPTIMAL){
+					GurobifyCountBytes(number_of_variables*sizeof(double));
+					Obj solution = NEW_PLIST(T_PLIST, number_of_variables);
+					for (a = 0; a < number_of_variables; a = a+1)
+						ASS_LIST(solution, a+1, NEW_MACFLOAT(batch.solutions[(size_t) i * number_of_variables + a]));
+					ASS_LIST(solutions, i+1, solution);
+				}
+				else
+					ASS_LIST(solutions, i+1, Fail);
+			}
+		}
+	}
+
+	if (error)
+		ErrorMayQuit( "Error: unable to solve scenarios", 0, 0 );
+
+	Obj result = NEW_PREC(4);
+	AssPRec(result, RNamName("status"), status);
+	AssPRec(result, RNamName("objective"), objective);
+	AssPRec(result, RNamName("runtime"), runtime);
+	if (WithSolutions == True)
+		AssPRec(result, RNamName("solutions"), solutions);
+
+	return result;
+}
+
+
+/*
+	#! @Chapter Using Gurobify
+	#! @Section Modifying Other Attributes And Parameters
+	#! @Arguments Model, Changes
+	#! @Returns true
+	#! @Description
+	#!	Changes only some entries of the objective function, bounds, right hand sides and constraint matrix of a model,
+	#!	all in one batch, which is much cheaper than setting whole attribute arrays in loops that change a model slightly
+	#!	between optimisations. Changes is a record, whose components Obj, LB, UB and RHS are optional and each a list
+	#!	[ Positions, Values ] of changes to the corresponding attribute, as for the scenarios of GurobiSolveScenarios.
+	#!	The optional component Coefficients is a list [ Constraints, Variables, Values ] of changed coefficients of the
+	#!	constraint matrix, where a value of 0 removes a variable from a constraint. Variables are indexed from 1 and
+	#!	constraints by their position starting from 0. The model is updated afterwards, and keeps its solution
+	#!	basis, so that the next optimisation of a linear program starts warm from it. All changes are checked before any is made,
+	#!	so that the model is left unchanged if one of them is invalid.
+	DeclareGlobalFunction("GurobiChangeModel");
+*/
+
+Obj GurobiChangeModel(Obj self, Obj GAPmodel, Obj Changes)
+{
+	int i, a;
+	int error;
+	int number_of_variables, number_of_constraints;
+
+	if (! IS_MODEL(GAPmodel))
+        ErrorMayQuit( "Error: Must pass a valid Gurobi model", 0, 0 );
+	if (! IS_PREC(Changes))
+        ErrorMayQuit( "Error: Changes must be a record.", 0, 0 );
+
+	GRBmodel *model = GET_MODEL(GAPmodel);
+	error = GUROBIFY_TIMED(GRBupdatemodel(model));
+	if (! error)
+		error = GRBgetintattr(model, "NumVars", &number_of_variables);
+	if (! error)
+		error = GRBgetintattr(model, "NumConstrs", &number_of_constraints);
 	if (error)
-		ErrorMayQuit( "Error: unable to turn logging off", 0, 0 );
+		ErrorMayQuit( "Error: unable to obtain size of model", 0, 0 );
+
+	// Every component is read and checked before the model is changed, so that an error leaves the model as it was.
+	GurobifySparseVector changes[GUROBIFY_SCENARIO_ATTRIBUTES];
+	for (a = 0; a < GUROBIFY_SCENARIO_ATTRIBUTES; a = a+1){
+		changes[a].length = 0;
+		UInt rnam = RNamName(gurobify_scenario_attributes[a]);
+		if (! IsbPRec(Changes, rnam))
+			continue;
+		Obj change = ElmPRec(Changes, rnam);
+		if (! IS_SMALL_LIST(change) || LEN_LIST(change) != 2)
+			ErrorMayQuit( "Error: each change must be a list [ Positions, Values ].", 0, 0 );
+		if (a == 3)
+			GurobifyReadSparseVector(ELM_LIST(change, 1), ELM_LIST(change, 2), 0, number_of_constraints, &changes[a]);
+		else
+			GurobifyReadSparseVector(ELM_LIST(change, 1), ELM_LIST(change, 2), 1, number_of_variables, &changes[a]);
+	}
+
+	int length = 0;
+	int *constraint_indices = NULL;
+	int *variable_indices = NULL;
+	double *values = NULL;
+	UInt rnam = RNamName("Coefficients");
+	if (IsbPRec(Changes, rnam)){
+		Obj change = ElmPRec(Changes, rnam);
+		if (! IS_SMALL_LIST(change) || LEN_LIST(change) != 3)
+			ErrorMayQuit( "Error: Coefficients must be a list [ Constraints, Variables, Values ].", 0, 0 );
+		Obj Constraints = ELM_LIST(change, 1);
+		Obj Variables = ELM_LIST(change, 2);
+		Obj Values = ELM_LIST(change, 3);
+		if (! IS_SMALL_LIST(Constraints) || ! IS_SMALL_LIST(Variables) || ! IS_SMALL_LIST(Values)
+				|| LEN_LIST(Variables) != LEN_LIST(Constraints) || LEN_LIST(Values) != LEN_LIST(Constraints))
+			ErrorMayQuit( "Error: Constraints, Variables and Values must be lists of the same length.", 0, 0 );
+		length = LEN_LIST(Constraints);
+		constraint_indices = (int*) GurobifyScratch((length+1)*sizeof(int));
+		variable_indices = (int*) GurobifyScratch((length+1)*sizeof(int));
+		values = (double*) GurobifyScratch((length+1)*sizeof(double));
+		for (i = 0; i < length; i = i+1){
+			Obj constraint = ELM_LIST(Constraints, i+1);
+			Obj variable = ELM_LIST(Variables, i+1);
+			if (! IS_INTOBJ(constraint) || INT_INTOBJ(constraint) < 0 || INT_INTOBJ(constraint) >= number_of_constraints)
+				ErrorMayQuit( "Error: constraint index out of range.", 0, 0 );
+			if (! IS_INTOBJ(variable) || INT_INTOBJ(variable) < 1 || INT_INTOBJ(variable) > number_of_variables)
+				ErrorMayQuit( "Error: variable index out of range.", 0, 0 );
+			if (! GurobifyGetDouble(ELM_LIST(Values, i+1), &values[i]))
+				ErrorMayQuit( "Error: Values must be integers or floats.", 0, 0 );
+			constraint_indices[i] = INT_INTOBJ(constraint);
+			variable_indices[i] = INT_INTOBJ(variable) - 1;
+		}
+		GurobifyCountBytes(length*(2*sizeof(int) + sizeof(double)));
+	}
+
+	if (changes[3].length > 0 || length > 0)
+		GurobifyDropMatrix(GAPmodel);
+	for (a = 0; a < GUROBIFY_SCENARIO_ATTRIBUTES; a = a+1){
+		error = 0;
+		if (changes[a].length > 0)
+			error = GUROBIFY_TIMED(GRBsetdblattrlist(model, gurobify_scenario_attributes[a], changes[a].length, changes[a].indices, changes[a].values));
+		if (error)
+			ErrorMayQuit( "Error: Unable to change attribute %s.", (Int) gurobify_scenario_attributes[a], 0 );
+	}
+	if (length > 0){
+		error = GUROBIFY_TIMED(GRBchgcoeffs(model, length, constraint_indices, variable_indices, values));
+		if (error)
+			ErrorMayQuit( "Error: Unable to change coefficients.", 0, 0 );
+	}
+
+	error = GUROBIFY_TIMED(GRBupdatemodel(model));
+	if (error)
+		ErrorMayQuit( "Error: Unable to update model.", 0, 0 );
+
+	return True;
+}
+
+/*
+	#! @Chapter Using Gurobify
+	#! @Section Optimising A Model
+	#! @Arguments Model, ParameterSets
+	#! @Returns record
+	#! @Description
+	#!	Optimises a model by racing several differently configured copies of it against each other, which helps
+	#!	with models whose solve time varies a lot with settings such as Seed, MIPFocus or Method.
+	#!	ParameterSets is a list of records of parameters as for GurobiSetParameters, or a positive integer n,
+	#!	which stands for the n records rec(Seed := 0), ..., rec(Seed := n-1). Each copy gets the parameters of
+	#!	Model, changed by its record, and Threads := 1 unless the record sets Threads, and is optimised in a
+	#!	thread and a Gurobi environment of its own. As soon as one copy proves optimality, infeasibility or
+	#!	unboundedness, the others are stopped. Model then takes over the solution and statistics of that copy, or
+	#!	of the copy which finished first if none of them did (for example because of a time limit), but keeps its
+	#!	own parameters. Model then lives in the environment of that copy, which is freed together with it, or with
+	#!	its next race. Copies of Model, with ShallowCopy or GurobiLazyCopy, are made in the usual environment.
+	#!	Returns a record with components status, the status code of the winning copy as for GurobiOptimiseModel,
+	#!	winner, the position of its parameter set, and statuses, the status codes of all copies.
+	DeclareGlobalFunction("GurobiRaceModel");
+*/
+
+typedef struct {
+	int number_of_racers;
+	GRBmodel **models;
+	int *status;
+	int *error;
+	int winner;
+	volatile int conclusive;
+	pthread_mutex_t lock;
+} GurobifyRace;
+
+typedef struct {
+	GurobifyRace *race;
+	int racer;
+} GurobifyRacer;
+
+static int GurobifyConclusiveStatus(int status)
+{
+	return status == GRB_OPTIMAL || status == GRB_INFEASIBLE || status == GRB_INF_OR_UNBD || status == GRB_UNBOUNDED;
+}
+
+/*
+	The callback of each copy. A copy terminated by the winner just before it starts optimising may not notice,
+	so every copy also stops itself as soon as it sees that the race is decided.
+*/
+
+static int GurobifyRacerCallback(CB_ARGS)
+{
+	GurobifyRace *race = (GurobifyRace*) usrdata;
+	if (race->conclusive)
+		GRBterminate(model);
+	return 0;
+}
+
+static void *GurobifyRacerMain(void *arg)
+{
+	GurobifyRacer *racer = (GurobifyRacer*) arg;
+	GurobifyRace *race = racer->race;
+	GRBmodel *model = race->models[racer->racer];
+	int i;
+	int started = 0;
+
+	// A copy which starts after the race is decided would not notice being stopped, so it does not start at all.
+	pthread_mutex_lock(&race->lock);
+	if (! race->conclusive)
+		started = 1;
+	pthread_mutex_unlock(&race->lock);
+	if (! started){
+		race->status[racer->racer] = GRB_INTERRUPTED;
+		return NULL;
+	}
+
+	race->error[racer->racer] = GRBoptimize(model);
+	if (! race->error[racer->racer])
+		race->error[racer->racer] = GRBgetintattr(model, GRB_INT_ATTR_STATUS, &race->status[racer->racer]);
+	if (race->error[racer->racer])
+		return NULL;
+
+	pthread_mutex_lock(&race->lock);
+	if (race->winner < 0 || (! race->conclusive && GurobifyConclusiveStatus(race->status[racer->racer])))
+		race->winner = racer->racer;
+	if (! race->conclusive && GurobifyConclusiveStatus(race->status[racer->racer])){
+		race->conclusive = 1;
+		for (i = 0; i < race->number_of_racers; i = i+1)
+			if (i != racer->racer)
+				GRBterminate(race->models[i]);
+	}
+	pthread_mutex_unlock(&race->lock);
+
+	return NULL;
+}
+
+Obj GurobiRaceModel(Obj self, Obj GAPmodel, Obj ParameterSets)
+{
+	int i;
+	int error;
+
+	if (! IS_MODEL(GAPmodel))
+        ErrorMayQuit( "Error: Must pass a valid Gurobi model", 0, 0 );
+	if (! (IS_INTOBJ(ParameterSets) && INT_INTOBJ(ParameterSets) > 0)
+			&& ! (IS_SMALL_LIST(ParameterSets) && LEN_LIST(ParameterSets) > 0))
+        ErrorMayQuit( "Error: ParameterSets must be a non-empty list of records or a positive integer.", 0, 0 );
+
+	GRBmodel *model = GET_MODEL(GAPmodel);
+	error = GUROBIFY_TIMED(GRBupdatemodel(model));
+	if (error)
+        ErrorMayQuit( "Error: Unable to update model.", 0, 0 );
+
+	GurobifyRace race;
+	race.number_of_racers = IS_INTOBJ(ParameterSets) ? INT_INTOBJ(ParameterSets) : LEN_LIST(ParameterSets);
+	race.winner = -1;
+	race.conclusive = 0;
+
+	// The copies are held by model objects until the race is over, so that they are freed after an error,
+	// each together with its environment.
+	Obj copies = NEW_PLIST(T_PLIST, race.number_of_racers);
+	race.models = (GRBmodel**) GurobifyScratch(race.number_of_racers*sizeof(GRBmodel*));
+	GRBenv **envs = (GRBenv**) GurobifyScratch(race.number_of_racers*sizeof(GRBenv*));
+	for (i = 0; i < race.number_of_racers; i = i+1){
+		GRBmodel *copy = GurobifyThreadModel(model, &envs[i]);
+		if (copy == NULL)
+			ErrorMayQuit( "Error: unable to copy model", 0, 0 );
+		if (GurobifyKeepEnv(envs[i], copy)){
+			GurobifyFreeThreadModel(copy, envs[i]);
+			ErrorMayQuit( "Error: out of memory", 0, 0 );
+		}
+		ASS_LIST(copies, i+1, NewModel(copy));
+		race.models[i] = copy;
+		GRBenv *copyenv = GRBgetenv(copy);
+		if (GRBsetcallbackfunc(copy, GurobifyRacerCallback, &race))
+			ErrorMayQuit( "Error: Unable to set the callback.", 0, 0 );
+		if (IS_INTOBJ(ParameterSets)){
+			if (GRBsetintparam(copyenv, "Seed", i))
+				ErrorMayQuit( "Error: Unable to set parameter Seed.", 0, 0 );
+		}
+		else
+			GurobifySetParameterRecord(copyenv, ELM_LIST(ParameterSets, i+1));
+	}
+
+	race.status = (int*) GurobifyScratch(race.number_of_racers*sizeof(int));
+	race.error = (int*) GurobifyScratch(race.number_of_racers*sizeof(int));
+	GurobifyRacer *racers = (GurobifyRacer*) GurobifyScratch(race.number_of_racers*sizeof(GurobifyRacer));
+	pthread_t *threads = (pthread_t*) GurobifyScratch(race.number_of_racers*sizeof(pthread_t));
+	for (i = 0; i < race.number_of_racers; i = i+1){
+		race.status[i] = GRB_LOADED;
+		race.error[i] = 0;
+		racers[i].race = &race;
+		racers[i].racer = i;
+	}
+
+	pthread_mutex_init(&race.lock, NULL);
+	current_active_gurobi_batch = race.models;
+	current_active_gurobi_batch_size = race.number_of_racers;
+	void (*current_signal_handler)(int);
+	current_signal_handler = signal(SIGINT,gurobify_signal_handler);
+	for (i = 1; i < race.number_of_racers; i = i+1)
+		pthread_create(&threads[i], NULL, GurobifyRacerMain, &racers[i]);
+	GurobifyRacerMain(&racers[0]);
+	for (i = 1; i < race.number_of_racers; i = i+1)
+		pthread_join(threads[i], NULL);
+	signal(SIGINT,current_signal_handler);
+	current_active_gurobi_batch = NULL;
+	current_active_gurobi_batch_size = 0;
+	pthread_mutex_destroy(&race.lock);
+
+	if (race.winner < 0)
+        ErrorMayQuit( "Error: model was not able to be optimised", 0, 0 );
+
+	// The winning copy replaces the model of the object, with the parameters of the original model.
+	GRBmodel *winner = race.models[race.winner];
+	error = GRBsetcallbackfunc(winner, NULL, NULL);
+	if (! error)
+		error = GRBcopyparams(GRBgetenv(winner), GRBgetenv(model));
+	if (error)
+        ErrorMayQuit( "Error: Unable to copy parameters.", 0, 0 );
+	SET_MODEL(ELM_LIST(copies, race.winner+1), model);
+	SET_MODEL(GAPmodel, winner);
+	GurobifyModelData *data = GET_DATA(GAPmodel);
+	if (data != NULL){
+		data->presolve_seen = 0;
+		if (data->log_capacity > 0)
+			GurobifyClearLog(data);
+	}
+
+	// The other copies and the original model are freed straight away rather than by the garbage collector,
+	// with their environments, which includes that of the winner of a previous race of the object.
+	Obj statuses = NEW_PLIST(T_PLIST, race.number_of_racers);
+	for (i = 0; i < race.number_of_racers; i = i+1){
+		Obj copy = ELM_LIST(copies, i+1);
+		GurobifyFreeModel((GRBmodel*)(ADDR_OBJ(copy)[0]));
+		SET_MODEL(copy, NULL);
+		ASS_LIST(statuses, i+1, INTOBJ_INT(race.status[i]));
+	}
+
+	Obj result = NEW_PREC(3);
+	AssPRec(result, RNamName("status"), INTOBJ_INT(race.status[race.winner]));
+	AssPRec(result, RNamName("winner"), INTOBJ_INT(race.winner+1));
+	AssPRec(result, RNamName("statuses"), statuses);
+
+	return result;
+}
+
+/*
+	The connected components of the graph whose vertices are the variables and constraints of a model,
+	with a constraint joined to each variable occurring in it. The variables of component k are
+	variables[variable_begin[k] .. variable_begin[k+1]-1], and similarly for the constraints. The data
+	of the model needed to build a separate model for each component is read once, in whole arrays.
+	These are taken from the scratch arena, so the components are found by the main thread, but worker
+	threads may read them.
+*/
+
+typedef struct {
+	int number_of_components;
+	int number_of_variables;
+	int number_of_constraints;
+	int *variable_begin;
+	int *variables;
+	int *constraint_begin;
+	int *constraints;
+	int *local_index;			// the position of each variable within its component
+
+	int model_sense;
+	double *obj;
+	double *lb;
+	double *ub;
+	char *vtype;
+	char **variable_names;
+	int number_of_nonzeros;
+	int *row_begin;
+	int *row_indices;
+	double *row_values;
+	char *sense;
+	double *rhs;
+	char **constraint_names;
+} GurobifyComponents;
+
+static int GurobifyFindRoot(int *parent, int i)
+{
+	while (parent[i] != i){
+		parent[i] = parent[parent[i]];
+		i = parent[i];
+	}
+	return i;
+}
+
+/* Finds the components of a model with a union-find over its variables and constraints. Returns a Gurobi error code. */
+static int GurobifyFindComponents(GRBmodel *model, GurobifyComponents *c)
+{
+	int i, j, k;
+	int n, m;
+	int error;
+
+	memset(c, 0, sizeof(GurobifyComponents));
+	error = GRBupdatemodel(model);
+	if (! error)
+		error = GRBgetintattr(model, "NumVars", &c->number_of_variables);
+	if (! error)
+		error = GRBgetintattr(model, "NumConstrs", &c->number_of_constraints);
+	if (! error)
+		error = GRBgetintattr(model, "NumNZs", &c->number_of_nonzeros);
+	if (! error)
+		error = GRBgetintattr(model, "ModelSense", &c->model_sense);
+	if (! error)
+		error = GRBgetintattr(model, "NumGenConstrs", &n);
+	if (! error)
+		error = GRBgetintattr(model, "NumSOS", &m);
+	if (error)
+		return error;
+	// General and SOS constraints are not split between components.
+	if (n > 0 || m > 0)
+		return GRB_ERROR_NOT_SUPPORTED;
+	n = c->number_of_variables;
+	m = c->number_of_constraints;
+
+	int *parent = (int*) GurobifyScratch((n + m + 1)*sizeof(int));
+	int *component_of = (int*) GurobifyScratch((n + m + 1)*sizeof(int));
+	c->variable_begin = (int*) GurobifyScratch((n + m + 2)*sizeof(int));
+	c->variables = (int*) GurobifyScratch((n + 1)*sizeof(int));
+	c->constraint_begin = (int*) GurobifyScratch((n + m + 2)*sizeof(int));
+	c->constraints = (int*) GurobifyScratch((m + 1)*sizeof(int));
+	c->local_index = (int*) GurobifyScratch((n + 1)*sizeof(int));
+	c->obj = (double*) GurobifyScratch((n + 1)*sizeof(double));
+	c->lb = (double*) GurobifyScratch((n + 1)*sizeof(double));
+	c->ub = (double*) GurobifyScratch((n + 1)*sizeof(double));
+	c->vtype = (char*) GurobifyScratch(n + 1);
+	c->variable_names = (char**) GurobifyScratch((n + 1)*sizeof(char*));
+	c->row_begin = (int*) GurobifyScratch((m + 1)*sizeof(int));
+	c->row_indices = (int*) GurobifyScratch((c->number_of_nonzeros + 1)*sizeof(int));
+	c->row_values = (double*) GurobifyScratch((c->number_of_nonzeros + 1)*sizeof(double));
+	c->sense = (char*) GurobifyScratch(m + 1);
+	c->rhs = (double*) GurobifyScratch((m + 1)*sizeof(double));
+	c->constraint_names = (char**) GurobifyScratch((m + 1)*sizeof(char*));
+
+	if (! error && n > 0){
+		error = GRBgetdblattrarray(model, "Obj", 0, n, c->obj);
+		if (! error)
+			error = GRBgetdblattrarray(model, "LB", 0, n, c->lb);
+		if (! error)
+			error = GRBgetdblattrarray(model, "UB", 0, n, c->ub);
+		if (! error)
+			error = GRBgetcharattrarray(model, "VType", 0, n, c->vtype);
+		if (! error)
+			error = GRBgetstrattrarray(model, "VarName", 0, n, c->variable_names);
+	}
+	if (! error && m > 0){
+		error = GRBgetconstrs(model, &c->number_of_nonzeros, c->row_begin, c->row_indices, c->row_values, 0, m);
+		if (! error)
+			error = GRBgetcharattrarray(model, "Sense", 0, m, c->sense);
+		if (! error)
+			error = GRBgetdblattrarray(model, "RHS", 0, m, c->rhs);
+		if (! error)
+			error = GRBgetstrattrarray(model, "ConstrName", 0, m, c->constraint_names);
+	}
+	if (error)
+		return error;
+	c->row_begin[m] = c->number_of_nonzeros;
+
+	// Vertices 0 .. n-1 are the variables, n .. n+m-1 the constraints.
+	for (i = 0; i < n + m; i = i+1)
+		parent[i] = i;
+	for (i = 0; i < m; i = i+1)
+		for (j = c->row_begin[i]; j < c->row_begin[i+1]; j = j+1)
+			parent[GurobifyFindRoot(parent, c->row_indices[j])] = GurobifyFindRoot(parent, n + i);
+
+	// Number the components in order of their first vertex, then sort the vertices by component.
+	for (i = 0; i < n + m; i = i+1)
+		component_of[i] = -1;
+	c->number_of_components = 0;
+	for (i = 0; i < n + m; i = i+1){
+		int root = GurobifyFindRoot(parent, i);
+		if (component_of[root] < 0){
+			component_of[root] = c->number_of_components;
+			c->number_of_components = c->number_of_components + 1;
+		}
+		component_of[i] = component_of[root];
+	}
+	for (k = 0; k <= c->number_of_components; k = k+1){
+		c->variable_begin[k] = 0;
+		c->constraint_begin[k] = 0;
+	}
+	for (i = 0; i < n; i = i+1)
+		c->variable_begin[component_of[i]+1] = c->variable_begin[component_of[i]+1] + 1;
+	for (i = 0; i < m; i = i+1)
+		c->constraint_begin[component_of[n+i]+1] = c->constraint_begin[component_of[n+i]+1] + 1;
+	for (k = 0; k < c->number_of_components; k = k+1){
+		c->variable_begin[k+1] = c->variable_begin[k+1] + c->variable_begin[k];
+		c->constraint_begin[k+1] = c->constraint_begin[k+1] + c->constraint_begin[k];
+	}
+	// parent is reused to count the vertices placed in each component so far.
+	for (k = 0; k < c->number_of_components; k = k+1)
+		parent[k] = 0;
+	for (i = 0; i < n; i = i+1){
+		k = component_of[i];
+		c->local_index[i] = parent[k];
+		c->variables[c->variable_begin[k] + parent[k]] = i;
+		parent[k] = parent[k] + 1;
+	}
+	for (k = 0; k < c->number_of_components; k = k+1)
+		parent[k] = 0;
+	for (i = 0; i < m; i = i+1){
+		k = component_of[n+i];
+		c->constraints[c->constraint_begin[k] + parent[k]] = i;
+		parent[k] = parent[k] + 1;
+	}
+
+	return 0;
+}
+
+/* The number of nonzeros in the constraints of the k-th component */
+static int GurobifyComponentNonzeros(GurobifyComponents *c, int k)
+{
+	int i;
+	int number_of_nonzeros = 0;
+	for (i = c->constraint_begin[k]; i < c->constraint_begin[k+1]; i = i+1)
+		number_of_nonzeros = number_of_nonzeros + c->row_begin[c->constraints[i]+1] - c->row_begin[c->constraints[i]];
+	return number_of_nonzeros;
+}
+
+/* The size of the workspace needed by GurobifyComponentModel for any of the components */
+static size_t GurobifyComponentWorkspaceSize(GurobifyComponents *c)
+{
+	int k;
+	size_t variables = 0, constraints = 0, nonzeros = 0;
+	for (k = 0; k < c->number_of_components; k = k+1){
+		if ((size_t) (c->variable_begin[k+1] - c->variable_begin[k]) > variables)
+			variables = c->variable_begin[k+1] - c->variable_begin[k];
+		if ((size_t) (c->constraint_begin[k+1] - c->constraint_begin[k]) > constraints)
+			constraints = c->constraint_begin[k+1] - c->constraint_begin[k];
+		if ((size_t) GurobifyComponentNonzeros(c, k) > nonzeros)
+			nonzeros = GurobifyComponentNonzeros(c, k);
+	}
+	return (3*(variables + 1) + (nonzeros + 1) + (constraints + 1))*sizeof(double)
+			+ ((variables + 1) + (constraints + 1))*sizeof(char*)
+			+ ((constraints + 1) + (nonzeros + 1))*sizeof(int)
+			+ (variables + 1) + (constraints + 1);
+}
+
+/*
+	Builds a separate model for the k-th component, in the environment env. The arrays passed to Gurobi are
+	taken from workspace, of GurobifyComponentWorkspaceSize(c) bytes, so that no memory is allocated here and
+	the workspace of a thread can be reused for every component it builds. Returns NULL on failure.
+*/
+static GRBmodel *GurobifyComponentModel(GRBenv *env, GurobifyComponents *c, int k, char *workspace)
+{
+	int i, j;
+	int error;
+	int first = c->variable_begin[k];
+	int number_of_variables = c->variable_begin[k+1] - first;
+	int number_of_constraints = c->constraint_begin[k+1] - c->constraint_begin[k];
+	int number_of_nonzeros = GurobifyComponentNonzeros(c, k);
+	GRBmodel *component = NULL;
+
+	// The doubles come first and the chars last, so that every array is aligned.
+	double *obj = (double*) workspace;
+	double *lb = obj + number_of_variables + 1;
+	double *ub = lb + number_of_variables + 1;
+	double *row_values = ub + number_of_variables + 1;
+	double *rhs = row_values + number_of_nonzeros + 1;
+	char **variable_names = (char**) (rhs + number_of_constraints + 1);
+	char **constraint_names = variable_names + number_of_variables + 1;
+	int *row_begin = (int*) (constraint_names + number_of_constraints + 1);
+	int *row_indices = row_begin + number_of_constraints + 1;
+	char *vtype = (char*) (row_indices + number_of_nonzeros + 1);
+	char *sense = vtype + number_of_variables + 1;
+
+	for (i = 0; i < number_of_variables; i = i+1){
+		int v = c->variables[first + i];
+		obj[i] = c->obj[v];
+		lb[i] = c->lb[v];
+		ub[i] = c->ub[v];
+		vtype[i] = c->vtype[v];
+		variable_names[i] = c->variable_names[v];
+	}
+	number_of_nonzeros = 0;
+	for (i = 0; i < number_of_constraints; i = i+1){
+		int r = c->constraints[c->constraint_begin[k] + i];
+		row_begin[i] = number_of_nonzeros;
+		for (j = c->row_begin[r]; j < c->row_begin[r+1]; j = j+1){
+			row_indices[number_of_nonzeros] = c->local_index[c->row_indices[j]];
+			row_values[number_of_nonzeros] = c->row_values[j];
+			number_of_nonzeros = number_of_nonzeros + 1;
+		}
+		sense[i] = c->sense[r];
+		rhs[i] = c->rhs[r];
+		constraint_names[i] = c->constraint_names[r];
+	}
+	error = GRBnewmodel(env, &component, NULL, number_of_variables, obj, lb, ub, vtype, variable_names);
+	if (! error)
+		error = GRBsetintattr(component, "ModelSense", c->model_sense);
+	if (! error && number_of_constraints > 0)
+		error = GRBaddconstrs(component, number_of_constraints, number_of_nonzeros, row_begin, row_indices,
+					row_values, sense, rhs, constraint_names);
+	if (! error)
+		error = GRBupdatemodel(component);
+
+	if (error && component != NULL){
+		GRBfreemodel(component);
+		component = NULL;
+	}
+	return component;
+}
+
+/*
+	#! @Chapter Using Gurobify
+	#! @Section Additional Functionality
+	#! @Arguments Model
+	#! @Returns list of records
+	#! @Description
+	#!	Finds the connected components of a model, where two variables are connected if they occur in a common
+	#!	constraint. Each component is a record with components variables, the indices of its variables (starting
+	#!	from 1), and constraints, the positions of its constraints (starting from 0, as for GurobiDeleteConstraints).
+	#!	The components of a model can be solved independently, see GurobiOptimiseComponents.
+	#!	Models with indicator, SOS or general constraints are not supported.
+	DeclareGlobalFunction("GurobiComponents");
+*/
+
+Obj GurobiComponents(Obj self, Obj GAPmodel)
+{
+	int i, k;
+	GurobifyComponents components;
+
+	if (! IS_MODEL(GAPmodel))
+        ErrorMayQuit( "Error: Must pass a valid Gurobi model", 0, 0 );
+
+	GRBmodel *model = GET_MODEL_READ(GAPmodel);
+	if (GUROBIFY_TIMED(GurobifyFindComponents(model, &components)))
+		ErrorMayQuit( "Error: Unable to find the components of the model.", 0, 0 );
+
+	Obj result = NEW_PLIST(T_PLIST, components.number_of_components);
+	for (k = 0; k < components.number_of_components; k = k+1){
+		Obj variables = NEW_PLIST(T_PLIST, components.variable_begin[k+1] - components.variable_begin[k]);
+		for (i = components.variable_begin[k]; i < components.variable_begin[k+1]; i = i+1)
+			ASS_LIST(variables, i - components.variable_begin[k] + 1, INTOBJ_INT(components.variables[i] + 1));
+		Obj constraints = NEW_PLIST(T_PLIST, components.constraint_begin[k+1] - components.constraint_begin[k]);
+		for (i = components.constraint_begin[k]; i < components.constraint_begin[k+1]; i = i+1)
+			ASS_LIST(constraints, i - components.constraint_begin[k] + 1, INTOBJ_INT(components.constraints[i]));
+		Obj component = NEW_PREC(2);
+		AssPRec(component, RNamName("variables"), variables);
+		AssPRec(component, RNamName("constraints"), constraints);
+		ASS_LIST(result, k+1, component);
+	}
+
+	return result;
+}
+
+/*
+	#! @Chapter Using Gurobify
+	#! @Section Additional Functionality
+	#! @Arguments Model
+	#! @Returns list of models
+	#! @Description
+	#!	Returns a new Gurobi model for each of the components of a model (see GurobiComponents), in the same order.
+	#!	The variables and constraints of each of these models are those of the component, in the same order,
+	#!	and keep their names, objective coefficients, bounds and types. The parameters of the model are kept as well.
+	DeclareGlobalFunction("GurobiComponentModels");
+*/
+
+Obj GurobiComponentModels(Obj self, Obj GAPmodel)
+{
+	int k;
+	GurobifyComponents components;
+
+	if (! IS_MODEL(GAPmodel))
+        ErrorMayQuit( "Error: Must pass a valid Gurobi model", 0, 0 );
+
+	GRBmodel *model = GET_MODEL_READ(GAPmodel);
+	if (GUROBIFY_TIMED(GurobifyFindComponents(model, &components)))
+		ErrorMayQuit( "Error: Unable to find the components of the model.", 0, 0 );
+
+	Obj result = NEW_PLIST(T_PLIST, components.number_of_components);
+	char *workspace = (char*) GurobifyScratch(GurobifyComponentWorkspaceSize(&components));
+	for (k = 0; k < components.number_of_components; k = k+1){
+		GRBmodel *component = GurobifyComponentModel(GRBgetenv(model), &components, k, workspace);
+		if (component == NULL)
+			ErrorMayQuit( "Error: Unable to create the model of a component.", 0, 0 );
+		ASS_LIST(result, k+1, NewModel(component));
+	}
+
+	return result;
+}
+
+/*
+	The separate models of the components, solved in parallel by GUROBIOPTIMISECOMPONENTS. With more than one
+	thread, each thread has an environment of its own (see GurobifyThreadEnv) and builds the models of the
+	components it takes in it, so that no two models optimised at the same time share an environment.
+*/
+
+typedef struct {
+	GurobifyComponents *components;
+	GRBmodel **models;
+	int number_of_models;
+	int next_model;
+	pthread_mutex_t lock;
+	int error;
+} GurobifyComponentBatch;
+
+typedef struct {
+	GurobifyComponentBatch *batch;
+	GRBenv *env;
+	char *workspace;			// see GurobifyComponentModel
+} GurobifyComponentWorker;
+
+static void *GurobifyComponentWorkerMain(void *arg)
+{
+	GurobifyComponentWorker *worker = (GurobifyComponentWorker*) arg;
+	GurobifyComponentBatch *batch = worker->batch;
+	GRBmodel *component;
+	int k;
+	int error;
+
+	while (1){
+		pthread_mutex_lock(&batch->lock);
+		k = batch->next_model;
+		batch->next_model = batch->next_model + 1;
+		error = batch->error;
+		pthread_mutex_unlock(&batch->lock);
+		if (k >= batch->number_of_models || error)
+			break;
+		component = GurobifyComponentModel(worker->env, batch->components, k, worker->workspace);
+		// Once in the batch, the model is terminated by an interrupt.
+		batch->models[k] = component;
+		error = component == NULL ? GRB_ERROR_OUT_OF_MEMORY : GRBoptimize(component);
+		if (error){
+			pthread_mutex_lock(&batch->lock);
+			batch->error = error;
+			pthread_mutex_unlock(&batch->lock);
+		}
+	}
+	return NULL;
+}
+
+/*
+	Builds and solves the models of the batch with the given number of threads, leaving the models in the batch.
+	With a single thread they are built in env, and otherwise each thread loads an environment with the parameters
+	of env, returned in envs to be freed after the models. Returns a Gurobi error code. The arrays needed are taken
+	from the scratch arena, so this may only be called by the main thread.
+*/
+static int GurobifySolveComponentBatch(GurobifyComponentBatch *batch, GRBenv *env, GRBenv **envs, int number_of_threads)
+{
+	int i;
+	size_t workspace_size = GurobifyComponentWorkspaceSize(batch->components);
+	pthread_t* threads = (pthread_t*) GurobifyScratch((number_of_threads + 1)*sizeof(pthread_t));
+	GurobifyComponentWorker *workers = (GurobifyComponentWorker*) GurobifyScratch((number_of_threads + 1)*sizeof(GurobifyComponentWorker));
+	for (i = 0; i <= number_of_threads; i = i+1){
+		workers[i].batch = batch;
+		workers[i].env = env;
+		workers[i].workspace = (char*) GurobifyScratch(workspace_size);
+	}
+	for (i = 0; i < number_of_threads && number_of_threads > 1; i = i+1){
+		envs[i] = GurobifyThreadEnv(env);
+		workers[i].env = envs[i];
+		if (envs[i] == NULL)
+			return GRB_ERROR_OUT_OF_MEMORY;
+	}
+
+	pthread_mutex_init(&batch->lock, NULL);
+	current_active_gurobi_batch = batch->models;
+	current_active_gurobi_batch_size = batch->number_of_models;
+	void (*current_signal_handler)(int);
+	current_signal_handler = signal(SIGINT,gurobify_signal_handler);
+	if (number_of_threads <= 1)
+		GurobifyComponentWorkerMain(&workers[0]);
+	else{
+		for (i = 0; i < number_of_threads; i = i+1)
+			pthread_create(&threads[i], NULL, GurobifyComponentWorkerMain, &workers[i]);
+		for (i = 0; i < number_of_threads; i = i+1)
+			pthread_join(threads[i], NULL);
+	}
+	signal(SIGINT,current_signal_handler);
+	current_active_gurobi_batch = NULL;
+	current_active_gurobi_batch_size = 0;
+	pthread_mutex_destroy(&batch->lock);
+	return batch->error;
+}
+
+/*
+This function is not documented.
+
+	Solves each component of a model as a separate model, using up to Threads threads, and merges
+	the results. Returns a record with components status, objective, solution and statuses, see
+	GurobiOptimiseComponents. The model itself is unchanged.
+*/
+
+Obj GUROBIOPTIMISECOMPONENTS(Obj self, Obj GAPmodel, Obj Threads)
+{
+	int i, k;
+	int error;
+	int status;
+	int optimstatus;
+	double objective;
+	double value;
+	GurobifyComponents components;
+
+	if (! IS_MODEL(GAPmodel))
+        ErrorMayQuit( "Error: Must pass a valid Gurobi model", 0, 0 );
+	if (! IS_INTOBJ(Threads) || INT_INTOBJ(Threads) < 1)
+		ErrorMayQuit( "Error: Threads must be a positive integer.", 0, 0 );
+
+	GRBmodel *model = GET_MODEL_READ(GAPmodel);
+	if (GUROBIFY_TIMED(GurobifyFindComponents(model, &components)))
+		ErrorMayQuit( "Error: Unable to find the components of the model.", 0, 0 );
+	if (GRBgetdblattr(model, "ObjCon", &objective))
+		objective = 0;
+
+	GurobifyComponentBatch batch;
+	batch.components = &components;
+	batch.number_of_models = components.number_of_components;
+	batch.next_model = 0;
+	batch.error = 0;
+	batch.models = (GRBmodel**) GurobifyScratch((components.number_of_components + 1)*sizeof(GRBmodel*));
+	memset(batch.models, 0, (components.number_of_components + 1)*sizeof(GRBmodel*));
+	double *solution = (double*) GurobifyScratch((components.number_of_variables + 1)*sizeof(double));
+	int *statuses = (int*) GurobifyScratch((components.number_of_components + 1)*sizeof(int));
+	int number_of_threads = INT_INTOBJ(Threads);
+	if (number_of_threads > components.number_of_components)
+		number_of_threads = components.number_of_components;
+	GRBenv **envs = (GRBenv**) GurobifyScratch((number_of_threads + 1)*sizeof(GRBenv*));
+	memset(envs, 0, (number_of_threads + 1)*sizeof(GRBenv*));
+	error = GUROBIFY_TIMED(GurobifySolveComponentBatch(&batch, GRBgetenv(model), envs, number_of_threads));
+
+	// The model is infeasible if any component is, and otherwise optimal only if every component is.
+	status = GRB_OPTIMAL;
+	for (k = 0; k < components.number_of_components && ! error; k = k+1){
+		error = GRBgetintattr(batch.models[k], "Status", &optimstatus);
+		if (error)
+			break;
+		statuses[k] = optimstatus;
+		if (optimstatus == GRB_INFEASIBLE || (optimstatus != GRB_OPTIMAL && status == GRB_OPTIMAL))
+			status = optimstatus;
+		if (optimstatus != GRB_OPTIMAL)
+			continue;
+		if (GRBgetdblattr(batch.models[k], "ObjVal", &value) == 0)
+			objective = objective + value;
+		for (i = components.variable_begin[k]; i < components.variable_begin[k+1] && ! error; i = i+1)
+			error = GRBgetdblattrelement(batch.models[k], "X", i - components.variable_begin[k],
+						&solution[components.variables[i]]);
+	}
+
+	for (k = 0; k < components.number_of_components; k = k+1)
+		if (batch.models[k] != NULL)
+			GRBfreemodel(batch.models[k]);
+	for (i = 0; i < number_of_threads; i = i+1)
+		if (envs[i] != NULL)
+			GRBfreeenv(envs[i]);
+
+	Obj result = NEW_PREC(4);
+	if (! error){
+		AssPRec(result, RNamName("status"), INTOBJ_INT(status));
+		Obj component_statuses = NEW_PLIST(T_PLIST, components.number_of_components);
+		for (k = 0; k < components.number_of_components; k = k+1)
+			ASS_LIST(component_statuses, k+1, INTOBJ_INT(statuses[k]));
+		AssPRec(result, RNamName("statuses"), component_statuses);
+		if (status == GRB_OPTIMAL){
+			AssPRec(result, RNamName("objective"), NEW_MACFLOAT(objective));
+			GurobifyCountBytes(components.number_of_variables*sizeof(double));
+			Obj values = NEW_PLIST(T_PLIST, components.number_of_variables);
+			for (i = 0; i < components.number_of_variables; i = i+1)
+				ASS_LIST(values, i+1, NEW_MACFLOAT(solution[i]));
+			AssPRec(result, RNamName("solution"), values);
+		}
+		else {
+			AssPRec(result, RNamName("objective"), Fail);
+			AssPRec(result, RNamName("solution"), Fail);
+		}
+	}
+	if (error)
+		ErrorMayQuit( "Error: Unable to optimise the components of the model.", 0, 0 );
+
+	return result;
+}
+
+/*
+	Checkpoint files of enumerations, see GurobiFindAllBinarySolutions. The first line is a header
+	giving the number of variables and the size of the solutions, and each following line lists the
+	indices of the variables which are 1 in one solution. Solutions are only ever appended, so a file
+	interrupted while being written at most ends in an incomplete line, which is ignored when reading
+	and cut off before the next write.
+*/
+
+#define GUROBIFY_CHECKPOINT_HEADER "# Gurobify checkpoint, variables: %d, size: %d\n"
+
+/*
+	Returns the length of the complete lines at the start of a checkpoint file, that is, the position after its last
+	newline, or -1 if the file cannot be read. Anything after it was left by an interrupted write.
+	The file is searched backwards from its end, so that appending to a large file stays cheap.
+*/
+
+static long GurobifyCompleteLength(FILE *file)
+{
+	char buffer[4096];
+	long end, start;
+	size_t length, i;
+
+	if (fseek(file, 0, SEEK_END) != 0 || (end = ftell(file)) < 0)
+		return -1;
+	while (end > 0){
+		start = end > (long) sizeof(buffer) ? end - (long) sizeof(buffer) : 0;
+		length = (size_t) (end - start);
+		if (fseek(file, start, SEEK_SET) != 0 || fread(buffer, 1, length, file) != length)
+			return -1;
+		for (i = length; i > 0; i = i-1)
+			if (buffer[i-1] == '\n')
+				return start + (long) i;
+		end = start;
+	}
+	return 0;
+}
+
+/*
+	Checks that the header of a checkpoint file, which is the first line of the given length, belongs to solutions
+	of the given size of a model with the given number of variables.
+*/
+
+static int GurobifyCheckpointMatches(char *line, ssize_t length, int number_of_variables, int size)
+{
+	int header_variables, header_size;
+	return length > 0 && line[length-1] == '\n'
+			&& sscanf(line, GUROBIFY_CHECKPOINT_HEADER, &header_variables, &header_size) == 2
+			&& header_variables == number_of_variables && header_size == size;
+}
+
+/*
+	#! @Chapter Using Gurobify
+	#! @Section Additional Functionality
+	#! @Arguments FileName, NumberOfVariables, Size, Solutions
+	#! @Returns true
+	#! @Description
+	#!	Appends a list of solutions of a model with binary variables to a checkpoint file, creating it if necessary.
+	#!	Each solution is a list of 0s and 1s of length NumberOfVariables with Size 1s, and is stored as the set of
+	#!	indices of its 1s. The number of variables and the size are recorded in the file, and appending to a file
+	#!	recorded for other values is an error. An incomplete last line, left by a write which was interrupted, is
+	#!	removed before appending. The file is flushed to disk before returning, so that the solutions survive a crash.
+	#!	See GurobiReadCheckpoint.
+	DeclareGlobalFunction("GurobiWriteCheckpoint");
+*/
+
+Obj GurobiWriteCheckpoint(Obj self, Obj FileName, Obj NumberOfVariables, Obj Size, Obj Solutions)
+{
+	int i, j, count;
+	int number_of_variables, size;
+	int error = 0;
+	long complete;
+	char *line = NULL;
+	size_t line_capacity = 0;
+
+	if (! IS_STRING(FileName))
+        ErrorMayQuit( "Error: FileName must be a string.", 0, 0 );
+	if (! IS_INTOBJ(NumberOfVariables) || INT_INTOBJ(NumberOfVariables) < 0)
+        ErrorMayQuit( "Error: NumberOfVariables must be a non-negative integer.", 0, 0 );
+	if (! IS_INTOBJ(Size) || INT_INTOBJ(Size) < 0)
+        ErrorMayQuit( "Error: Size must be a non-negative integer.", 0, 0 );
+	if (! IS_SMALL_LIST(Solutions))
+        ErrorMayQuit( "Error: Solutions must be a list of solutions.", 0, 0 );
+
+	number_of_variables = INT_INTOBJ(NumberOfVariables);
+	size = INT_INTOBJ(Size);
+	for (i = 1; i <= LEN_LIST(Solutions); i = i+1){
+		Obj solution = ELM_LIST(Solutions, i);
+		if (! IS_SMALL_LIST(solution) || LEN_LIST(solution) != number_of_variables)
+	        ErrorMayQuit( "Error: each solution must be a list of length NumberOfVariables.", 0, 0 );
+		count = 0;
+		for (j = 1; j <= number_of_variables; j = j+1){
+			Obj value = ELM_LIST(solution, j);
+			if (! (value == INTOBJ_INT(0) || (IS_MACFLOAT(value) && VAL_MACFLOAT(value) < 0.5)))
+				count = count + 1;
+		}
+		if (count != size)
+	        ErrorMayQuit( "Error: each solution must have Size entries equal to 1.", 0, 0 );
+	}
+
+	FILE *file = fopen(CSTR_STRING(FileName), "r+");
+	if (file == NULL)
+		file = fopen(CSTR_STRING(FileName), "w+");
+	if (file == NULL)
+        ErrorMayQuit( "Error: Unable to open the checkpoint file.", 0, 0 );
+
+	// Appending to an incomplete line would join it to the next solution, so it is cut off first.
+	complete = GurobifyCompleteLength(file);
+	if (complete < 0){
+		fclose(file);
+        ErrorMayQuit( "Error: Unable to read the checkpoint file.", 0, 0 );
+	}
+	if (complete > 0){
+		rewind(file);
+		ssize_t length = getline(&line, &line_capacity, file);
+		int matches = GurobifyCheckpointMatches(line, length, number_of_variables, size);
+		free(line);
+		if (! matches){
+			fclose(file);
+	        ErrorMayQuit( "Error: The checkpoint file does not belong to solutions of this size of a model with this number of variables.", 0, 0 );
+		}
+	}
+	fflush(file);
+	error = ftruncate(fileno(file), complete) != 0 || fseek(file, complete, SEEK_SET) != 0;
+	if (complete == 0 && ! error)
+		error = fprintf(file, GUROBIFY_CHECKPOINT_HEADER, number_of_variables, size) < 0;
+
+	for (i = 1; i <= LEN_LIST(Solutions) && ! error; i = i+1){
+		Obj solution = ELM_LIST(Solutions, i);
+		int first = 1;
+		for (j = 1; j <= number_of_variables && ! error; j = j+1){
+			Obj value = ELM_LIST(solution, j);
+			if (value == INTOBJ_INT(0) || (IS_MACFLOAT(value) && VAL_MACFLOAT(value) < 0.5))
+				continue;
+			error = fprintf(file, first ? "%d" : " %d", j) < 0;
+			first = 0;
+		}
+		if (! error)
+			error = fputc('\n', file) == EOF;
+	}
+	if (! error)
+		error = fflush(file) != 0 || fsync(fileno(file)) != 0;
+	if (fclose(file) != 0)
+		error = 1;
+	if (error)
+        ErrorMayQuit( "Error: Unable to write the checkpoint file.", 0, 0 );
+
+	return True;
+}
+
+/*
+	Reads the solutions of a checkpoint file, as GurobiReadCheckpoint does, without raising errors so that the caller
+	can clean up first. Returns Fail if the file does not exist, or 0 with an error message in messageP if the
+	file does not match or is corrupt.
+*/
+
+static Obj GurobifyReadCheckpointFile(const char *file_name, int number_of_variables, int size, const char **messageP)
+{
+	int j, count;
+	char *line = NULL;
+	size_t line_capacity = 0;
+	ssize_t length;
+
+	FILE *file = fopen(file_name, "r");
+	if (file == NULL)
+		return Fail;
+	Obj solutions = NEW_PLIST(T_PLIST, 0);
+	length = getline(&line, &line_capacity, file);
+	// A file without a complete header holds no solutions yet.
+	if (length <= 0 || line[length-1] != '\n'){
+		free(line);
+		fclose(file);
+		return solutions;
+	}
+	if (! GurobifyCheckpointMatches(line, length, number_of_variables, size)){
+		free(line);
+		fclose(file);
+		*messageP = "Error: The checkpoint file does not belong to solutions of this size of a model with this number of variables.";
+		return 0;
+	}
+
+	*messageP = "Error: The checkpoint file is corrupt.";
+	while ((length = getline(&line, &line_capacity, file)) > 0){
+		if (line[length-1] != '\n')
+			break;
+		Obj solution = NEW_PLIST(T_PLIST, number_of_variables);
+		for (j = 1; j <= number_of_variables; j = j+1)
+			ASS_LIST(solution, j, INTOBJ_INT(0));
+		char *position = line;
+		char *end;
+		long index;
+		count = 0;
+		while ((index = strtol(position, &end, 10)), end != position){
+			if (index < 1 || index > number_of_variables){
+				free(line);
+				fclose(file);
+				return 0;
+			}
+			ASS_LIST(solution, index, INTOBJ_INT(1));
+			count = count + 1;
+			position = end;
+		}
+		if (count != size){
+			free(line);
+			fclose(file);
+			return 0;
+		}
+		ASS_LIST(solutions, LEN_LIST(solutions)+1, solution);
+	}
+	free(line);
+	fclose(file);
+
+	return solutions;
+}
+
+/*
+	#! @Chapter Using Gurobify
+	#! @Section Additional Functionality
+	#! @Arguments FileName, NumberOfVariables, Size
+	#! @Returns list of solutions or fail
+	#! @Description
+	#!	Reads the solutions stored in a checkpoint file by GurobiWriteCheckpoint, as lists of 0s and 1s of length
+	#!	NumberOfVariables. Returns fail if the file does not exist. It is an error if the file was written for a
+	#!	different number of variables or solutions of a different Size. An incomplete last line, left by an
+	#!	interrupted write, is ignored.
+	DeclareGlobalFunction("GurobiReadCheckpoint");
+*/
+
+Obj GurobiReadCheckpoint(Obj self, Obj FileName, Obj NumberOfVariables, Obj Size)
+{
+	const char *message;
+
+	if (! IS_STRING(FileName))
+        ErrorMayQuit( "Error: FileName must be a string.", 0, 0 );
+	if (! IS_INTOBJ(NumberOfVariables) || INT_INTOBJ(NumberOfVariables) < 0)
+        ErrorMayQuit( "Error: NumberOfVariables must be a non-negative integer.", 0, 0 );
+	if (! IS_INTOBJ(Size) || INT_INTOBJ(Size) < 0)
+        ErrorMayQuit( "Error: Size must be a non-negative integer.", 0, 0 );
+
+	Obj solutions = GurobifyReadCheckpointFile(CSTR_STRING(FileName), INT_INTOBJ(NumberOfVariables), INT_INTOBJ(Size), &message);
+	if (solutions == 0)
+        ErrorMayQuit( message, 0, 0 );
+
+	return solutions;
+}
+
+/*
+	Partitioned enumeration of binary solutions in worker processes, see GurobiFindAllBinarySolutions.
+	The solutions are split into cubes by fixing the prefix variables to each of their combinations of values.
+	Every worker is a forked process with its own environment and its own copy of the model, read from a
+	temporary MPS file, and repeatedly takes the next cube from a counter in shared memory, so that workers
+	which finish their cubes early keep taking more. Each worker appends its solutions to its own checkpoint file.
+
+	The workers only use the Gurobi library and the C library, never GAP, and leave with _exit. They run in a process
+	group of their own, so that ctrl+C only reaches GAP, whose handler they would otherwise have inherited. Once a worker
+	fails or reaches the time limit, or GAP is interrupted, the abort flag in shared memory stops the workers from taking
+	further cubes, and the remaining workers are killed.
+*/
+
+#define GUROBIFY_CUBES_OK 0
+#define GUROBIFY_CUBES_FAILED 1
+#define GUROBIFY_CUBES_TIMED_OUT 2
+
+typedef struct {
+	int next_cube;
+	volatile int abort;         // 1 after a worker failed or timed out, 2 after an interrupt
+} GurobifyCubeState;
+
+static int GurobifyCubeWorker(const char *directory, int worker, int size, int number_of_prefix_variables,
+		int *prefix, GurobifyCubeState *state)
+{
+	char file_name[GRB_MAX_STRLEN + 64];
+	GRBenv *worker_env = NULL;
+	GRBmodel *model = NULL;
+	FILE *file;
+	int number_of_variables, number_of_cubes, cube, status, optimisation_status, number_of_ones;
+	int i, j, error;
+	double *solution, *ones, *lb, *ub;
+	int *indices;
+
+	snprintf(file_name, sizeof(file_name), "%s/worker%d.txt", directory, worker);
+	file = fopen(file_name, "w");
+	if (file == NULL)
+		return GUROBIFY_CUBES_FAILED;
+
+	error = GRBloadenv(&worker_env, NULL);
+	snprintf(file_name, sizeof(file_name), "%s/model.prm", directory);
+	if (! error)
+		error = GRBreadparams(worker_env, file_name);
+	// The workers share the cores, so each solves with a single thread.
+	if (! error)
+		error = GRBsetintparam(worker_env, "Threads", 1);
+	if (! error)
+		error = GRBsetintparam(worker_env, "OutputFlag", 0);
+	snprintf(file_name, sizeof(file_name), "%s/model.mps", directory);
+	if (! error)
+		error = GRBreadmodel(worker_env, file_name, &model);
+	if (! error)
+		error = GRBgetintattr(model, "NumVars", &number_of_variables);
+	if (error){
+		fclose(file);
+		return GUROBIFY_CUBES_FAILED;
+	}
+
+	solution = (double*) malloc((number_of_variables + 1)*sizeof(double));
+	ones = (double*) malloc((number_of_variables + 1)*sizeof(double));
+	indices = (int*) malloc((number_of_variables + 1)*sizeof(int));
+	lb = (double*) malloc((number_of_prefix_variables + 1)*sizeof(double));
+	ub = (double*) malloc((number_of_prefix_variables + 1)*sizeof(double));
+	error = solution == NULL || ones == NULL || indices == NULL || lb == NULL || ub == NULL;
+	for (i = 0; i < number_of_variables && ! error; i = i+1)
+		ones[i] = 1.0;
+	for (j = 0; j < number_of_prefix_variables && ! error; j = j+1){
+		error = GRBgetdblattrelement(model, "LB", prefix[j], &lb[j]);
+		if (! error)
+			error = GRBgetdblattrelement(model, "UB", prefix[j], &ub[j]);
+	}
+	error = error || fprintf(file, GUROBIFY_CHECKPOINT_HEADER, number_of_variables, size) < 0;
+
+	status = error ? GUROBIFY_CUBES_FAILED : GUROBIFY_CUBES_OK;
+	number_of_cubes = 1 << number_of_prefix_variables;
+	while (status == GUROBIFY_CUBES_OK && ! state->abort && (cube = __sync_fetch_and_add(&state->next_cube, 1)) < number_of_cubes){
+		for (j = 0; j < number_of_prefix_variables && ! error; j = j+1)
+			error = GRBsetdblattrelement(model, "LB", prefix[j], (cube >> j) & 1)
+					|| GRBsetdblattrelement(model, "UB", prefix[j], (cube >> j) & 1);
+		// Find all solutions of the cube, excluding each one as in the sequential enumeration.
+		while (! error){
+			error = GRBoptimize(model);
+			if (! error)
+				error = GRBgetintattr(model, "Status", &optimisation_status);
+			if (error || optimisation_status != GRB_OPTIMAL)
+				break;
+			error = GRBgetdblattrarray(model, "X", 0, number_of_variables, solution);
+			number_of_ones = 0;
+			for (i = 0; i < number_of_variables && ! error; i = i+1)
+				if (solution[i] > 0.5){
+					error = fprintf(file, number_of_ones == 0 ? "%d" : " %d", i+1) < 0;
+					indices[number_of_ones] = i;
+					number_of_ones = number_of_ones + 1;
+				}
+			if (! error)
+				error = fputc('\n', file) == EOF;
+			if (! error)
+				error = GRBaddconstr(model, number_of_ones, indices, ones, GRB_LESS_EQUAL, number_of_ones - 1, NULL);
+		}
+		if (error)
+			status = GUROBIFY_CUBES_FAILED;
+		else if (optimisation_status == GRB_TIME_LIMIT)
+			status = GUROBIFY_CUBES_TIMED_OUT;
+		else if (optimisation_status == GRB_INFEASIBLE)
+			status = GUROBIFY_CUBES_OK;
+		else
+			status = GUROBIFY_CUBES_FAILED;
+		for (j = 0; j < number_of_prefix_variables && ! error; j = j+1)
+			error = GRBsetdblattrelement(model, "LB", prefix[j], lb[j])
+					|| GRBsetdblattrelement(model, "UB", prefix[j], ub[j]);
+	}
+
+	if (fclose(file) != 0)
+		status = GUROBIFY_CUBES_FAILED;
+	if (status != GUROBIFY_CUBES_OK)
+		state->abort = 1;
+	free(solution);
+	free(ones);
+	free(indices);
+	free(lb);
+	free(ub);
+	GRBfreemodel(model);
+	GRBfreeenv(worker_env);
+	return status;
+}
+
+/*
+This function is not documented.
+
+	Finds all solutions of a model with binary variables, which have Size 1s, in Workers worker processes, splitting
+	the solutions into cubes by the values of the variables in Prefix. Returns the list of solutions, in no particular order, or fail if
+	a worker reached the time limit.
+*/
+
+Obj GUROBIENUMERATECUBES(Obj self, Obj GAPmodel, Obj Prefix, Obj Size, Obj Workers)
+{
+	char directory[] = "/tmp/gurobifyXXXXXX";
+	char file_name[sizeof(directory) + 64];
+	GRBmodel *model;
+	int number_of_variables, number_of_prefix_variables, number_of_workers;
+	int i, j, error, status, worker_status, remaining, interrupted;
+	int *prefix;
+	GurobifyCubeState *state;
+	pid_t *workers;
+	pid_t group, worker;
+	const char *message;
+
+	if (! IS_MODEL(GAPmodel))
+		ErrorMayQuit( "Error: Must pass a valid Gurobi model", 0, 0 );
+	if (! IS_INTOBJ(Size) || INT_INTOBJ(Size) < 0)
+		ErrorMayQuit( "Error: Size must be a non-negative integer.", 0, 0 );
+	if (! IS_INTOBJ(Workers) || INT_INTOBJ(Workers) < 1)
+		ErrorMayQuit( "Error: Workers must be a positive integer.", 0, 0 );
+
+	model = GET_MODEL(GAPmodel);
+	error = GUROBIFY_TIMED(GRBupdatemodel(model));
+	if (! error)
+		error = GRBgetintattr(model, "NumVars", &number_of_variables);
+	if (error)
+		ErrorMayQuit( "Error: Unable to update model.", 0, 0 );
+
+	prefix = GurobifyGetVariables(Prefix, number_of_variables, &number_of_prefix_variables);
+	if (number_of_prefix_variables > 20)
+		ErrorMayQuit( "Error: at most 20 prefix variables are supported.", 0, 0 );
+
+	if (mkdtemp(directory) == NULL)
+		ErrorMayQuit( "Error: Unable to create a temporary directory.", 0, 0 );
+	snprintf(file_name, sizeof(file_name), "%s/model.mps", directory);
+	error = GUROBIFY_TIMED(GRBwrite(model, file_name));
+	snprintf(file_name, sizeof(file_name), "%s/model.prm", directory);
+	if (! error)
+		error = GUROBIFY_TIMED(GRBwrite(model, file_name));
+
+	state = (GurobifyCubeState*) mmap(NULL, sizeof(GurobifyCubeState), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if (state == MAP_FAILED)
+		error = 1;
+	else{
+		state->next_cube = 0;
+		state->abort = 0;
+	}
+
+	// The workers join the process group of the first one. Both sides set it, whichever runs first.
+	number_of_workers = INT_INTOBJ(Workers);
+	workers = (pid_t*) GurobifyScratch(number_of_workers*sizeof(pid_t));
+	group = 0;
+	for (i = 0; i < number_of_workers && ! error; i = i+1){
+		fflush(NULL);
+		workers[i] = fork();
+		if (workers[i] == 0){
+			setpgid(0, group);
+			signal(SIGINT, SIG_IGN);
+			signal(SIGTERM, SIG_DFL);
+			_exit(GurobifyCubeWorker(directory, i, INT_INTOBJ(Size), number_of_prefix_variables, prefix, state));
+		}
+		if (workers[i] < 0){
+			number_of_workers = i;
+			error = 1;
+		}
+		else{
+			setpgid(workers[i], group);
+			if (group == 0)
+				group = workers[i];
+		}
+	}
+
+	// Wait for the workers in the order they finish, killing the others as soon as one of them fails.
+	status = error ? GUROBIFY_CUBES_FAILED : GUROBIFY_CUBES_OK;
+	if (group > 0){
+		current_active_cube_workers = group;
+		current_active_cube_abort = &state->abort;
+		void (*current_signal_handler)(int);
+		current_signal_handler = signal(SIGINT,gurobify_signal_handler);
+		if (error){
+			state->abort = 1;
+			kill(-group, SIGTERM);
+		}
+		remaining = number_of_workers;
+		while (remaining > 0){
+			worker = waitpid(-group, &worker_status, 0);
+			if (worker < 0){
+				if (errno == EINTR)
+					continue;
+				status = GUROBIFY_CUBES_FAILED;
+				break;
+			}
+			remaining = remaining - 1;
+			if (! WIFEXITED(worker_status))
+				status = GUROBIFY_CUBES_FAILED;
+			else if (WEXITSTATUS(worker_status) != GUROBIFY_CUBES_OK && status != GUROBIFY_CUBES_FAILED)
+				status = WEXITSTATUS(worker_status);
+			if (status != GUROBIFY_CUBES_OK && remaining > 0){
+				if (! state->abort)
+					state->abort = 1;
+				kill(-group, SIGTERM);
+			}
+		}
+		signal(SIGINT,current_signal_handler);
+		current_active_cube_workers = 0;
+		current_active_cube_abort = NULL;
+	}
+	interrupted = (state != MAP_FAILED && state->abort == 2);
+	if (state != MAP_FAILED)
+		munmap(state, sizeof(GurobifyCubeState));
+
+	Obj solutions = NEW_PLIST(T_PLIST, 0);
+	for (i = 0; i < number_of_workers; i = i+1){
+		snprintf(file_name, sizeof(file_name), "%s/worker%d.txt", directory, i);
+		// The files are read without raising errors, so that the temporary directory is always removed.
+		if (status == GUROBIFY_CUBES_OK){
+			Obj found = GurobifyReadCheckpointFile(file_name, number_of_variables, INT_INTOBJ(Size), &message);
+			if (found == 0 || found == Fail)
+				status = GUROBIFY_CUBES_FAILED;
+			else
+				for (j = 1; j <= LEN_LIST(found); j = j+1)
+					ASS_LIST(solutions, LEN_LIST(solutions)+1, ELM_LIST(found, j));
+		}
+		unlink(file_name);
+	}
+	snprintf(file_name, sizeof(file_name), "%s/model.mps", directory);
+	unlink(file_name);
+	snprintf(file_name, sizeof(file_name), "%s/model.prm", directory);
+	unlink(file_name);
+	rmdir(directory);
+
+	if (interrupted)
+		ErrorMayQuit( "Error: The enumeration was interrupted.", 0, 0 );
+	if (status == GUROBIFY_CUBES_TIMED_OUT)
+		return Fail;
+	if (status != GUROBIFY_CUBES_OK)
+		ErrorMayQuit( "Error: Unable to enumerate the solutions in worker processes.", 0, 0 );
+
+	return solutions;
+}
+
+/*
+	Reads the constraint matrix of a model by rows into the data of the object, unless it is already cached there.
+	Returns a Gurobi error code.
+*/
+
+static int GurobifyCacheMatrix(Obj GAPmodel, GurobifyModelData *data)
+{
+	GRBmodel *model;
+	int number_of_nonzeros;
+	int error;
+
+	if (data->matrix_valid && ! data->matrix_pending)
+		return 0;
+	if (data->matrix_valid)
+		GurobifyFreeMatrix(data);
+	model = GET_MODEL_READ(GAPmodel);
+	error = GRBgetintattr(model, "NumConstrs", &data->matrix_rows);
+	if (! error)
+		error = GRBgetintattr(model, "NumVars", &data->matrix_columns);
+	if (! error)
+		error = GRBgetintattr(model, "NumNZs", &number_of_nonzeros);
+	if (error)
+		return error;
+
+	data->matrix_begin = (int*) malloc((data->matrix_rows + 1)*sizeof(int));
+	data->matrix_indices = (int*) malloc((number_of_nonzeros + 1)*sizeof(int));
+	data->matrix_values = (double*) malloc((number_of_nonzeros + 1)*sizeof(double));
+	data->matrix_sense = (char*) malloc(data->matrix_rows + 1);
+	data->matrix_rhs = (double*) malloc((data->matrix_rows + 1)*sizeof(double));
+	if (data->matrix_begin == NULL || data->matrix_indices == NULL || data->matrix_values == NULL
+			|| data->matrix_sense == NULL || data->matrix_rhs == NULL)
+		error = GRB_ERROR_OUT_OF_MEMORY;
+	if (! error && data->matrix_rows > 0)
+		error = GRBgetconstrs(model, &number_of_nonzeros, data->matrix_begin, data->matrix_indices, data->matrix_values,
+					0, data->matrix_rows);
+	if (! error && data->matrix_rows > 0)
+		error = GRBgetcharattrarray(model, "Sense", 0, data->matrix_rows, data->matrix_sense);
+	if (! error && data->matrix_rows > 0)
+		error = GRBgetdblattrarray(model, "RHS", 0, data->matrix_rows, data->matrix_rhs);
+	if (error){
+		GurobifyFreeMatrix(data);
+		return error;
+	}
+	data->matrix_begin[data->matrix_rows] = number_of_nonzeros;
+	data->matrix_valid = 1;
+	GurobifyCountBytes(number_of_nonzeros*(sizeof(int) + sizeof(double)));
+	return 0;
+}
+
+/* A batch of candidate solutions checked by GUROBICHECKSOLUTIONS, split between threads */
+
+typedef struct {
+	GurobifyModelData *data;
+	double *candidates;
+	int number_of_candidates;
+	int *violated;
+	double tolerance;
+	int number_of_threads;
+	int thread;
+} GurobifyCheckBatch;
+
+static void *GurobifyCheckWorkerMain(void *arg)
+{
+	GurobifyCheckBatch *batch = (GurobifyCheckBatch*) arg;
+	GurobifyModelData *data = batch->data;
+	int c, r, j;
+	double activity;
+	double *x;
+
+	for (c = batch->thread; c < batch->number_of_candidates; c = c + batch->number_of_threads){
+		x = batch->candidates + (size_t) c * data->matrix_columns;
+		batch->violated[c] = -1;
+		for (r = 0; r < data->matrix_rows; r = r+1){
+			activity = 0;
+			for (j = data->matrix_begin[r]; j < data->matrix_begin[r+1]; j = j+1)
+				activity = activity + data->matrix_values[j] * x[data->matrix_indices[j]];
+			if ((data->matrix_sense[r] != GRB_GREATER_EQUAL && activity > data->matrix_rhs[r] + batch->tolerance)
+					|| (data->matrix_sense[r] != GRB_LESS_EQUAL && activity < data->matrix_rhs[r] - batch->tolerance)){
+				batch->violated[c] = r;
+				break;
+			}
+		}
+	}
+	return NULL;
+}
+
+/*
+This function is not documented.
+
+	Checks the list Candidates of candidate solutions against the constraints of a model, using Threads threads.
+	Returns rec(feasible, violated), see GurobiCheckSolutions.
+*/
+
+Obj GUROBICHECKSOLUTIONS(Obj self, Obj GAPmodel, Obj Candidates, Obj Threads)
+{
+	GurobifyModelData *data;
+	GurobifyCheckBatch *batches;
+	pthread_t *threads;
+	double *candidates;
+	double tolerance;
+	int number_of_candidates, number_of_threads;
+	int i, j, error;
+	Obj candidate;
+
+	if (! IS_MODEL(GAPmodel))
+		ErrorMayQuit( "Error: Must pass a valid Gurobi model", 0, 0 );
+	if (! IS_SMALL_LIST(Candidates))
+		ErrorMayQuit( "Error: Candidates must be a list of lists of values.", 0, 0 );
+	if (! IS_INTOBJ(Threads) || INT_INTOBJ(Threads) < 1)
+		ErrorMayQuit( "Error: Threads must be a positive integer.", 0, 0 );
+
+	data = GET_OR_NEW_DATA(GAPmodel);
+	error = GurobifyCacheMatrix(GAPmodel, data);
+	if (! error)
+		error = GRBgetdblparam(GRBgetenv(GET_MODEL_READ(GAPmodel)), "FeasibilityTol", &tolerance);
+	if (error)
+		ErrorMayQuit( "Error: Unable to read the constraints of the model.", 0, 0 );
+
+	// The candidates are packed into one array, one row of values for each.
+	number_of_candidates = LEN_LIST(Candidates);
+	candidates = (double*) GurobifyScratch(((size_t) number_of_candidates * data->matrix_columns + 1)*sizeof(double));
+	for (i = 0; i < number_of_candidates; i = i+1){
+		candidate = ELM_LIST(Candidates, i+1);
+		if (! IS_SMALL_LIST(candidate) || LEN_LIST(candidate) != data->matrix_columns)
+			ErrorMayQuit( "Error: each candidate must have one value for each variable.", 0, 0 );
+		for (j = 0; j < data->matrix_columns; j = j+1)
+			if (! GurobifyGetDouble(ELM_LIST(candidate, j+1), &candidates[(size_t) i * data->matrix_columns + j]))
+				ErrorMayQuit( "Error: the values of the candidates must be integers or floats.", 0, 0 );
+	}
+	GurobifyCountBytes((size_t) number_of_candidates * data->matrix_columns * sizeof(double));
+
+	number_of_threads = INT_INTOBJ(Threads);
+	if (number_of_threads > number_of_candidates)
+		number_of_threads = (number_of_candidates > 0) ? number_of_candidates : 1;
+	int *violated = (int*) GurobifyScratch((number_of_candidates + 1)*sizeof(int));
+	batches = (GurobifyCheckBatch*) GurobifyScratch(number_of_threads*sizeof(GurobifyCheckBatch));
+	threads = (pthread_t*) GurobifyScratch(number_of_threads*sizeof(pthread_t));
+	for (i = 0; i < number_of_threads; i = i+1){
+		batches[i].data = data;
+		batches[i].candidates = candidates;
+		batches[i].number_of_candidates = number_of_candidates;
+		batches[i].violated = violated;
+		batches[i].tolerance = tolerance;
+		batches[i].number_of_threads = number_of_threads;
+		batches[i].thread = i;
+	}
+	// The main thread checks its own share of the candidates.
+	for (i = 1; i < number_of_threads; i = i+1)
+		pthread_create(&threads[i], NULL, GurobifyCheckWorkerMain, &batches[i]);
+	GurobifyCheckWorkerMain(&batches[0]);
+	for (i = 1; i < number_of_threads; i = i+1)
+		pthread_join(threads[i], NULL);
+
+	Obj feasible = NEW_PLIST(T_PLIST, number_of_candidates);
+	Obj positions = NEW_PLIST(T_PLIST, number_of_candidates);
+	for (i = 0; i < number_of_candidates; i = i+1){
+		ASS_LIST(feasible, i+1, violated[i] < 0 ? True : False);
+		ASS_LIST(positions, i+1, violated[i] < 0 ? Fail : INTOBJ_INT(violated[i]));
+	}
+	Obj result = NEW_PREC(2);
+	AssPRec(result, RNamName("feasible"), feasible);
+	AssPRec(result, RNamName("violated"), positions);
+
+	return result;
+}
+
+/*
+	Kramer-Mesner models. The s-subsets of the points 0, ..., n-1 are numbered by their rank in the
+	colexicographic order, so that the set { a_1 < ... < a_s } has rank Binomial(a_1, 1) + ... + Binomial(a_s, s).
+	The orbits of the generators on the s-subsets are found with a union-find over these ranks.
+	Apart from the rows of the orbit incidence matrix, which are computed by worker threads, the
+	arrays are taken from the scratch arena.
+*/
+
+typedef struct {
+	int number_of_points;
+	int t;
+	int k;
+	int number_of_generators;
+	int *generators;            // the images of the points, 0-based, one block of number_of_points per generator
+	long long *binomial;        // binomial[a*(number_of_points+1) + b] is Binomial(a, b)
+	int number_of_t_orbits;
+	int number_of_k_orbits;
+	int *t_representatives;     // the rank of the smallest t-subset of each orbit
+	int *k_representatives;
+	int *k_orbit;               // the orbit of each k-subset
+	int *row_length;            // the rows of the orbit incidence matrix, one for each t-orbit
+	int **row_indices;
+	double **row_values;
+	int next_row;
+	pthread_mutex_t lock;
+} GurobifyKramerMesner;
+
+static long long GurobifyBinomial(GurobifyKramerMesner *km, int a, int b)
+{
+	if (b < 0 || b > a)
+		return 0;
+	return km->binomial[a*(km->number_of_points+1) + b];
+}
+
+static int GurobifySubsetRank(GurobifyKramerMesner *km, int *set, int size)
+{
+	int i;
+	long long rank = 0;
+	for (i = 0; i < size; i = i+1)
+		rank = rank + GurobifyBinomial(km, set[i], i+1);
+	return (int) rank;
+}
+
+static void GurobifySubsetUnrank(GurobifyKramerMesner *km, int rank, int *set, int size)
+{
+	int i, c;
+	c = km->number_of_points - 1;
+	for (i = size; i > 0; i = i-1){
+		while (GurobifyBinomial(km, c, i) > rank)
+			c = c-1;
+		set[i-1] = c;
+		rank = rank - (int) GurobifyBinomial(km, c, i);
+		c = c-1;
+	}
+}
+
+/* Sorts a short set of points by insertion */
+static void GurobifySortSubset(int *set, int size)
+{
+	int i, j, point;
+	for (i = 1; i < size; i = i+1){
+		point = set[i];
+		for (j = i; j > 0 && set[j-1] > point; j = j-1)
+			set[j] = set[j-1];
+		set[j] = point;
+	}
+}
+
+/* Moves set to the next s-subset in colexicographic order. Returns 0 after the last subset. */
+static int GurobifyNextSubset(int *set, int size, int number_of_points)
+{
+	int i, j;
+	for (i = 0; i < size; i = i+1){
+		if ((i+1 < size && set[i]+1 < set[i+1]) || (i+1 == size && set[i]+1 < number_of_points)){
+			set[i] = set[i]+1;
+			for (j = 0; j < i; j = j+1)
+				set[j] = j;
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/*
+	Returns the orbit of each s-subset, and stores the ranks of the smallest subset of each orbit in
+	*representatives.
+*/
+static int *GurobifySubsetOrbits(GurobifyKramerMesner *km, int size, int *number_of_orbits, int **representatives)
+{
+	int total = (int) GurobifyBinomial(km, km->number_of_points, size);
+	int *orbit = (int*) GurobifyScratch((total + 1)*sizeof(int));
+	int *set = (int*) GurobifyScratch((size + 1)*sizeof(int));
+	int *image = (int*) GurobifyScratch((size + 1)*sizeof(int));
+	int r, i, g, a, b;
+
+	GurobifyCountBytes(total*sizeof(int));
+
+	// Union-find in which every subset points to one of smaller rank, so that the root of a tree is its smallest subset.
+	for (r = 0; r < total; r = r+1)
+		orbit[r] = r;
+	for (i = 0; i < size; i = i+1)
+		set[i] = i;
+	r = 0;
+	do {
+		for (g = 0; g < km->number_of_generators; g = g+1){
+			for (i = 0; i < size; i = i+1)
+				image[i] = km->generators[g*km->number_of_points + set[i]];
+			GurobifySortSubset(image, size);
+			a = GurobifyFindRoot(orbit, r);
+			b = GurobifyFindRoot(orbit, GurobifySubsetRank(km, image, size));
+			if (a < b)
+				orbit[b] = a;
+			else if (b < a)
+				orbit[a] = b;
+		}
+		r = r+1;
+	} while (GurobifyNextSubset(set, size, km->number_of_points));
+
+	// Number the orbits in order of their smallest subsets. As parents have smaller ranks, each parent is final when read.
+	*number_of_orbits = 0;
+	for (r = 0; r < total; r = r+1){
+		if (orbit[r] == r){
+			orbit[r] = *number_of_orbits;
+			*number_of_orbits = *number_of_orbits + 1;
+		}
+		else
+			orbit[r] = orbit[orbit[r]];
+	}
+	*representatives = (int*) GurobifyScratch((*number_of_orbits + 1)*sizeof(int));
+	a = 0;
+	for (r = 0; r < total; r = r+1)
+		if (orbit[r] == a){
+			(*representatives)[a] = r;
+			a = a+1;
+		}
+	return orbit;
+}
+
+/* Counts, for the representative of t-orbit i, the k-subsets of each k-orbit containing it. Returns 0 if out of memory. */
+static int GurobifyKramerMesnerRow(GurobifyKramerMesner *km, int i, int *counts, int *touched)
+{
+	int n = km->number_of_points;
+	int t = km->t;
+	int k = km->k;
+	int *t_set = (int*) malloc((t + 1)*sizeof(int));
+	int *complement = (int*) malloc((n + 1)*sizeof(int));
+	int *choice = (int*) malloc((k - t + 1)*sizeof(int));
+	int *k_set = (int*) malloc((k + 1)*sizeof(int));
+	int a, b, j, c, number_touched, orbit;
+
+	if (t_set == NULL || complement == NULL || choice == NULL || k_set == NULL){
+		free(t_set);
+		free(complement);
+		free(choice);
+		free(k_set);
+		return 0;
+	}
+
+	GurobifySubsetUnrank(km, km->t_representatives[i], t_set, t);
+	c = 0;
+	a = 0;
+	for (j = 0; j < n; j = j+1){
+		if (a < t && t_set[a] == j)
+			a = a+1;
+		else{
+			complement[c] = j;
+			c = c+1;
+		}
+	}
+
+	number_touched = 0;
+	for (j = 0; j < k - t; j = j+1)
+		choice[j] = j;
+	do {
+		// Merge the representative with the chosen points of the complement
+		a = 0;
+		b = 0;
+		for (j = 0; j < k; j = j+1){
+			if (b == k - t || (a < t && t_set[a] < complement[choice[b]])){
+				k_set[j] = t_set[a];
+				a = a+1;
+			}
+			else{
+				k_set[j] = complement[choice[b]];
+				b = b+1;
+			}
+		}
+		orbit = km->k_orbit[GurobifySubsetRank(km, k_set, k)];
+		if (counts[orbit] == 0){
+			touched[number_touched] = orbit;
+			number_touched = number_touched + 1;
+		}
+		counts[orbit] = counts[orbit] + 1;
+	} while (GurobifyNextSubset(choice, k - t, n - t));
+
+	km->row_length[i] = number_touched;
+	km->row_indices[i] = (int*) malloc((number_touched + 1)*sizeof(int));
+	km->row_values[i] = (double*) malloc((number_touched + 1)*sizeof(double));
+	if (km->row_indices[i] != NULL && km->row_values[i] != NULL){
+		for (j = 0; j < number_touched; j = j+1){
+			km->row_indices[i][j] = touched[j];
+			km->row_values[i][j] = (double) counts[touched[j]];
+		}
+	}
+	for (j = 0; j < number_touched; j = j+1)
+		counts[touched[j]] = 0;
+
+	free(t_set);
+	free(complement);
+	free(choice);
+	free(k_set);
+	return km->row_indices[i] != NULL && km->row_values[i] != NULL;
+}
+
+static void *GurobifyKramerMesnerWorkerMain(void *arg)
+{
+	GurobifyKramerMesner *km = (GurobifyKramerMesner*) arg;
+	int *counts = (int*) calloc(km->number_of_k_orbits + 1, sizeof(int));
+	int *touched = (int*) malloc((km->number_of_k_orbits + 1)*sizeof(int));
+	int i;
+
+	while (counts != NULL && touched != NULL){
+		pthread_mutex_lock(&km->lock);
+		i = km->next_row;
+		km->next_row = km->next_row + 1;
+		pthread_mutex_unlock(&km->lock);
+		if (i >= km->number_of_t_orbits || ! GurobifyKramerMesnerRow(km, i, counts, touched))
+			break;
+	}
+	free(counts);
+	free(touched);
+	return NULL;
+}
+
+/* Frees the rows of the orbit incidence matrix */
+static void GurobifyFreeKramerMesner(GurobifyKramerMesner *km)
+{
+	int i;
+	if (km->row_indices != NULL)
+		for (i = 0; i < km->number_of_t_orbits; i = i+1){
+			free(km->row_indices[i]);
+			free(km->row_values[i]);
+			km->row_indices[i] = NULL;
+			km->row_values[i] = NULL;
+		}
+}
+
+/* Converts the ranks of orbit representatives into a GAP list of sets of points, starting from 1 */
+static Obj GurobifyRepresentativeList(GurobifyKramerMesner *km, int *representatives, int number_of_orbits, int size)
+{
+	int i, j;
+	int *set = (int*) GurobifyScratch((size + 1)*sizeof(int));
+	Obj result = NEW_PLIST(T_PLIST, number_of_orbits);
+	for (i = 0; i < number_of_orbits; i = i+1){
+		GurobifySubsetUnrank(km, representatives[i], set, size);
+		Obj points = NEW_PLIST(T_PLIST, size);
+		for (j = 0; j < size; j = j+1)
+			ASS_LIST(points, j+1, INTOBJ_INT(set[j] + 1));
+		ASS_LIST(result, i+1, points);
+	}
+	return result;
+}
+
+
+/*
+This function is not documented.
+
+	Builds the Kramer-Mesner model for t-designs with blocks of size k and index Lambda on the points
+	1, ..., NumberOfPoints, invariant under the group generated by Generators, which is a list of lists of
+	images of the points. Threads is the number of threads used for the orbit incidence matrix.
+	Returns rec(model, torbits, korbits), where torbits and korbits are the orbit representatives.
+*/
+
+Obj GUROBIKRAMERMESNERMODEL(Obj self, Obj NumberOfPoints, Obj Generators, Obj T, Obj K, Obj Lambda, Obj Threads)
+{
+	GurobifyKramerMesner km;
+	GRBmodel *model = NULL;
+	int n, i, j, a, b, number_of_threads, error;
+	int *seen;
+	double lambda;
+
+	if (! IS_INTOBJ(NumberOfPoints) || INT_INTOBJ(NumberOfPoints) < 1)
+		ErrorMayQuit( "Error: NumberOfPoints must be a positive integer.", 0, 0 );
+	if (! IS_INTOBJ(T) || ! IS_INTOBJ(K) || INT_INTOBJ(T) < 0 || INT_INTOBJ(T) > INT_INTOBJ(K)
+			|| INT_INTOBJ(K) > INT_INTOBJ(NumberOfPoints))
+		ErrorMayQuit( "Error: t and k must satisfy 0 <= t <= k <= NumberOfPoints.", 0, 0 );
+	if (! GurobifyGetDouble(Lambda, &lambda))
+		ErrorMayQuit( "Error: Lambda must be an integer or a float.", 0, 0 );
+	if (! IS_INTOBJ(Threads) || INT_INTOBJ(Threads) < 1)
+		ErrorMayQuit( "Error: Threads must be a positive integer.", 0, 0 );
+	if (! IS_SMALL_LIST(Generators))
+		ErrorMayQuit( "Error: Generators must be a list of lists of images.", 0, 0 );
+
+	memset(&km, 0, sizeof(GurobifyKramerMesner));
+	n = INT_INTOBJ(NumberOfPoints);
+	km.number_of_points = n;
+	km.t = INT_INTOBJ(T);
+	km.k = INT_INTOBJ(K);
+	km.number_of_generators = LEN_LIST(Generators);
+
+	// The binomial coefficients up to n, saturated so that overflows are detected below.
+	km.binomial = (long long*) GurobifyScratch((n+1)*(n+1)*sizeof(long long));
+	for (a = 0; a <= n; a = a+1)
+		for (b = 0; b <= n; b = b+1){
+			if (b == 0)
+				km.binomial[a*(n+1) + b] = 1;
+			else if (a == 0 || b > a)
+				km.binomial[a*(n+1) + b] = 0;
+			else{
+				km.binomial[a*(n+1) + b] = km.binomial[(a-1)*(n+1) + b-1] + km.binomial[(a-1)*(n+1) + b];
+				if (km.binomial[a*(n+1) + b] > INT_MAX)
+					km.binomial[a*(n+1) + b] = INT_MAX;
+			}
+		}
+	if (GurobifyBinomial(&km, n, km.k) >= INT_MAX || GurobifyBinomial(&km, n, km.t) >= INT_MAX)
+		ErrorMayQuit( "Error: there are too many k-subsets.", 0, 0 );
+
+	km.generators = (int*) GurobifyScratch((km.number_of_generators*n + 1)*sizeof(int));
+	seen = (int*) GurobifyScratch((n + 1)*sizeof(int));
+	for (i = 0; i < km.number_of_generators; i = i+1){
+		Obj images = ELM_LIST(Generators, i+1);
+		if (! IS_SMALL_LIST(images) || LEN_LIST(images) != n)
+			ErrorMayQuit( "Error: each generator must be a list of images of length NumberOfPoints.", 0, 0 );
+		for (j = 0; j < n; j = j+1)
+			seen[j] = 0;
+		for (j = 0; j < n; j = j+1){
+			Obj image = ELM_LIST(images, j+1);
+			if (! IS_INTOBJ(image) || INT_INTOBJ(image) < 1 || INT_INTOBJ(image) > n || seen[INT_INTOBJ(image) - 1])
+				ErrorMayQuit( "Error: each generator must be a permutation of the points.", 0, 0 );
+			seen[INT_INTOBJ(image) - 1] = 1;
+			km.generators[i*n + j] = INT_INTOBJ(image) - 1;
+		}
+	}
+
+	km.k_orbit = GurobifySubsetOrbits(&km, km.k, &km.number_of_k_orbits, &km.k_representatives);
+	GurobifySubsetOrbits(&km, km.t, &km.number_of_t_orbits, &km.t_representatives);
+
+	// The rows of the orbit incidence matrix are independent, and are computed in parallel.
+	number_of_threads = INT_INTOBJ(Threads);
+	if (number_of_threads > km.number_of_t_orbits)
+		number_of_threads = km.number_of_t_orbits;
+	km.row_length = (int*) GurobifyScratch((km.number_of_t_orbits + 1)*sizeof(int));
+	km.row_indices = (int**) GurobifyScratch((km.number_of_t_orbits + 1)*sizeof(int*));
+	km.row_values = (double**) GurobifyScratch((km.number_of_t_orbits + 1)*sizeof(double*));
+	pthread_t* threads = (pthread_t*) GurobifyScratch((number_of_threads + 1)*sizeof(pthread_t));
+	memset(km.row_length, 0, (km.number_of_t_orbits + 1)*sizeof(int));
+	memset(km.row_indices, 0, (km.number_of_t_orbits + 1)*sizeof(int*));
+	memset(km.row_values, 0, (km.number_of_t_orbits + 1)*sizeof(double*));
+	int *row_begin = (int*) GurobifyScratch((km.number_of_t_orbits + 1)*sizeof(int));
+	char *sense = (char*) GurobifyScratch((km.number_of_t_orbits + 1)*sizeof(char));
+	double *rhs = (double*) GurobifyScratch((km.number_of_t_orbits + 1)*sizeof(double));
+	char *vtype = (char*) GurobifyScratch((km.number_of_k_orbits + 1)*sizeof(char));
+	pthread_mutex_init(&km.lock, NULL);
+	km.next_row = 0;
+	for (i = 0; i < number_of_threads; i = i+1)
+		pthread_create(&threads[i], NULL, GurobifyKramerMesnerWorkerMain, &km);
+	for (i = 0; i < number_of_threads; i = i+1)
+		pthread_join(threads[i], NULL);
+	pthread_mutex_destroy(&km.lock);
+
+	error = 0;
+	for (i = 0; i < km.number_of_t_orbits; i = i+1)
+		if (km.row_indices[i] == NULL || km.row_values[i] == NULL)
+			error = 1;
+	if (error){
+		GurobifyFreeKramerMesner(&km);
+		ErrorMayQuit( "Error: not enough memory for the orbit incidence matrix.", 0, 0 );
+	}
+
+	// Load the matrix as one sparse block of equality constraints on binary variables, one for each k-orbit.
+	// The rows are gathered with malloc, since an error of the scratch arena would leave them behind.
+	int number_of_nonzeros = 0;
+	for (i = 0; i < km.number_of_t_orbits; i = i+1){
+		row_begin[i] = number_of_nonzeros;
+		number_of_nonzeros = number_of_nonzeros + km.row_length[i];
+		sense[i] = GRB_EQUAL;
+		rhs[i] = lambda;
+	}
+	int *indices = (int*) malloc((number_of_nonzeros + 1)*sizeof(int));
+	double *values = (double*) malloc((number_of_nonzeros + 1)*sizeof(double));
+	if (indices == NULL || values == NULL){
+		free(indices);
+		free(values);
+		GurobifyFreeKramerMesner(&km);
+		ErrorMayQuit( "Error: not enough memory for the orbit incidence matrix.", 0, 0 );
+	}
+	for (i = 0; i < km.number_of_t_orbits; i = i+1){
+		memcpy(indices + row_begin[i], km.row_indices[i], km.row_length[i]*sizeof(int));
+		memcpy(values + row_begin[i], km.row_values[i], km.row_length[i]*sizeof(double));
+	}
+	GurobifyFreeKramerMesner(&km);
+	for (j = 0; j < km.number_of_k_orbits; j = j+1)
+		vtype[j] = GRB_BINARY;
+	GurobifyCountBytes(number_of_nonzeros*(sizeof(int) + sizeof(double)));
+
+	error = GUROBIFY_TIMED(GRBnewmodel(GurobifyEnv(), &model, "KramerMesner", km.number_of_k_orbits, NULL, NULL, NULL, vtype, NULL));
+	if (! error)
+		error = GUROBIFY_TIMED(GRBaddconstrs(model, km.number_of_t_orbits, number_of_nonzeros, row_begin, indices, values,
+					sense, rhs, NULL));
+	if (! error)
+		error = GUROBIFY_TIMED(GRBupdatemodel(model));
+	free(indices);
+	free(values);
+
+	if (error){
+		GRBfreemodel(model);
+		ErrorMayQuit( "Error: Unable to create the Kramer-Mesner model.", 0, 0 );
+	}
+
+	Obj result = NEW_PREC(3);
+	AssPRec(result, RNamName("model"), NewModel(model));
+	AssPRec(result, RNamName("torbits"), GurobifyRepresentativeList(&km, km.t_representatives, km.number_of_t_orbits, km.t));
+	AssPRec(result, RNamName("korbits"), GurobifyRepresentativeList(&km, km.k_representatives, km.number_of_k_orbits, km.k));
+
+	return result;
+}
+
+/*
+	Orbits of binary solutions under a permutation group. A solution is packed into words, with its first entry
+	in the highest bit of the first word. The distinct solutions are put into a hash table once, and the orbit of
+	each solution which is not yet known to lie in the orbit of another is enumerated under the generators, so
+	that every solution found in it is assigned to the same class. Threads working on solutions in the same orbit
+	at the same time merge their classes, which are kept as a union-find forest over the distinct solutions.
+*/
+
+/*
+	A list of packed solutions with an open addressing hash table of positions in the list,
+	used for the distinct input solutions and for the orbit enumerated by each worker thread.
+*/
+
+typedef struct {
+	int number_of_words;
+	int size;
+	int capacity;
+	uint64_t *elements;
+	int table_size;
+	int *table;
+} GurobifyOrbitTable;
+
+typedef struct {
+	int number_of_points;
+	int number_of_words;
+	int number_of_generators;
+	int *generators;            // the images of the points, 0-based, one block of number_of_points per generator
+	GurobifyOrbitTable inputs;  // the distinct solutions, only read by the worker threads
+	char *claimed;              // whether a distinct solution has been found in an orbit, or its orbit enumerated
+	int *parent;                // the union-find forest of the classes of the distinct solutions
+	int next_input;
+	int error;
+	pthread_mutex_t lock;
+} GurobifyOrbitBatch;
+
+static uint64_t GurobifyHashWords(uint64_t *x, int number_of_words)
+{
+	int i;
+	uint64_t hash = 14695981039346656037ULL;
+	for (i = 0; i < number_of_words; i = i+1)
+		hash = (hash ^ x[i]) * 1099511628211ULL;
+	return hash ^ (hash >> 29);
+}
+
+static int GurobifyCompareWords(uint64_t *x, uint64_t *y, int number_of_words)
+{
+	int i;
+	for (i = 0; i < number_of_words; i = i+1)
+		if (x[i] != y[i])
+			return x[i] < y[i] ? -1 : 1;
+	return 0;
+}
+
+/* Stores the image of the solution x under generator g in y */
+static void GurobifyImageWords(GurobifyOrbitBatch *batch, int g, uint64_t *x, uint64_t *y)
+{
+	int i, w, point;
+	uint64_t bits;
+	int *images = batch->generators + (size_t) g * batch->number_of_points;
+
+	memset(y, 0, batch->number_of_words*sizeof(uint64_t));
+	for (w = 0; w < batch->number_of_words; w = w+1){
+		bits = x[w];
+		while (bits != 0){
+			i = __builtin_clzll(bits);
+			bits = bits & ~(1ULL << (63 - i));
+			point = images[64*w + i];
+			y[point / 64] = y[point / 64] | (1ULL << (63 - point % 64));
+		}
+	}
+}
+
+/* Returns the position of x in the table, or -1 if it is not there */
+static int GurobifyOrbitFind(GurobifyOrbitTable *orbit, uint64_t *x)
+{
+	int p;
+	int words = orbit->number_of_words;
+
+	if (orbit->table_size == 0)
+		return -1;
+	p = (int) (GurobifyHashWords(x, words) & (orbit->table_size - 1));
+	while (orbit->table[p] >= 0){
+		if (GurobifyCompareWords(orbit->elements + (size_t) orbit->table[p] * words, x, words) == 0)
+			return orbit->table[p];
+		p = (p + 1) & (orbit->table_size - 1);
+	}
+	return -1;
+}
+
+/* Adds x to the table unless it is already there. Returns -1 if memory is exhausted, and otherwise whether x was added. */
+static int GurobifyOrbitAdd(GurobifyOrbitTable *orbit, uint64_t *x)
+{
+	int i, p;
+	int words = orbit->number_of_words;
+
+	if (2*(orbit->size + 1) > orbit->table_size){
+		int table_size = orbit->table_size < 64 ? 64 : 2*orbit->table_size;
+		int *table = (int*) malloc(table_size*sizeof(int));
+		if (table == NULL)
+			return -1;
+		for (i = 0; i < table_size; i = i+1)
+			table[i] = -1;
+		for (i = 0; i < orbit->size; i = i+1){
+			p = (int) (GurobifyHashWords(orbit->elements + (size_t) i * words, words) & (table_size - 1));
+			while (table[p] >= 0)
+				p = (p + 1) & (table_size - 1);
+			table[p] = i;
+		}
+		free(orbit->table);
+		orbit->table = table;
+		orbit->table_size = table_size;
+	}
+	p = (int) (GurobifyHashWords(x, words) & (orbit->table_size - 1));
+	while (orbit->table[p] >= 0){
+		if (GurobifyCompareWords(orbit->elements + (size_t) orbit->table[p] * words, x, words) == 0)
+			return 0;
+		p = (p + 1) & (orbit->table_size - 1);
+	}
+	if (orbit->size == orbit->capacity){
+		int capacity = orbit->capacity < 64 ? 64 : 2*orbit->capacity;
+		uint64_t *elements = (uint64_t*) realloc(orbit->elements, (size_t) capacity * words * sizeof(uint64_t));
+		if (elements == NULL)
+			return -1;
+		orbit->elements = elements;
+		orbit->capacity = capacity;
+	}
+	memcpy(orbit->elements + (size_t) orbit->size * words, x, words*sizeof(uint64_t));
+	orbit->table[p] = orbit->size;
+	orbit->size = orbit->size + 1;
+	return 1;
+}
+
+/* The root of the class of a distinct solution. The lock of the batch must be held. */
+static int GurobifyOrbitRoot(GurobifyOrbitBatch *batch, int d)
+{
+	while (batch->parent[d] != d){
+		batch->parent[d] = batch->parent[batch->parent[d]];
+		d = batch->parent[d];
+	}
+	return d;
+}
+
+/*
+	Enumerates the orbit of the distinct solution d, and puts every distinct solution found in it into the class of d.
+	Returns 0 if memory is exhausted.
+*/
+
+static int GurobifyEnumerateOrbit(GurobifyOrbitBatch *batch, GurobifyOrbitTable *orbit, uint64_t *image, int d)
+{
+	int i, g, f, added, root_d, root_f;
+	int words = batch->number_of_words;
+
+	orbit->size = 0;
+	for (i = 0; i < orbit->table_size; i = i+1)
+		orbit->table[i] = -1;
+	if (GurobifyOrbitAdd(orbit, batch->inputs.elements + (size_t) d * words) < 0)
+		return 0;
+	for (i = 0; i < orbit->size; i = i+1){
+		for (g = 0; g < batch->number_of_generators; g = g+1){
+			GurobifyImageWords(batch, g, orbit->elements + (size_t) i * words, image);
+			added = GurobifyOrbitAdd(orbit, image);
+			if (added < 0)
+				return 0;
+			if (! added)
+				continue;
+			f = GurobifyOrbitFind(&batch->inputs, image);
+			if (f < 0 || f == d)
+				continue;
+			pthread_mutex_lock(&batch->lock);
+			if (! batch->claimed[f]){
+				batch->claimed[f] = 1;
+				batch->parent[f] = GurobifyOrbitRoot(batch, d);
+			}
+			else{
+				root_d = GurobifyOrbitRoot(batch, d);
+				root_f = GurobifyOrbitRoot(batch, f);
+				if (root_d < root_f)
+					batch->parent[root_f] = root_d;
+				else
+					batch->parent[root_d] = root_f;
+			}
+			pthread_mutex_unlock(&batch->lock);
+		}
+	}
+	return 1;
+}
+
+static void *GurobifyOrbitWorkerMain(void *arg)
+{
+	GurobifyOrbitBatch *batch = (GurobifyOrbitBatch*) arg;
+	GurobifyOrbitTable orbit;
+	uint64_t *image = (uint64_t*) malloc((batch->number_of_words + 1)*sizeof(uint64_t));
+	int d, error;
+
+	memset(&orbit, 0, sizeof(GurobifyOrbitTable));
+	orbit.number_of_words = batch->number_of_words;
+	error = (image == NULL);
+	while (! error){
+		// Takes the next distinct solution which has not been found in an orbit yet.
+		pthread_mutex_lock(&batch->lock);
+		while (batch->next_input < batch->inputs.size && batch->claimed[batch->next_input])
+			batch->next_input = batch->next_input + 1;
+		d = batch->next_input;
+		if (d < batch->inputs.size){
+			batch->claimed[d] = 1;
+			batch->parent[d] = d;
+		}
+		error = batch->error;
+		pthread_mutex_unlock(&batch->lock);
+		if (d >= batch->inputs.size || error)
+			break;
+		error = ! GurobifyEnumerateOrbit(batch, &orbit, image, d);
+	}
+	if (error){
+		pthread_mutex_lock(&batch->lock);
+		batch->error = 1;
+		pthread_mutex_unlock(&batch->lock);
+	}
+	free(image);
+	free(orbit.elements);
+	free(orbit.table);
+	return NULL;
+}
+
+
+/*
+This function is not documented.
+
+	Sorts the list Solutions of 0/1 vectors into orbits under the group generated by Generators, which is a list of
+	lists of images of the positions. The orbits are enumerated with Threads threads.
+	Returns rec(representatives, multiplicities, classes), see GurobiSolutionOrbitRepresentatives.
+*/
+
+Obj GUROBICANONICALSOLUTIONS(Obj self, Obj Solutions, Obj Generators, Obj Threads)
+{
+	GurobifyOrbitBatch batch;
+	pthread_t *threads;
+	Obj solution, images, entry;
+	int number_of_threads, number_of_solutions, number_of_classes, n, words;
+	int i, j, s, d;
+
+	if (! IS_SMALL_LIST(Solutions) || ! IS_SMALL_LIST(Generators))
+		ErrorMayQuit( "Error: Solutions and Generators must be lists.", 0, 0 );
+	if (! IS_INTOBJ(Threads) || INT_INTOBJ(Threads) < 1)
+		ErrorMayQuit( "Error: Threads must be a positive integer.", 0, 0 );
+
+	memset(&batch, 0, sizeof(GurobifyOrbitBatch));
+	number_of_solutions = LEN_LIST(Solutions);
+	if (number_of_solutions == 0){
+		Obj result = NEW_PREC(3);
+		AssPRec(result, RNamName("representatives"), NEW_PLIST(T_PLIST, 0));
+		AssPRec(result, RNamName("multiplicities"), NEW_PLIST(T_PLIST, 0));
+		AssPRec(result, RNamName("classes"), NEW_PLIST(T_PLIST, 0));
+		return result;
+	}
+	solution = ELM_LIST(Solutions, 1);
+	if (! IS_SMALL_LIST(solution))
+		ErrorMayQuit( "Error: each solution must be a list of 0s and 1s.", 0, 0 );
+	n = LEN_LIST(solution);
+	words = (n + 63) / 64;
+	batch.number_of_points = n;
+	batch.number_of_words = words;
+	batch.number_of_generators = LEN_LIST(Generators);
+
+	// The generators and the distinct solutions are only read by the worker threads.
+	batch.generators = (int*) GurobifyScratch(((size_t) batch.number_of_generators * n + 1)*sizeof(int));
+	for (i = 0; i < batch.number_of_generators; i = i+1){
+		images = ELM_LIST(Generators, i+1);
+		if (! IS_SMALL_LIST(images) || LEN_LIST(images) != n)
+			ErrorMayQuit( "Error: each generator must be a list of images of the positions of the solutions.", 0, 0 );
+		for (j = 0; j < n; j = j+1){
+			entry = ELM_LIST(images, j+1);
+			if (! IS_INTOBJ(entry) || INT_INTOBJ(entry) < 1 || INT_INTOBJ(entry) > n)
+				ErrorMayQuit( "Error: each generator must be a list of images of the positions of the solutions.", 0, 0 );
+			batch.generators[(size_t) i * n + j] = INT_INTOBJ(entry) - 1;
+		}
+	}
+	uint64_t *packed = (uint64_t*) GurobifyScratch(((size_t) number_of_solutions * words + 1)*sizeof(uint64_t));
+	int *input_of = (int*) GurobifyScratch((number_of_solutions + 1)*sizeof(int));
+	memset(packed, 0, (size_t) number_of_solutions * words * sizeof(uint64_t));
+	for (s = 0; s < number_of_solutions; s = s+1){
+		solution = ELM_LIST(Solutions, s+1);
+		if (! IS_SMALL_LIST(solution) || LEN_LIST(solution) != n)
+			ErrorMayQuit( "Error: all solutions must have the same length.", 0, 0 );
+		for (j = 0; j < n; j = j+1){
+			entry = ELM_LIST(solution, j+1);
+			if (entry == INTOBJ_INT(1))
+				packed[(size_t) s * words + j / 64] |= 1ULL << (63 - j % 64);
+			else if (entry != INTOBJ_INT(0))
+				ErrorMayQuit( "Error: each solution must be a list of 0s and 1s.", 0, 0 );
+		}
+	}
+	GurobifyCountBytes((size_t) number_of_solutions * words * sizeof(uint64_t));
+
+	// Equal solutions share one entry of the table of distinct solutions.
+	batch.inputs.number_of_words = words;
+	for (s = 0; s < number_of_solutions; s = s+1){
+		if (GurobifyOrbitAdd(&batch.inputs, packed + (size_t) s * words) < 0){
+			free(batch.inputs.elements);
+			free(batch.inputs.table);
+			ErrorMayQuit( "Error: not enough memory for the orbits of the solutions.", 0, 0 );
+		}
+		input_of[s] = GurobifyOrbitFind(&batch.inputs, packed + (size_t) s * words);
+	}
+	batch.claimed = (char*) GurobifyScratch(batch.inputs.size + 1);
+	batch.parent = (int*) GurobifyScratch((batch.inputs.size + 1)*sizeof(int));
+	memset(batch.claimed, 0, batch.inputs.size);
+
+	number_of_threads = INT_INTOBJ(Threads);
+	if (number_of_threads > batch.inputs.size)
+		number_of_threads = batch.inputs.size;
+	threads = (pthread_t*) GurobifyScratch(number_of_threads*sizeof(pthread_t));
+	pthread_mutex_init(&batch.lock, NULL);
+	for (i = 1; i < number_of_threads; i = i+1)
+		pthread_create(&threads[i], NULL, GurobifyOrbitWorkerMain, &batch);
+	GurobifyOrbitWorkerMain(&batch);
+	for (i = 1; i < number_of_threads; i = i+1)
+		pthread_join(threads[i], NULL);
+	pthread_mutex_destroy(&batch.lock);
+	free(batch.inputs.elements);
+	free(batch.inputs.table);
+	if (batch.error)
+		ErrorMayQuit( "Error: not enough memory for the orbits of the solutions.", 0, 0 );
+
+	// The classes are numbered in order of their first solution.
+	int *class_of_root = (int*) GurobifyScratch((batch.inputs.size + 1)*sizeof(int));
+	int *class_of = (int*) GurobifyScratch((number_of_solutions + 1)*sizeof(int));
+	int *multiplicity = (int*) GurobifyScratch((number_of_solutions + 1)*sizeof(int));
+	int *first = (int*) GurobifyScratch((number_of_solutions + 1)*sizeof(int));
+	for (d = 0; d < batch.inputs.size; d = d+1)
+		class_of_root[d] = -1;
+	number_of_classes = 0;
+	for (s = 0; s < number_of_solutions; s = s+1){
+		d = GurobifyOrbitRoot(&batch, input_of[s]);
+		if (class_of_root[d] < 0){
+			class_of_root[d] = number_of_classes;
+			multiplicity[number_of_classes] = 0;
+			first[number_of_classes] = s;
+			number_of_classes = number_of_classes + 1;
+		}
+		class_of[s] = class_of_root[d];
+		multiplicity[class_of[s]] = multiplicity[class_of[s]] + 1;
+	}
+
+	Obj representatives = NEW_PLIST(T_PLIST, number_of_classes);
+	Obj multiplicities = NEW_PLIST(T_PLIST, number_of_classes);
+	Obj class_list = NEW_PLIST(T_PLIST, number_of_solutions);
+	for (i = 0; i < number_of_classes; i = i+1){
+		ASS_LIST(representatives, i+1, ELM_LIST(Solutions, first[i] + 1));
+		ASS_LIST(multiplicities, i+1, INTOBJ_INT(multiplicity[i]));
+	}
+	for (s = 0; s < number_of_solutions; s = s+1)
+		ASS_LIST(class_list, s+1, INTOBJ_INT(class_of[s] + 1));
+
+	Obj result = NEW_PREC(3);
+	AssPRec(result, RNamName("representatives"), representatives);
+	AssPRec(result, RNamName("multiplicities"), multiplicities);
+	AssPRec(result, RNamName("classes"), class_list);
+
+	return result;
+}
+
+/*
+	#! @Chapter Using Gurobify
+	#! @Section Other
+	#! @Arguments 
+	#! @Returns [ major_version, minor_version, technical_version ]
+	#! @Description
+	#!	This function returns a list [ major_version, minor_version, technical_version ] which
+	#!	indicates the Gurobi library version. For example, if using Gurobi Version 7.5.1, then
+	#!	GurobiVersion() would return [ 7, 5, 1 ].
+	DeclareGlobalFunction("GurobiVersion");
+*/
+
+Obj GurobiVersion(Obj self){
+	int major, minor, technical;
+	GRBversion(&major, &minor, &technical);
+	Obj version = NEW_PLIST( T_PLIST , 3);
+	ASS_LIST( version, 1 , INTOBJ_INT(major));
+	ASS_LIST( version , 2, INTOBJ_INT(minor));
+	ASS_LIST( version, 3, INTOBJ_INT(technical));
+
+	return version;
+}
+
+/*
+	#! @Chapter Using Gurobify
+	#! @Section Other
+	#! @Arguments on
+	#! @Returns true
+	#! @Description
+	#!	Switches the recording of statistics about the calls of the functions of Gurobify
+	#!	on (if on is true) or off (if on is false), see GurobiCallStatistics.
+	#!	Recording is off when Gurobify is loaded. While it is off, the functions of Gurobify
+	#!	only have to check that it is off.
+	DeclareGlobalFunction("GurobiRecordCallStatistics");
+*/
+
+Obj GurobiRecordCallStatistics(Obj self, Obj on)
+{
+	if (on != True && on != False)
+		ErrorMayQuit( "Error: on must be true or false.", 0, 0 );
+	gurobify_statistics_enabled = (on == True);
+	return True;
+}
+
+/*
+	#! @Chapter Using Gurobify
+	#! @Section Other
+	#! @Arguments
+	#! @Returns record
+	#! @Description
+	#!	Returns a snapshot of the statistics recorded while GurobiRecordCallStatistics
+	#!	was switched on. The record has a component for each kernel function of Gurobify which was
+	#!	called, such as GurobiOptimiseModel or GUROBIADDCONSTRAINT (which is used by GurobiAddConstraint).
+	#!	Each component is a record with components calls, the number of calls, time, the total time
+	#!	in seconds spent in the function, gurobitime, the part of time which was spent in the Gurobi
+	#!	library, and bytes, the number of bytes of data converted between GAP objects and Gurobi.
+	#!	Calls which stop with an error are counted as well, with the time spent until the error.
+	#!	The Gurobi environment, which checks the licence, is only loaded when the first model is created or read,
+	#!	and released again once all models have been freed. Each loading is recorded in the component GRBloadenv,
+	#!	and its time is also included in the time of the function which created the model.
+	#!	The statistics are for this GAP process, and are kept until GurobiResetCallStatistics
+	#!	is called.
+	DeclareGlobalFunction("GurobiCallStatistics");
+*/
+
+Obj GurobiCallStatistics(Obj self)
+{
+	int i;
+	Obj statistics = NEW_PREC(0);
+	for (i = 0; i < gurobify_number_of_statistics; i = i+1){
+		if (gurobify_statistics[i].calls == 0)
+			continue;
+		Obj statistic = NEW_PREC(4);
+		AssPRec(statistic, RNamName("calls"), INTOBJ_INT(gurobify_statistics[i].calls));
+		AssPRec(statistic, RNamName("time"), NEW_MACFLOAT(gurobify_statistics[i].time));
+		AssPRec(statistic, RNamName("gurobitime"), NEW_MACFLOAT(gurobify_statistics[i].gurobi_time));
+		AssPRec(statistic, RNamName("bytes"), INTOBJ_INT(gurobify_statistics[i].bytes));
+		AssPRec(statistics, RNamName(gurobify_statistics[i].name), statistic);
+	}
+	return statistics;
+}
+
+/*
+	#! @Chapter Using Gurobify
+	#! @Section Other
+	#! @Arguments
+	#! @Returns true
+	#! @Description
+	#!	Sets all the statistics returned by GurobiCallStatistics to zero.
+	DeclareGlobalFunction("GurobiResetCallStatistics");
+*/
+
+Obj GurobiResetCallStatistics(Obj self)
+{
+	int i;
+	for (i = 0; i < gurobify_number_of_statistics; i = i+1){
+		gurobify_statistics[i].calls = 0;
+		gurobify_statistics[i].time = 0;
+		gurobify_statistics[i].gurobi_time = 0;
+		gurobify_statistics[i].bytes = 0;
+	}
+	return True;
+}
+
+typedef Obj (* GVarFunc)(/*arguments*/);
+
+#define GVAR_FUNC_TABLE_ENTRY(srcfile, name, nparam, params) \
+  {#name, nparam, \
+   params, \
+   (GVarFunc)name, \
+   srcfile ":Func" #name }
+
+/*
+	The exported kernel functions are wrapped, so that statistics about their calls can be
+	recorded, see GurobiRecordCallStatistics. A wrapper is defined for each function with
+	GUROBIFY_INSTRUMENT_n, where n is the number of arguments, and exported with
+	GUROBIFY_FUNC_TABLE_ENTRY. The wrappers also reset the scratch arena, see GurobifyScratch.
+*/
+
+#define GUROBIFY_INSTRUMENTED_CALL(name, args) \
+	static int statistic = -1; \
+	Obj result; \
+	double start; \
+	GurobifyScratchReset(); \
+	if (! gurobify_statistics_enabled) \
+		return name args; \
+	if (statistic < 0) \
+		statistic = GurobifyRegisterStatistic(#name); \
+	if (statistic < 0) \
+		return name args; \
+	start = GurobifyEnterStatistic(statistic); \
+	result = name args; \
+	GurobifyLeaveStatistic(statistic, start); \
+	return result;
+
+#define GUROBIFY_INSTRUMENT_0(name) \
+	static Obj name##Instrumented(Obj self) { GUROBIFY_INSTRUMENTED_CALL(name, (self)) }
+#define GUROBIFY_INSTRUMENT_1(name) \
+	static Obj name##Instrumented(Obj self, Obj a) { GUROBIFY_INSTRUMENTED_CALL(name, (self, a)) }
+#define GUROBIFY_INSTRUMENT_2(name) \
+	static Obj name##Instrumented(Obj self, Obj a, Obj b) { GUROBIFY_INSTRUMENTED_CALL(name, (self, a, b)) }
+#define GUROBIFY_INSTRUMENT_3(name) \
+	static Obj name##Instrumented(Obj self, Obj a, Obj b, Obj c) { GUROBIFY_INSTRUMENTED_CALL(name, (self, a, b, c)) }
+#define GUROBIFY_INSTRUMENT_4(name) \
+	static Obj name##Instrumented(Obj self, Obj a, Obj b, Obj c, Obj d) { GUROBIFY_INSTRUMENTED_CALL(name, (self, a, b, c, d)) }
+#define GUROBIFY_INSTRUMENT_5(name) \
+	static Obj name##Instrumented(Obj self, Obj a, Obj b, Obj c, Obj d, Obj e) { GUROBIFY_INSTRUMENTED_CALL(name, (self, a, b, c, d, e)) }
+#define GUROBIFY_INSTRUMENT_6(name) \
+	static Obj name##Instrumented(Obj self, Obj a, Obj b, Obj c, Obj d, Obj e, Obj f) { GUROBIFY_INSTRUMENTED_CALL(name, (self, a, b, c, d, e, f)) }
+
+#define GUROBIFY_FUNC_TABLE_ENTRY(srcfile, name, nparam, params) \
+  {#name, nparam, \
+   params, \
+   (GVarFunc)name##Instrumented, \
+   srcfile ":Func" #name }
+
+GUROBIFY_INSTRUMENT_1(GurobiReadModel)
+GUROBIFY_INSTRUMENT_1(GUROBINEWMODEL)
+GUROBIFY_INSTRUMENT_2(GUROBISETVARIABLENAMES)
+GUROBIFY_INSTRUMENT_1(GurobiOptimiseModel)
+GUROBIFY_INSTRUMENT_1(GurobiReset)
+GUROBIFY_INSTRUMENT_3(GurobiSetIntegerParameter)
+GUROBIFY_INSTRUMENT_3(GurobiSetDoubleParameter)
+GUROBIFY_INSTRUMENT_2(GurobiIntegerParameter)
+GUROBIFY_INSTRUMENT_1(GurobiParameters)
+GUROBIFY_INSTRUMENT_2(GurobiSetParameters)
+GUROBIFY_INSTRUMENT_2(GurobiReadParameters)
+GUROBIFY_INSTRUMENT_2(GurobiTuneModels)
+GUROBIFY_INSTRUMENT_2(GurobiDoubleParameter)
+GUROBIFY_INSTRUMENT_5(GUROBIADDCONSTRAINT)
+GUROBIFY_INSTRUMENT_6(GUROBIADDINDICATORCONSTRAINTS)
+GUROBIFY_INSTRUMENT_4(GUROBIADDSOS)
+GUROBIFY_INSTRUMENT_6(GUROBIADDGENERALCONSTRAINTS)
+GUROBIFY_INSTRUMENT_2(GurobiDeleteSingleConstraintWithName)
+GUROBIFY_INSTRUMENT_3(GurobiSetIntegerAttribute)
+GUROBIFY_INSTRUMENT_3(GurobiSetDoubleAttribute)
+GUROBIFY_INSTRUMENT_2(GurobiIntegerAttribute)
+GUROBIFY_INSTRUMENT_2(GurobiDoubleAttribute)
+GUROBIFY_INSTRUMENT_2(GurobiIntegerAttributeArray)
+GUROBIFY_INSTRUMENT_2(GurobiDoubleAttributeArray)
+GUROBIFY_INSTRUMENT_2(GurobiStringAttributeArray)
+GUROBIFY_INSTRUMENT_2(GurobiCharAttributeArray)
+GUROBIFY_INSTRUMENT_2(GurobiWriteToFile)
+GUROBIFY_INSTRUMENT_1(GurobiUpdateModel)
+GUROBIFY_INSTRUMENT_3(GurobiSetDoubleAttributeArray)
+GUROBIFY_INSTRUMENT_3(GurobiStringAttributeElement)
+GUROBIFY_INSTRUMENT_2(GurobiDeleteConstraints)
+GUROBIFY_INSTRUMENT_0(GurobiVersion)
+GUROBIFY_INSTRUMENT_4(GurobiWriteCheckpoint)
+GUROBIFY_INSTRUMENT_3(GurobiReadCheckpoint)
+GUROBIFY_INSTRUMENT_3(GUROBILAZYCOPY)
+GUROBIFY_INSTRUMENT_5(GUROBISETVARIABLEBOUNDS)
+GUROBIFY_INSTRUMENT_1(GurobiUndoVariableBounds)
+GUROBIFY_INSTRUMENT_4(GUROBISOLVESCENARIOS)
+GUROBIFY_INSTRUMENT_1(GurobiSolveStatistics)
+GUROBIFY_INSTRUMENT_1(GurobiComputeIIS)
+GUROBIFY_INSTRUMENT_2(GurobiFeasibilityRelaxation)
+GUROBIFY_INSTRUMENT_1(GurobiPresolveModel)
+GUROBIFY_INSTRUMENT_1(GurobiPresolvedVariables)
+GUROBIFY_INSTRUMENT_1(GurobiComponents)
+GUROBIFY_INSTRUMENT_1(GurobiComponentModels)
+GUROBIFY_INSTRUMENT_2(GUROBIOPTIMISECOMPONENTS)
+GUROBIFY_INSTRUMENT_2(GurobiCaptureLog)
+GUROBIFY_INSTRUMENT_1(GurobiLogMessages)
+GUROBIFY_INSTRUMENT_1(GurobiLogProgress)
+GUROBIFY_INSTRUMENT_6(GUROBIKRAMERMESNERMODEL)
+GUROBIFY_INSTRUMENT_3(GUROBICHECKSOLUTIONS)
+GUROBIFY_INSTRUMENT_3(GUROBICANONICALSOLUTIONS)
+GUROBIFY_INSTRUMENT_4(GUROBIENUMERATECUBES)
+GUROBIFY_INSTRUMENT_2(GurobiRaceModel)
+GUROBIFY_INSTRUMENT_6(GUROBISETOBJECTIVES)
+GUROBIFY_INSTRUMENT_1(GurobiObjectiveValues)
+GUROBIFY_INSTRUMENT_2(GurobiChangeModel)
+
+// Table of functions to export
+static StructGVarFunc GVarFuncs [] = {
+    GUROBIFY_FUNC_TABLE_ENTRY("Gurobify.c", GurobiReadModel, 1, "ModelFile"),
+    GUROBIFY_FUNC_TABLE_ENTRY("Gurobify.c", GUROBINEWMODEL, 1, "VariableTypes"),
+    GUROBIFY_FUNC_TABLE_ENTRY("Gurobify.c", GUROBISETVARIABLENAMES, 2, "model, VariableNames"),
+    GUROBIFY_FUNC_TABLE_ENTRY("Gurobify.c", GurobiOptimiseModel, 1, "model"),
+    GUROBIFY_FUNC_TABLE_ENTRY("Gurobify.c", GurobiReset, 1, "model"),
+    GUROBIFY_FUNC_TABLE_ENTRY("Gurobify.c", GurobiSetIntegerParameter, 3, "model, ParameterName, ParameterValue"),
+    GUROBIFY_FUNC_TABLE_ENTRY("Gurobify.c", GurobiSetDoubleParameter, 3, "model, ParameterName, ParameterValue"),
+    GUROBIFY_FUNC_TABLE_ENTRY("Gurobify.c", GurobiIntegerParameter, 2, "model, ParameterName"),
+    GUROBIFY_FUNC_TABLE_ENTRY("Gurobify.c", GurobiParameters, 1, "model"),
+    GUROBIFY_FUNC_TABLE_ENTRY("Gurobify.c", GurobiSetParameters, 2, "model, Parameters"),
+    GUROBIFY_FUNC_TABLE_ENTRY("Gurobify.c", GurobiReadParameters, 2, "model, FileName"),
+    GUROBIFY_FUNC_TABLE_ENTRY("Gurobify.c", GurobiTuneModels, 2, "Models, TimeLimit"),
+    GUROBIFY_FUNC_TABLE_ENTRY("Gurobify.c", GurobiDoubleParameter, 2, "model, ParameterName"),
+    GUROBIFY_FUNC_TABLE_ENTRY("Gurobify.c", GUROBIADDCONSTRAINT, 5, "model, ConstraintEquation, ConstraintSense, ConstraintRHS, ConstraintName"),
+    GUROBIFY_FUNC_TABLE_ENTRY("Gurobify.c", GUROBIADDINDICATORCONSTRAINTS, 6, "model, Indicators, Equations, Senses, RHSs, Names"),
+    GUROBIFY_FUNC_TABLE_ENTRY("Gurobify.c", GUROBIADDSOS, 4, "model, Types, Variables, Weights"),
+    GUROBIFY_FUNC_TABLE_ENTRY("Gurobify.c", GUROBIADDGENERALCONSTRAINTS, 6, "model, Types, Resultants, Operands, Constants, Names"),
+    GUROBIFY_FUNC_TABLE_ENTRY("Gurobify.c", GurobiDeleteSingleConstraintWithName, 2, "model, ConstraintName"),
+    GUROBIFY_FUNC_TABLE_ENTRY("Gurobify.c", GurobiSetIntegerAttribute, 3, "model, AttributeName, AttributeValue"),
+    GUROBIFY_FUNC_TABLE_ENTRY("Gurobify.c", GurobiSetDoubleAttribute, 3, "model, AttributeName, AttributeValue"),
+    GUROBIFY_FUNC_TABLE_ENTRY("Gurobify.c", GurobiIntegerAttribute, 2, "model, AttributeName"),
+    GUROBIFY_FUNC_TABLE_ENTRY("Gurobify.c", GurobiDoubleAttribute, 2, "model, AttributeName"),
+    GUROBIFY_FUNC_TABLE_ENTRY("Gurobify.c", GurobiIntegerAttributeArray, 2, "model, AttributeName"),
+    GUROBIFY_FUNC_TABLE_ENTRY("Gurobify.c", GurobiDoubleAttributeArray, 2, "model, AttributeName"),
+    GUROBIFY_FUNC_TABLE_ENTRY("Gurobify.c", GurobiStringAttributeArray, 2, "model, AttributeName"),
+    GUROBIFY_FUNC_TABLE_ENTRY("Gurobify.c", GurobiCharAttributeArray, 2, "model, AttributeName"),
+    GUROBIFY_FUNC_TABLE_ENTRY("Gurobify.c", GurobiWriteToFile, 2, "model, FileName"),
+    GUROBIFY_FUNC_TABLE_ENTRY("Gurobify.c", GurobiUpdateModel, 1, "model"),
+    GUROBIFY_FUNC_TABLE_ENTRY("Gurobify.c", GurobiSetDoubleAttributeArray, 3, "model, AttributeName, AttributeArray"),
+    GUROBIFY_FUNC_TABLE_ENTRY("Gurobify.c", GurobiStringAttributeElement, 3, "model, position, AttributeName"),
+    GUROBIFY_FUNC_TABLE_ENTRY("Gurobify.c", GurobiDeleteConstraints, 2, "model, ConstraintList"),
+    GUROBIFY_FUNC_TABLE_ENTRY("Gurobify.c", GurobiVersion, 0, ""),
+    GUROBIFY_FUNC_TABLE_ENTRY("Gurobify.c", GurobiWriteCheckpoint, 4, "FileName, NumberOfVariables, Size, Solutions"),
+    GUROBIFY_FUNC_TABLE_ENTRY("Gurobify.c", GurobiReadCheckpoint, 3, "FileName, NumberOfVariables, Size"),
+    GUROBIFY_FUNC_TABLE_ENTRY("Gurobify.c", GUROBILAZYCOPY, 3, "model, IndexSet, Values"),
+    GUROBIFY_FUNC_TABLE_ENTRY("Gurobify.c", GUROBISETVARIABLEBOUNDS, 5, "model, IndexSet, LB, UB, Save"),
+    GUROBIFY_FUNC_TABLE_ENTRY("Gurobify.c", GurobiUndoVariableBounds, 1, "model"),
+    GUROBIFY_FUNC_TABLE_ENTRY("Gurobify.c", GUROBISOLVESCENARIOS, 4, "model, Scenarios, Threads, WithSolutions"),
+    GUROBIFY_FUNC_TABLE_ENTRY("Gurobify.c", GurobiSolveStatistics, 1, "model"),
+    GUROBIFY_FUNC_TABLE_ENTRY("Gurobify.c", GurobiComputeIIS, 1, "model"),
+    GUROBIFY_FUNC_TABLE_ENTRY("Gurobify.c", GurobiFeasibilityRelaxation, 2, "model, Penalties"),
+    GUROBIFY_FUNC_TABLE_ENTRY("Gurobify.c", GurobiPresolveModel, 1, "model"),
+    GUROBIFY_FUNC_TABLE_ENTRY("Gurobify.c", GurobiPresolvedVariables, 1, "model"),
+    GUROBIFY_FUNC_TABLE_ENTRY("Gurobify.c", GurobiComponents, 1, "model"),
+    GUROBIFY_FUNC_TABLE_ENTRY("Gurobify.c", GurobiComponentModels, 1, "model"),
+    GUROBIFY_FUNC_TABLE_ENTRY("Gurobify.c", GUROBIOPTIMISECOMPONENTS, 2, "model, Threads"),
+    GUROBIFY_FUNC_TABLE_ENTRY("Gurobify.c", GurobiCaptureLog, 2, "model, Capacity"),
+    GUROBIFY_FUNC_TABLE_ENTRY("Gurobify.c", GurobiLogMessages, 1, "model"),
+    GUROBIFY_FUNC_TABLE_ENTRY("Gurobify.c", GurobiLogProgress, 1, "model"),
+    GUROBIFY_FUNC_TABLE_ENTRY("Gurobify.c", GUROBIKRAMERMESNERMODEL, 6, "NumberOfPoints, Generators, t, k, Lambda, Threads"),
+    GUROBIFY_FUNC_TABLE_ENTRY("Gurobify.c", GUROBICHECKSOLUTIONS, 3, "model, Candidates, Threads"),
+    GUROBIFY_FUNC_TABLE_ENTRY("Gurobify.c", GUROBICANONICALSOLUTIONS, 3, "Solutions, Generators, Threads"),
+    GUROBIFY_FUNC_TABLE_ENTRY("Gurobify.c", GUROBIENUMERATECUBES, 4, "model, Prefix, Size, Workers"),
+    GUROBIFY_FUNC_TABLE_ENTRY("Gurobify.c", GurobiRaceModel, 2, "model, ParameterSets"),
+    GUROBIFY_FUNC_TABLE_ENTRY("Gurobify.c", GUROBISETOBJECTIVES, 6, "model, Objectives, Priorities, Weights, AbsTols, RelTols"),
+    GUROBIFY_FUNC_TABLE_ENTRY("Gurobify.c", GurobiObjectiveValues, 1, "model"),
+    GUROBIFY_FUNC_TABLE_ENTRY("Gurobify.c", GurobiChangeModel, 2, "model, Changes"),
+    GVAR_FUNC_TABLE_ENTRY("Gurobify.c", GurobiRecordCallStatistics, 1, "on"),
+    GVAR_FUNC_TABLE_ENTRY("Gurobify.c", GurobiCallStatistics, 0, ""),
+    GVAR_FUNC_TABLE_ENTRY("Gurobify.c", GurobiResetCallStatistics, 0, ""),
+
+  { 0 } /* Finish with an empty entry */
+
+};
+
+/******************************************************************************
+*F  InitKernel( <module> )  . . . . . . . . initialise kernel data structures
+*/
+static Int InitKernel( StructInitInfo *module )
+{
+    /* init filters and functions                                          */
+    InitHdlrFuncsFromTable( GVarFuncs );
+
+	
+    InitCopyGVar( "TheTypeGurobiModel", &TheTypeGurobiModel );
 
 	T_GUROBI = RegisterPackageTNUM("GurobiModel", GurobiTypeFunc);
 
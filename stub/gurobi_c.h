@@ -0,0 +1,267 @@
+/*
+ * Gurobify: Gurobify provides an interface to Gurobi from GAP.
+ *
+ * Copyright (c) 2017 - 2021 Jesse Lansdown
+ *
+ * This Source Code Form is subject to the terms of the Mozilla
+ * Public License, v. 2.0. If a copy of the MPL was not distributed
+ * with this file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+/*
+	A minimal replacement for the Gurobi C interface, implementing only the part of
+	gurobi_c.h which is used by Gurobify. It is used by configuring with --with-gurobi-stub,
+	so that Gurobify can be built, tested and benchmarked without a Gurobi installation.
+
+	The names, constants and signatures agree with those of Gurobi, see stub/gurobi_stub.c
+	for what is (and is not) supported.
+*/
+
+#ifndef GUROBIFY_STUB_GUROBI_C_H
+#define GUROBIFY_STUB_GUROBI_C_H
+
+#define GRB_VERSION_MAJOR     9
+#define GRB_VERSION_MINOR     1
+#define GRB_VERSION_TECHNICAL 0
+
+typedef struct _GRBmodel GRBmodel;
+typedef struct _GRBenv GRBenv;
+
+#define GRB_MAX_STRLEN 512
+#define GRB_MAX_NAMELEN 255
+
+/* Error codes */
+
+#define GRB_ERROR_OUT_OF_MEMORY            10001
+#define GRB_ERROR_NULL_ARGUMENT            10002
+#define GRB_ERROR_INVALID_ARGUMENT         10003
+#define GRB_ERROR_UNKNOWN_ATTRIBUTE        10004
+#define GRB_ERROR_DATA_NOT_AVAILABLE       10005
+#define GRB_ERROR_INDEX_OUT_OF_RANGE       10006
+#define GRB_ERROR_UNKNOWN_PARAMETER        10007
+#define GRB_ERROR_VALUE_OUT_OF_RANGE       10008
+#define GRB_ERROR_CALLBACK                 10011
+#define GRB_ERROR_FILE_READ                10012
+#define GRB_ERROR_FILE_WRITE               10013
+#define GRB_ERROR_IIS_NOT_INFEASIBLE       10015
+#define GRB_ERROR_NOT_SUPPORTED            10024
+
+/* Constraint senses */
+
+#define GRB_LESS_EQUAL    '<'
+#define GRB_GREATER_EQUAL '>'
+#define GRB_EQUAL         '='
+
+/* Variable types */
+
+#define GRB_CONTINUOUS 'C'
+#define GRB_BINARY     'B'
+#define GRB_INTEGER    'I'
+#define GRB_SEMICONT   'S'
+#define GRB_SEMIINT    'N'
+
+/* SOS types */
+
+#define GRB_SOS_TYPE1 1
+#define GRB_SOS_TYPE2 2
+
+/* Objective sense */
+
+#define GRB_MINIMIZE 1
+#define GRB_MAXIMIZE -1
+
+#define GRB_INFINITY  1e100
+#define GRB_UNDEFINED 1e101
+
+/* Attributes */
+
+#define GRB_INT_ATTR_NUMCONSTRS    "NumConstrs"
+#define GRB_INT_ATTR_NUMVARS       "NumVars"
+#define GRB_INT_ATTR_NUMNZS        "NumNZs"
+#define GRB_INT_ATTR_NUMINTVARS    "NumIntVars"
+#define GRB_INT_ATTR_NUMBINVARS    "NumBinVars"
+#define GRB_INT_ATTR_NUMSOS        "NumSOS"
+#define GRB_INT_ATTR_NUMGENCONSTRS "NumGenConstrs"
+#define GRB_INT_ATTR_MODELSENSE    "ModelSense"
+#define GRB_INT_ATTR_IS_MIP        "IsMIP"
+#define GRB_STR_ATTR_MODELNAME     "ModelName"
+#define GRB_DBL_ATTR_OBJCON        "ObjCon"
+#define GRB_DBL_ATTR_LB            "LB"
+#define GRB_DBL_ATTR_UB            "UB"
+#define GRB_DBL_ATTR_OBJ           "Obj"
+#define GRB_CHAR_ATTR_VTYPE        "VType"
+#define GRB_STR_ATTR_VARNAME       "VarName"
+#define GRB_DBL_ATTR_START         "Start"
+#define GRB_DBL_ATTR_RHS           "RHS"
+#define GRB_CHAR_ATTR_SENSE        "Sense"
+#define GRB_STR_ATTR_CONSTRNAME    "ConstrName"
+#define GRB_DBL_ATTR_RUNTIME       "Runtime"
+#define GRB_INT_ATTR_STATUS        "Status"
+#define GRB_DBL_ATTR_OBJVAL        "ObjVal"
+#define GRB_DBL_ATTR_OBJBOUND      "ObjBound"
+#define GRB_DBL_ATTR_MIPGAP        "MIPGap"
+#define GRB_INT_ATTR_SOLCOUNT      "SolCount"
+#define GRB_DBL_ATTR_ITERCOUNT     "IterCount"
+#define GRB_DBL_ATTR_NODECOUNT     "NodeCount"
+#define GRB_DBL_ATTR_X             "X"
+#define GRB_DBL_ATTR_SLACK         "Slack"
+#define GRB_INT_ATTR_TUNE_RESULTCOUNT "TuneResultCount"
+#define GRB_INT_ATTR_IIS_CONSTR    "IISConstr"
+#define GRB_INT_ATTR_IIS_LB        "IISLB"
+#define GRB_INT_ATTR_IIS_UB        "IISUB"
+
+/* Optimisation status codes */
+
+#define GRB_LOADED          1
+#define GRB_OPTIMAL         2
+#define GRB_INFEASIBLE      3
+#define GRB_INF_OR_UNBD     4
+#define GRB_UNBOUNDED       5
+#define GRB_CUTOFF          6
+#define GRB_ITERATION_LIMIT 7
+#define GRB_NODE_LIMIT      8
+#define GRB_TIME_LIMIT      9
+#define GRB_SOLUTION_LIMIT  10
+#define GRB_INTERRUPTED     11
+#define GRB_NUMERIC         12
+#define GRB_SUBOPTIMAL      13
+#define GRB_INPROGRESS      14
+#define GRB_USER_OBJ_LIMIT  15
+
+/* Callbacks */
+
+#define GRB_CB_POLLING   0
+#define GRB_CB_PRESOLVE  1
+#define GRB_CB_SIMPLEX   2
+#define GRB_CB_MIP       3
+#define GRB_CB_MIPSOL    4
+#define GRB_CB_MIPNODE   5
+#define GRB_CB_MESSAGE   6
+
+#define GRB_CB_PRE_COLDEL 1000
+#define GRB_CB_PRE_ROWDEL 1001
+#define GRB_CB_PRE_SENCHG 1002
+#define GRB_CB_PRE_BNDCHG 1003
+#define GRB_CB_PRE_COECHG 1004
+
+#define GRB_CB_MIP_OBJBST 3000
+#define GRB_CB_MIP_OBJBND 3001
+#define GRB_CB_MIP_NODCNT 3002
+#define GRB_CB_MIP_SOLCNT 3003
+#define GRB_CB_MIP_CUTCNT 3004
+#define GRB_CB_MIP_NODLFT 3005
+#define GRB_CB_MIP_ITRCNT 3006
+
+#define GRB_CB_MSG_STRING 6001
+#define GRB_CB_RUNTIME    6002
+
+#define CB_ARGS GRBmodel *model, void *cbdata, int where, void *usrdata
+
+/* Environments */
+
+int GRBloadenv(GRBenv **envP, const char *logfilename);
+void GRBfreeenv(GRBenv *env);
+GRBenv *GRBgetenv(GRBmodel *model);
+const char *GRBgeterrormsg(GRBenv *env);
+void GRBversion(int *majorP, int *minorP, int *technicalP);
+
+/* Models */
+
+int GRBnewmodel(GRBenv *env, GRBmodel **modelP, const char *Pname, int numvars,
+		double *obj, double *lb, double *ub, char *vtype, char **varnames);
+int GRBreadmodel(GRBenv *env, const char *filename, GRBmodel **modelP);
+GRBmodel *GRBcopymodel(GRBmodel *model);
+GRBmodel *GRBcopymodeltoenv(GRBmodel *model, GRBenv *targetenv);
+GRBmodel *GRBpresolvemodel(GRBmodel *model);
+int GRBfreemodel(GRBmodel *model);
+int GRBupdatemodel(GRBmodel *model);
+int GRBresetmodel(GRBmodel *model);
+int GRBwrite(GRBmodel *model, const char *filename);
+
+int GRBaddvars(GRBmodel *model, int numvars, int numnz, int *vbeg, int *vind, double *vval,
+		double *obj, double *lb, double *ub, char *vtype, char **varnames);
+int GRBaddconstr(GRBmodel *model, int numnz, int *cind, double *cval, char sense,
+		double rhs, const char *constrname);
+int GRBaddconstrs(GRBmodel *model, int numconstrs, int numnz, int *cbeg, int *cind,
+		double *cval, char *sense, double *rhs, char **constrnames);
+int GRBaddgenconstrIndicator(GRBmodel *model, const char *name, int binvar, int binval, int nvars,
+		const int *ind, const double *val, char sense, double rhs);
+int GRBaddgenconstrMax(GRBmodel *model, const char *name, int resvar, int nvars, const int *vars, double constant);
+int GRBaddgenconstrMin(GRBmodel *model, const char *name, int resvar, int nvars, const int *vars, double constant);
+int GRBaddgenconstrAbs(GRBmodel *model, const char *name, int resvar, int argvar);
+int GRBaddgenconstrAnd(GRBmodel *model, const char *name, int resvar, int nvars, const int *vars);
+int GRBaddgenconstrOr(GRBmodel *model, const char *name, int resvar, int nvars, const int *vars);
+int GRBaddsos(GRBmodel *model, int numsos, int nummembers, int *types, int *beg, int *ind, double *weight);
+int GRBdelconstrs(GRBmodel *model, int len, int *ind);
+int GRBchgcoeffs(GRBmodel *model, int cnt, int *cind, int *vind, double *val);
+int GRBsetobjectiven(GRBmodel *model, int index, int priority, double weight, double abstol, double reltol,
+		const char *name, double constant, int lnz, int *lind, double *lval);
+int GRBgetconstrs(GRBmodel *model, int *numnzP, int *cbeg, int *cind, double *cval,
+		int start, int len);
+int GRBgetconstrbyname(GRBmodel *model, const char *name, int *constrnumP);
+int GRBgetvarbyname(GRBmodel *model, const char *name, int *varnumP);
+
+int GRBoptimize(GRBmodel *model);
+void GRBterminate(GRBmodel *model);
+int GRBsetcallbackfunc(GRBmodel *model, int (*cb)(CB_ARGS), void *usrdata);
+int GRBcbget(void *cbdata, int where, int what, void *resultP);
+
+int GRBcomputeIIS(GRBmodel *model);
+int GRBfeasrelax(GRBmodel *model, int relaxobjtype, int minrelax, double *lbpen, double *ubpen,
+		double *rhspen, double *feasobjP);
+
+int GRBtunemodel(GRBmodel *model);
+int GRBtunemodels(int nummodels, GRBmodel **models, GRBmodel *ignore, GRBmodel *hint);
+int GRBgettuneresult(GRBmodel *model, int i);
+
+/* Attributes */
+
+int GRBgetintattr(GRBmodel *model, const char *attrname, int *valueP);
+int GRBsetintattr(GRBmodel *model, const char *attrname, int newvalue);
+int GRBgetdblattr(GRBmodel *model, const char *attrname, double *valueP);
+int GRBsetdblattr(GRBmodel *model, const char *attrname, double newvalue);
+int GRBgetstrattr(GRBmodel *model, const char *attrname, char **valueP);
+int GRBsetstrattr(GRBmodel *model, const char *attrname, const char *newvalue);
+
+int GRBgetintattrelement(GRBmodel *model, const char *attrname, int element, int *valueP);
+int GRBsetintattrelement(GRBmodel *model, const char *attrname, int element, int newvalue);
+int GRBgetdblattrelement(GRBmodel *model, const char *attrname, int element, double *valueP);
+int GRBsetdblattrelement(GRBmodel *model, const char *attrname, int element, double newvalue);
+int GRBgetcharattrelement(GRBmodel *model, const char *attrname, int element, char *valueP);
+int GRBsetcharattrelement(GRBmodel *model, const char *attrname, int element, char newvalue);
+int GRBgetstrattrelement(GRBmodel *model, const char *attrname, int element, char **valueP);
+int GRBsetstrattrelement(GRBmodel *model, const char *attrname, int element, const char *newvalue);
+
+int GRBgetintattrarray(GRBmodel *model, const char *attrname, int first, int len, int *values);
+int GRBsetintattrarray(GRBmodel *model, const char *attrname, int first, int len, int *newvalues);
+int GRBgetdblattrarray(GRBmodel *model, const char *attrname, int first, int len, double *values);
+int GRBsetdblattrarray(GRBmodel *model, const char *attrname, int first, int len, double *newvalues);
+int GRBgetcharattrarray(GRBmodel *model, const char *attrname, int first, int len, char *values);
+int GRBsetcharattrarray(GRBmodel *model, const char *attrname, int first, int len, char *newvalues);
+int GRBgetstrattrarray(GRBmodel *model, const char *attrname, int first, int len, char **values);
+int GRBsetstrattrarray(GRBmodel *model, const char *attrname, int first, int len, char **newvalues);
+
+int GRBgetdblattrlist(GRBmodel *model, const char *attrname, int len, int *ind, double *values);
+int GRBsetdblattrlist(GRBmodel *model, const char *attrname, int len, int *ind, double *newvalues);
+
+/* Parameters */
+
+int GRBgetintparam(GRBenv *env, const char *paramname, int *valueP);
+int GRBsetintparam(GRBenv *env, const char *paramname, int value);
+int GRBgetdblparam(GRBenv *env, const char *paramname, double *valueP);
+int GRBsetdblparam(GRBenv *env, const char *paramname, double value);
+int GRBgetstrparam(GRBenv *env, const char *paramname, char *valueP);
+int GRBsetstrparam(GRBenv *env, const char *paramname, const char *value);
+int GRBsetparam(GRBenv *env, const char *paramname, const char *value);
+int GRBgetintparaminfo(GRBenv *env, const char *paramname, int *valueP, int *minP, int *maxP, int *defP);
+int GRBgetdblparaminfo(GRBenv *env, const char *paramname, double *valueP, double *minP, double *maxP, double *defP);
+int GRBgetstrparaminfo(GRBenv *env, const char *paramname, char *valueP, char *defP);
+int GRBgetparamtype(GRBenv *env, const char *paramname);
+int GRBgetnumparams(GRBenv *env);
+int GRBgetparamname(GRBenv *env, int i, char **paramnameP);
+int GRBcopyparams(GRBenv *dest, GRBenv *src);
+int GRBresetparams(GRBenv *env);
+int GRBreadparams(GRBenv *env, const char *filename);
+int GRBwriteparams(GRBenv *env, const char *filename);
+
+#endif
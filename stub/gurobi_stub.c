@@ -0,0 +1,2769 @@
+/*
+ * Gurobify: Gurobify provides an interface to Gurobi from GAP.
+ *
+ * Copyright (c) 2017 - 2021 Jesse Lansdown
+ *
+ * This Source Code Form is subject to the terms of the Mozilla
+ * Public License, v. 2.0. If a copy of the MPL was not distributed
+ * with this file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ */
+
+/*
+	A minimal in-memory implementation of the part of the Gurobi C interface used by Gurobify.
+
+	Models are stored row by row. Changes take effect immediately, so GRBupdatemodel does
+	nothing. Variable and constraint attributes can be queried and set, as can the model
+	attributes which Gurobify uses. Models can be written in LP and MPS format, and read in
+	MPS format.
+
+	The solver is a depth first search over the values of the variables, pruned by the
+	minimum and maximum activity of each constraint and by the best objective value found
+	so far. It is only meant for small models whose variables are binary, or integer with
+	small finite bounds. If a model contains any other variables then the optimisation
+	finishes with status GRB_NUMERIC. The parameters TimeLimit, NodeLimit, SolutionLimit,
+	CutOff and BestObjStop are respected, and GRBterminate interrupts the search.
+
+	A model with several objectives, see GRBsetobjectiven, is optimised one priority at a time from the
+	highest, each level blending its objectives by their weights. Only the primary objective is written to files.
+
+	A callback set with GRBsetcallbackfunc is called once where GRB_CB_PRESOLVE (the stub does
+	no presolve, so nothing is ever removed), regularly where GRB_CB_MIP during the search, and
+	where GRB_CB_MESSAGE for every line of the log.
+*/
+
+#include "gurobi_c.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <stdarg.h>
+#include <math.h>
+#include <time.h>
+
+/*
+	Parameters
+*/
+
+#define STUB_INT_PARAM 1
+#define STUB_DBL_PARAM 2
+#define STUB_STR_PARAM 3
+
+typedef struct {
+	const char *name;
+	int type;
+	double min;
+	double max;
+	double def;
+} StubParameter;
+
+static const StubParameter stub_parameters[] = {
+	{ "Aggregate",       STUB_INT_PARAM, 0, 2, 1 },
+	{ "BestBdStop",      STUB_DBL_PARAM, -GRB_INFINITY, GRB_INFINITY, GRB_INFINITY },
+	{ "BestObjStop",     STUB_DBL_PARAM, -GRB_INFINITY, GRB_INFINITY, -GRB_INFINITY },
+	{ "Cutoff",          STUB_DBL_PARAM, -GRB_INFINITY, GRB_INFINITY, GRB_INFINITY },
+	{ "Cuts",            STUB_INT_PARAM, -1, 3, -1 },
+	{ "DualReductions",  STUB_INT_PARAM, 0, 1, 1 },
+	{ "FeasibilityTol",  STUB_DBL_PARAM, 1e-9, 1e-2, 1e-6 },
+	{ "Heuristics",      STUB_DBL_PARAM, 0, 1, 0.05 },
+	{ "IntFeasTol",      STUB_DBL_PARAM, 1e-9, 1e-1, 1e-5 },
+	{ "IterationLimit",  STUB_DBL_PARAM, 0, GRB_INFINITY, GRB_INFINITY },
+	{ "LogFile",         STUB_STR_PARAM, 0, 0, 0 },
+	{ "LogToConsole",    STUB_INT_PARAM, 0, 1, 1 },
+	{ "Method",          STUB_INT_PARAM, -1, 5, -1 },
+	{ "MIPFocus",        STUB_INT_PARAM, 0, 3, 0 },
+	{ "MIPGap",          STUB_DBL_PARAM, 0, GRB_INFINITY, 1e-4 },
+	{ "NodeLimit",       STUB_DBL_PARAM, 0, GRB_INFINITY, GRB_INFINITY },
+	{ "NumericFocus",    STUB_INT_PARAM, 0, 3, 0 },
+	{ "ObjNumber",       STUB_INT_PARAM, 0, 2000000000, 0 },
+	{ "OutputFlag",      STUB_INT_PARAM, 0, 1, 1 },
+	{ "Presolve",        STUB_INT_PARAM, -1, 2, -1 },
+	{ "Seed",            STUB_INT_PARAM, 0, 2000000000, 0 },
+	{ "SolutionLimit",   STUB_INT_PARAM, 1, 2000000000, 2000000000 },
+	{ "Symmetry",        STUB_INT_PARAM, -1, 2, -1 },
+	{ "Threads",         STUB_INT_PARAM, 0, 1024, 0 },
+	{ "TimeLimit",       STUB_DBL_PARAM, 0, GRB_INFINITY, GRB_INFINITY },
+	{ "TuneTimeLimit",   STUB_DBL_PARAM, -1, GRB_INFINITY, -1 },
+};
+
+#define STUB_NUMBER_OF_PARAMETERS ((int) (sizeof(stub_parameters) / sizeof(stub_parameters[0])))
+
+struct _GRBenv {
+	double values[STUB_NUMBER_OF_PARAMETERS];
+	char strings[STUB_NUMBER_OF_PARAMETERS][GRB_MAX_STRLEN];
+	char errormsg[GRB_MAX_STRLEN];
+};
+
+/*
+	Models
+*/
+
+typedef struct {
+	int numnz;
+	int capacity;
+	int *ind;
+	double *val;
+	char sense;
+	double rhs;
+	char *name;
+} StubRow;
+
+/*
+	A general constraint or SOS constraint. The solver only checks these once all variables are
+	fixed, so they do not prune the search. For indicator constraints vars and vals are the linear
+	row, for SOS constraints vals are the weights, and otherwise vars are the operands.
+*/
+
+#define STUB_GENCONSTR_MAX       0
+#define STUB_GENCONSTR_MIN       1
+#define STUB_GENCONSTR_ABS       2
+#define STUB_GENCONSTR_AND       3
+#define STUB_GENCONSTR_OR        4
+#define STUB_GENCONSTR_INDICATOR 5
+#define STUB_SOS1                101
+#define STUB_SOS2                102
+
+typedef struct {
+	int type;
+	int resvar;
+	int binval;
+	int nvars;
+	int *vars;
+	double *vals;
+	char sense;
+	double rhs;
+} StubGenConstr;
+
+/*
+	An objective of a model with several objectives. Objective 0 is the objective of the model itself,
+	so only its priority, weight and tolerances are kept here, and the others are stored sparsely.
+*/
+
+typedef struct {
+	int priority;
+	double weight;
+	double abstol;
+	double reltol;
+	double constant;
+	int numnz;
+	int *ind;
+	double *val;
+} StubObjective;
+
+struct _GRBmodel {
+	GRBenv *env;
+	char *name;
+	int sense;
+	double objcon;
+
+	int numvars;
+	int var_capacity;
+	double *obj;
+	double *lb;
+	double *ub;
+	double *start;
+	char *vtype;
+	char **varnames;
+
+	int numconstrs;
+	int constr_capacity;
+	StubRow *rows;
+
+	int numgenconstrs;
+	int genconstr_capacity;
+	StubGenConstr *genconstrs;
+
+	int numobj;
+	StubObjective *objectives;
+
+	int status;
+	int solcount;
+	double *x;
+	double objval;
+	double objbound;
+	double nodecount;
+	double runtime;
+	volatile int terminate;
+	int tuneresultcount;
+	char *iis;
+
+	int (*callback)(CB_ARGS);
+	void *usrdata;
+	struct StubCallbackData *cbdata;
+};
+
+static int stub_error(GRBenv *env, int error, const char *format, ...)
+{
+	va_list args;
+	if (env != NULL) {
+		va_start(args, format);
+		vsnprintf(env->errormsg, GRB_MAX_STRLEN, format, args);
+		va_end(args);
+	}
+	return error;
+}
+
+static char *stub_strdup(const char *s)
+{
+	char *copy = malloc(strlen(s) + 1);
+	if (copy != NULL)
+		strcpy(copy, s);
+	return copy;
+}
+
+static char *stub_default_name(char prefix, int i)
+{
+	char buffer[32];
+	snprintf(buffer, sizeof(buffer), "%c%d", prefix, i);
+	return stub_strdup(buffer);
+}
+
+static double stub_now(void)
+{
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec + 1e-9 * t.tv_nsec;
+}
+
+static void stub_clear_solution(GRBmodel *model)
+{
+	model->status = GRB_LOADED;
+	model->solcount = 0;
+	model->nodecount = 0;
+	model->runtime = 0;
+	free(model->iis);
+	model->iis = NULL;
+}
+
+/*
+	Environments
+*/
+
+static void stub_default_parameters(GRBenv *env)
+{
+	int i;
+	for (i = 0; i < STUB_NUMBER_OF_PARAMETERS; i = i+1){
+		env->values[i] = stub_parameters[i].def;
+		env->strings[i][0] = '\0';
+	}
+}
+
+int GRBloadenv(GRBenv **envP, const char *logfilename)
+{
+	GRBenv *env;
+	if (envP == NULL)
+		return GRB_ERROR_NULL_ARGUMENT;
+	env = calloc(1, sizeof(GRBenv));
+	if (env == NULL)
+		return GRB_ERROR_OUT_OF_MEMORY;
+	stub_default_parameters(env);
+	if (logfilename != NULL)
+		GRBsetstrparam(env, "LogFile", logfilename);
+	*envP = env;
+	return 0;
+}
+
+void GRBfreeenv(GRBenv *env)
+{
+	free(env);
+}
+
+GRBenv *GRBgetenv(GRBmodel *model)
+{
+	if (model == NULL)
+		return NULL;
+	return model->env;
+}
+
+const char *GRBgeterrormsg(GRBenv *env)
+{
+	if (env == NULL)
+		return "No environment";
+	return env->errormsg;
+}
+
+void GRBversion(int *majorP, int *minorP, int *technicalP)
+{
+	*majorP = GRB_VERSION_MAJOR;
+	*minorP = GRB_VERSION_MINOR;
+	*technicalP = GRB_VERSION_TECHNICAL;
+}
+
+/*
+	Parameters
+*/
+
+static int stub_find_parameter(const char *paramname)
+{
+	int i;
+	if (paramname == NULL)
+		return -1;
+	for (i = 0; i < STUB_NUMBER_OF_PARAMETERS; i = i+1)
+		if (strcasecmp(stub_parameters[i].name, paramname) == 0)
+			return i;
+	return -1;
+}
+
+static int stub_lookup_parameter(GRBenv *env, const char *paramname, int type, int *indexP)
+{
+	int i;
+	if (env == NULL)
+		return GRB_ERROR_NULL_ARGUMENT;
+	i = stub_find_parameter(paramname);
+	if (i < 0 || stub_parameters[i].type != type)
+		return stub_error(env, GRB_ERROR_UNKNOWN_PARAMETER, "Unknown parameter '%s'", paramname);
+	*indexP = i;
+	return 0;
+}
+
+static int stub_set_numeric_parameter(GRBenv *env, int i, double value)
+{
+	if (value < stub_parameters[i].min || value > stub_parameters[i].max)
+		return stub_error(env, GRB_ERROR_VALUE_OUT_OF_RANGE, "Unable to set parameter %s to %g (minimum is %g, maximum is %g)",
+				stub_parameters[i].name, value, stub_parameters[i].min, stub_parameters[i].max);
+	env->values[i] = value;
+	return 0;
+}
+
+int GRBgetintparam(GRBenv *env, const char *paramname, int *valueP)
+{
+	int i, error;
+	error = stub_lookup_parameter(env, paramname, STUB_INT_PARAM, &i);
+	if (error)
+		return error;
+	*valueP = (int) env->values[i];
+	return 0;
+}
+
+int GRBsetintparam(GRBenv *env, const char *paramname, int value)
+{
+	int i, error;
+	error = stub_lookup_parameter(env, paramname, STUB_INT_PARAM, &i);
+	if (error)
+		return error;
+	return stub_set_numeric_parameter(env, i, value);
+}
+
+int GRBgetdblparam(GRBenv *env, const char *paramname, double *valueP)
+{
+	int i, error;
+	error = stub_lookup_parameter(env, paramname, STUB_DBL_PARAM, &i);
+	if (error)
+		return error;
+	*valueP = env->values[i];
+	return 0;
+}
+
+int GRBsetdblparam(GRBenv *env, const char *paramname, double value)
+{
+	int i, error;
+	error = stub_lookup_parameter(env, paramname, STUB_DBL_PARAM, &i);
+	if (error)
+		return error;
+	return stub_set_numeric_parameter(env, i, value);
+}
+
+int GRBgetstrparam(GRBenv *env, const char *paramname, char *valueP)
+{
+	int i, error;
+	error = stub_lookup_parameter(env, paramname, STUB_STR_PARAM, &i);
+	if (error)
+		return error;
+	strcpy(valueP, env->strings[i]);
+	return 0;
+}
+
+int GRBsetstrparam(GRBenv *env, const char *paramname, const char *value)
+{
+	int i, error;
+	error = stub_lookup_parameter(env, paramname, STUB_STR_PARAM, &i);
+	if (error)
+		return error;
+	if (value == NULL)
+		return stub_error(env, GRB_ERROR_NULL_ARGUMENT, "No value given for parameter %s", paramname);
+	strncpy(env->strings[i], value, GRB_MAX_STRLEN - 1);
+	env->strings[i][GRB_MAX_STRLEN - 1] = '\0';
+	return 0;
+}
+
+int GRBsetparam(GRBenv *env, const char *paramname, const char *value)
+{
+	int i;
+	char *end;
+	double number;
+	if (env == NULL)
+		return GRB_ERROR_NULL_ARGUMENT;
+	i = stub_find_parameter(paramname);
+	if (i < 0)
+		return stub_error(env, GRB_ERROR_UNKNOWN_PARAMETER, "Unknown parameter '%s'", paramname);
+	if (stub_parameters[i].type == STUB_STR_PARAM)
+		return GRBsetstrparam(env, paramname, value);
+	if (value == NULL)
+		return stub_error(env, GRB_ERROR_NULL_ARGUMENT, "No value given for parameter %s", paramname);
+	if (strcasecmp(value, "inf") == 0 || strcasecmp(value, "infinity") == 0)
+		number = GRB_INFINITY;
+	else if (strcasecmp(value, "-inf") == 0 || strcasecmp(value, "-infinity") == 0)
+		number = -GRB_INFINITY;
+	else {
+		number = strtod(value, &end);
+		if (end == value || *end != '\0')
+			return stub_error(env, GRB_ERROR_INVALID_ARGUMENT, "Invalid value '%s' for parameter %s", value, paramname);
+	}
+	if (stub_parameters[i].type == STUB_INT_PARAM && number != floor(number))
+		return stub_error(env, GRB_ERROR_INVALID_ARGUMENT, "Invalid value '%s' for parameter %s", value, paramname);
+	return stub_set_numeric_parameter(env, i, number);
+}
+
+int GRBgetintparaminfo(GRBenv *env, const char *paramname, int *valueP, int *minP, int *maxP, int *defP)
+{
+	int i, error;
+	error = stub_lookup_parameter(env, paramname, STUB_INT_PARAM, &i);
+	if (error)
+		return error;
+	if (valueP != NULL)
+		*valueP = (int) env->values[i];
+	if (minP != NULL)
+		*minP = (int) stub_parameters[i].min;
+	if (maxP != NULL)
+		*maxP = (int) stub_parameters[i].max;
+	if (defP != NULL)
+		*defP = (int) stub_parameters[i].def;
+	return 0;
+}
+
+int GRBgetdblparaminfo(GRBenv *env, const char *paramname, double *valueP, double *minP, double *maxP, double *defP)
+{
+	int i, error;
+	error = stub_lookup_parameter(env, paramname, STUB_DBL_PARAM, &i);
+	if (error)
+		return error;
+	if (valueP != NULL)
+		*valueP = env->values[i];
+	if (minP != NULL)
+		*minP = stub_parameters[i].min;
+	if (maxP != NULL)
+		*maxP = stub_parameters[i].max;
+	if (defP != NULL)
+		*defP = stub_parameters[i].def;
+	return 0;
+}
+
+int GRBgetstrparaminfo(GRBenv *env, const char *paramname, char *valueP, char *defP)
+{
+	int i, error;
+	error = stub_lookup_parameter(env, paramname, STUB_STR_PARAM, &i);
+	if (error)
+		return error;
+	if (valueP != NULL)
+		strcpy(valueP, env->strings[i]);
+	if (defP != NULL)
+		defP[0] = '\0';
+	return 0;
+}
+
+int GRBgetparamtype(GRBenv *env, const char *paramname)
+{
+	int i = stub_find_parameter(paramname);
+	if (i < 0)
+		return -1;
+	return stub_parameters[i].type;
+}
+
+int GRBgetnumparams(GRBenv *env)
+{
+	return STUB_NUMBER_OF_PARAMETERS;
+}
+
+int GRBgetparamname(GRBenv *env, int i, char **paramnameP)
+{
+	if (i < 0 || i >= STUB_NUMBER_OF_PARAMETERS)
+		return stub_error(env, GRB_ERROR_INDEX_OUT_OF_RANGE, "Parameter index %d out of range", i);
+	*paramnameP = (char *) stub_parameters[i].name;
+	return 0;
+}
+
+int GRBcopyparams(GRBenv *dest, GRBenv *src)
+{
+	if (dest == NULL || src == NULL)
+		return GRB_ERROR_NULL_ARGUMENT;
+	memcpy(dest->values, src->values, sizeof(dest->values));
+	memcpy(dest->strings, src->strings, sizeof(dest->strings));
+	return 0;
+}
+
+int GRBresetparams(GRBenv *env)
+{
+	if (env == NULL)
+		return GRB_ERROR_NULL_ARGUMENT;
+	stub_default_parameters(env);
+	return 0;
+}
+
+int GRBreadparams(GRBenv *env, const char *filename)
+{
+	FILE *file;
+	char line[2*GRB_MAX_STRLEN], name[GRB_MAX_STRLEN], value[GRB_MAX_STRLEN];
+	int error = 0;
+	if (env == NULL || filename == NULL)
+		return GRB_ERROR_NULL_ARGUMENT;
+	file = fopen(filename, "r");
+	if (file == NULL)
+		return stub_error(env, GRB_ERROR_FILE_READ, "Unable to open file '%s' for input", filename);
+	while (error == 0 && fgets(line, sizeof(line), file) != NULL){
+		if (line[0] == '#' || sscanf(line, "%511s %511s", name, value) != 2)
+			continue;
+		error = GRBsetparam(env, name, value);
+	}
+	fclose(file);
+	return error;
+}
+
+int GRBwriteparams(GRBenv *env, const char *filename)
+{
+	FILE *file;
+	int i;
+	if (env == NULL || filename == NULL)
+		return GRB_ERROR_NULL_ARGUMENT;
+	file = fopen(filename, "w");
+	if (file == NULL)
+		return stub_error(env, GRB_ERROR_FILE_WRITE, "Unable to open file '%s' for output", filename);
+	fprintf(file, "# Parameter settings\n");
+	for (i = 0; i < STUB_NUMBER_OF_PARAMETERS; i = i+1){
+		if (stub_parameters[i].type == STUB_STR_PARAM){
+			if (env->strings[i][0] != '\0')
+				fprintf(file, "%s  %s\n", stub_parameters[i].name, env->strings[i]);
+		}
+		else if (env->values[i] != stub_parameters[i].def)
+			fprintf(file, "%s  %.17g\n", stub_parameters[i].name, env->values[i]);
+	}
+	fclose(file);
+	return 0;
+}
+
+/*
+	Creating and changing models
+*/
+
+static int stub_reserve_vars(GRBmodel *model, int numvars)
+{
+	int capacity;
+	if (numvars <= model->var_capacity)
+		return 0;
+	capacity = 2*model->var_capacity;
+	if (capacity < numvars)
+		capacity = numvars;
+	if (capacity < 16)
+		capacity = 16;
+	model->obj = realloc(model->obj, capacity * sizeof(double));
+	model->lb = realloc(model->lb, capacity * sizeof(double));
+	model->ub = realloc(model->ub, capacity * sizeof(double));
+	model->start = realloc(model->start, capacity * sizeof(double));
+	model->x = realloc(model->x, capacity * sizeof(double));
+	model->vtype = realloc(model->vtype, capacity * sizeof(char));
+	model->varnames = realloc(model->varnames, capacity * sizeof(char *));
+	if (model->obj == NULL || model->lb == NULL || model->ub == NULL || model->start == NULL
+			|| model->x == NULL || model->vtype == NULL || model->varnames == NULL)
+		return stub_error(model->env, GRB_ERROR_OUT_OF_MEMORY, "Out of memory");
+	model->var_capacity = capacity;
+	return 0;
+}
+
+static int stub_reserve_constrs(GRBmodel *model, int numconstrs)
+{
+	int capacity;
+	if (numconstrs <= model->constr_capacity)
+		return 0;
+	capacity = 2*model->constr_capacity;
+	if (capacity < numconstrs)
+		capacity = numconstrs;
+	if (capacity < 16)
+		capacity = 16;
+	model->rows = realloc(model->rows, capacity * sizeof(StubRow));
+	if (model->rows == NULL)
+		return stub_error(model->env, GRB_ERROR_OUT_OF_MEMORY, "Out of memory");
+	model->constr_capacity = capacity;
+	return 0;
+}
+
+static int stub_reserve_row(GRBmodel *model, StubRow *row, int numnz)
+{
+	int capacity;
+	if (numnz <= row->capacity)
+		return 0;
+	capacity = 2*row->capacity;
+	if (capacity < numnz)
+		capacity = numnz;
+	if (capacity < 4)
+		capacity = 4;
+	row->ind = realloc(row->ind, capacity * sizeof(int));
+	row->val = realloc(row->val, capacity * sizeof(double));
+	if (row->ind == NULL || row->val == NULL)
+		return stub_error(model->env, GRB_ERROR_OUT_OF_MEMORY, "Out of memory");
+	row->capacity = capacity;
+	return 0;
+}
+
+static int stub_check_vtype(GRBmodel *model, char vtype)
+{
+	if (vtype == GRB_CONTINUOUS || vtype == GRB_BINARY || vtype == GRB_INTEGER
+			|| vtype == GRB_SEMICONT || vtype == GRB_SEMIINT)
+		return 0;
+	return stub_error(model->env, GRB_ERROR_INVALID_ARGUMENT, "Invalid variable type '%c'", vtype);
+}
+
+static int stub_check_sense(GRBmodel *model, char sense)
+{
+	if (sense == GRB_LESS_EQUAL || sense == GRB_GREATER_EQUAL || sense == GRB_EQUAL)
+		return 0;
+	return stub_error(model->env, GRB_ERROR_INVALID_ARGUMENT, "Invalid constraint sense '%c'", sense);
+}
+
+int GRBnewmodel(GRBenv *env, GRBmodel **modelP, const char *Pname, int numvars,
+		double *obj, double *lb, double *ub, char *vtype, char **varnames)
+{
+	GRBmodel *model;
+	int error;
+	if (env == NULL || modelP == NULL)
+		return GRB_ERROR_NULL_ARGUMENT;
+	*modelP = NULL;
+	model = calloc(1, sizeof(GRBmodel));
+	if (model == NULL)
+		return GRB_ERROR_OUT_OF_MEMORY;
+	model->env = malloc(sizeof(GRBenv));
+	if (model->env == NULL){
+		free(model);
+		return GRB_ERROR_OUT_OF_MEMORY;
+	}
+	memcpy(model->env, env, sizeof(GRBenv));
+	model->name = stub_strdup(Pname == NULL ? "" : Pname);
+	model->sense = GRB_MINIMIZE;
+	stub_clear_solution(model);
+	error = GRBaddvars(model, numvars, 0, NULL, NULL, NULL, obj, lb, ub, vtype, varnames);
+	if (error){
+		strcpy(env->errormsg, model->env->errormsg);
+		GRBfreemodel(model);
+		return error;
+	}
+	*modelP = model;
+	return 0;
+}
+
+int GRBfreemodel(GRBmodel *model)
+{
+	int i;
+	if (model == NULL)
+		return 0;
+	for (i = 0; i < model->numvars; i = i+1)
+		free(model->varnames[i]);
+	for (i = 0; i < model->numconstrs; i = i+1){
+		free(model->rows[i].ind);
+		free(model->rows[i].val);
+		free(model->rows[i].name);
+	}
+	free(model->obj);
+	free(model->lb);
+	free(model->ub);
+	free(model->start);
+	free(model->x);
+	free(model->vtype);
+	free(model->varnames);
+	free(model->rows);
+	for (i = 0; i < model->numgenconstrs; i = i+1){
+		free(model->genconstrs[i].vars);
+		free(model->genconstrs[i].vals);
+	}
+	free(model->genconstrs);
+	for (i = 0; i < model->numobj; i = i+1){
+		free(model->objectives[i].ind);
+		free(model->objectives[i].val);
+	}
+	free(model->objectives);
+	free(model->name);
+	free(model->iis);
+	free(model->env);
+	free(model);
+	return 0;
+}
+
+static int stub_add_genconstr(GRBmodel *model, int type, int resvar, int binval, int nvars, const int *vars,
+		const double *vals, char sense, double rhs)
+{
+	StubGenConstr *g;
+	int i, capacity;
+	if (resvar < -1 || resvar >= model->numvars)
+		return stub_error(model->env, GRB_ERROR_INDEX_OUT_OF_RANGE, "Variable index %d out of range", resvar);
+	for (i = 0; i < nvars; i = i+1)
+		if (vars[i] < 0 || vars[i] >= model->numvars)
+			return stub_error(model->env, GRB_ERROR_INDEX_OUT_OF_RANGE, "Variable index %d out of range", vars[i]);
+	if (model->numgenconstrs == model->genconstr_capacity){
+		capacity = model->genconstr_capacity < 16 ? 16 : 2*model->genconstr_capacity;
+		g = realloc(model->genconstrs, capacity * sizeof(StubGenConstr));
+		if (g == NULL)
+			return stub_error(model->env, GRB_ERROR_OUT_OF_MEMORY, "Out of memory");
+		model->genconstrs = g;
+		model->genconstr_capacity = capacity;
+	}
+	g = &model->genconstrs[model->numgenconstrs];
+	g->type = type;
+	g->resvar = resvar;
+	g->binval = binval;
+	g->nvars = nvars;
+	g->sense = sense;
+	g->rhs = rhs;
+	g->vars = malloc((nvars + 1) * sizeof(int));
+	g->vals = malloc((nvars + 1) * sizeof(double));
+	if (g->vars == NULL || g->vals == NULL){
+		free(g->vars);
+		free(g->vals);
+		return stub_error(model->env, GRB_ERROR_OUT_OF_MEMORY, "Out of memory");
+	}
+	for (i = 0; i < nvars; i = i+1){
+		g->vars[i] = vars[i];
+		g->vals[i] = (vals == NULL) ? 1.0 : vals[i];
+	}
+	model->numgenconstrs = model->numgenconstrs + 1;
+	stub_clear_solution(model);
+	return 0;
+}
+
+/* Copies a model into an environment, whose parameters the copy takes */
+static GRBmodel *stub_copy_model(GRBmodel *model, GRBenv *env)
+{
+	GRBmodel *copy;
+	int i, error;
+	if (model == NULL || env == NULL)
+		return NULL;
+	if (GRBnewmodel(env, &copy, model->name, model->numvars, model->obj, model->lb,
+			model->ub, model->vtype, model->varnames))
+		return NULL;
+	copy->sense = model->sense;
+	copy->objcon = model->objcon;
+	memcpy(copy->start, model->start, model->numvars * sizeof(double));
+	error = stub_reserve_constrs(copy, model->numconstrs);
+	for (i = 0; error == 0 && i < model->numconstrs; i = i+1)
+		error = GRBaddconstr(copy, model->rows[i].numnz, model->rows[i].ind, model->rows[i].val,
+				model->rows[i].sense, model->rows[i].rhs, model->rows[i].name);
+	for (i = 0; error == 0 && i < model->numgenconstrs; i = i+1){
+		StubGenConstr *g = &model->genconstrs[i];
+		error = stub_add_genconstr(copy, g->type, g->resvar, g->binval, g->nvars, g->vars, g->vals, g->sense, g->rhs);
+	}
+	for (i = 0; error == 0 && i < model->numobj; i = i+1){
+		StubObjective *o = &model->objectives[i];
+		error = GRBsetobjectiven(copy, i, o->priority, o->weight, o->abstol, o->reltol, NULL,
+				i == 0 ? model->objcon : o->constant, i == 0 ? 0 : o->numnz, o->ind, o->val);
+		if (i == 0)
+			memcpy(copy->obj, model->obj, model->numvars * sizeof(double));
+	}
+	if (error){
+		GRBfreemodel(copy);
+		return NULL;
+	}
+	return copy;
+}
+
+GRBmodel *GRBcopymodel(GRBmodel *model)
+{
+	return model == NULL ? NULL : stub_copy_model(model, model->env);
+}
+
+GRBmodel *GRBcopymodeltoenv(GRBmodel *model, GRBenv *targetenv)
+{
+	return stub_copy_model(model, targetenv);
+}
+
+/* The stub does no presolve, so the presolved model is a copy */
+GRBmodel *GRBpresolvemodel(GRBmodel *model)
+{
+	return GRBcopymodel(model);
+}
+
+int GRBupdatemodel(GRBmodel *model)
+{
+	if (model == NULL)
+		return GRB_ERROR_NULL_ARGUMENT;
+	return 0;
+}
+
+int GRBresetmodel(GRBmodel *model)
+{
+	if (model == NULL)
+		return GRB_ERROR_NULL_ARGUMENT;
+	stub_clear_solution(model);
+	return 0;
+}
+
+int GRBaddvars(GRBmodel *model, int numvars, int numnz, int *vbeg, int *vind, double *vval,
+		double *obj, double *lb, double *ub, char *vtype, char **varnames)
+{
+	int i, j, k, end, error;
+	StubRow *row;
+	if (model == NULL)
+		return GRB_ERROR_NULL_ARGUMENT;
+	if (numvars < 0 || numnz < 0)
+		return stub_error(model->env, GRB_ERROR_INVALID_ARGUMENT, "Invalid number of variables");
+	if (numnz > 0 && (vbeg == NULL || vind == NULL || vval == NULL))
+		return stub_error(model->env, GRB_ERROR_NULL_ARGUMENT, "No coefficients given");
+	for (i = 0; i < numnz; i = i+1)
+		if (vind[i] < 0 || vind[i] >= model->numconstrs)
+			return stub_error(model->env, GRB_ERROR_INDEX_OUT_OF_RANGE, "Constraint index %d out of range", vind[i]);
+	if (vtype != NULL)
+		for (i = 0; i < numvars; i = i+1)
+			if ((error = stub_check_vtype(model, vtype[i])))
+				return error;
+	error = stub_reserve_vars(model, model->numvars + numvars);
+	if (error)
+		return error;
+	for (i = 0; i < numvars; i = i+1){
+		j = model->numvars + i;
+		model->vtype[j] = vtype == NULL ? GRB_CONTINUOUS : vtype[i];
+		model->obj[j] = obj == NULL ? 0.0 : obj[i];
+		model->lb[j] = lb == NULL ? 0.0 : lb[i];
+		if (ub != NULL)
+			model->ub[j] = ub[i];
+		else
+			model->ub[j] = model->vtype[j] == GRB_BINARY ? 1.0 : GRB_INFINITY;
+		model->start[j] = GRB_UNDEFINED;
+		model->x[j] = 0.0;
+		if (varnames != NULL && varnames[i] != NULL)
+			model->varnames[j] = stub_strdup(varnames[i]);
+		else
+			model->varnames[j] = stub_default_name('C', j);
+		if (numnz == 0)
+			continue;
+		end = (i+1 < numvars) ? vbeg[i+1] : numnz;
+		for (k = vbeg[i]; k < end; k = k+1){
+			row = &model->rows[vind[k]];
+			if ((error = stub_reserve_row(model, row, row->numnz + 1)))
+				return error;
+			row->ind[row->numnz] = j;
+			row->val[row->numnz] = vval[k];
+			row->numnz = row->numnz + 1;
+		}
+	}
+	model->numvars = model->numvars + numvars;
+	stub_clear_solution(model);
+	return 0;
+}
+
+int GRBaddconstr(GRBmodel *model, int numnz, int *cind, double *cval, char sense,
+		double rhs, const char *constrname)
+{
+	StubRow *row;
+	int i, error;
+	if (model == NULL)
+		return GRB_ERROR_NULL_ARGUMENT;
+	if (numnz < 0 || (numnz > 0 && (cind == NULL || cval == NULL)))
+		return stub_error(model->env, GRB_ERROR_INVALID_ARGUMENT, "Invalid constraint coefficients");
+	for (i = 0; i < numnz; i = i+1)
+		if (cind[i] < 0 || cind[i] >= model->numvars)
+			return stub_error(model->env, GRB_ERROR_INDEX_OUT_OF_RANGE, "Variable index %d out of range", cind[i]);
+	if ((error = stub_check_sense(model, sense)))
+		return error;
+	if ((error = stub_reserve_constrs(model, model->numconstrs + 1)))
+		return error;
+	row = &model->rows[model->numconstrs];
+	memset(row, 0, sizeof(StubRow));
+	if ((error = stub_reserve_row(model, row, numnz)))
+		return error;
+	memcpy(row->ind, cind, numnz * sizeof(int));
+	memcpy(row->val, cval, numnz * sizeof(double));
+	row->numnz = numnz;
+	row->sense = sense;
+	row->rhs = rhs;
+	if (constrname != NULL)
+		row->name = stub_strdup(constrname);
+	else
+		row->name = stub_default_name('R', model->numconstrs);
+	model->numconstrs = model->numconstrs + 1;
+	stub_clear_solution(model);
+	return 0;
+}
+
+int GRBaddconstrs(GRBmodel *model, int numconstrs, int numnz, int *cbeg, int *cind,
+		double *cval, char *sense, double *rhs, char **constrnames)
+{
+	int i, begin, end, error;
+	if (model == NULL)
+		return GRB_ERROR_NULL_ARGUMENT;
+	if (numconstrs < 0 || (numconstrs > 0 && (cbeg == NULL || sense == NULL)))
+		return stub_error(model->env, GRB_ERROR_INVALID_ARGUMENT, "Invalid constraints");
+	for (i = 0; i < numconstrs; i = i+1){
+		begin = cbeg[i];
+		end = (i+1 < numconstrs) ? cbeg[i+1] : numnz;
+		error = GRBaddconstr(model, end - begin, cind + begin, cval + begin, sense[i],
+				rhs == NULL ? 0.0 : rhs[i], constrnames == NULL ? NULL : constrnames[i]);
+		if (error)
+			return error;
+	}
+	return 0;
+}
+
+int GRBdelconstrs(GRBmodel *model, int len, int *ind)
+{
+	char *deleted;
+	int i, j;
+	if (model == NULL)
+		return GRB_ERROR_NULL_ARGUMENT;
+	for (i = 0; i < len; i = i+1)
+		if (ind[i] < 0 || ind[i] >= model->numconstrs)
+			return stub_error(model->env, GRB_ERROR_INDEX_OUT_OF_RANGE, "Constraint index %d out of range", ind[i]);
+	deleted = calloc(model->numconstrs + 1, sizeof(char));
+	if (deleted == NULL)
+		return stub_error(model->env, GRB_ERROR_OUT_OF_MEMORY, "Out of memory");
+	for (i = 0; i < len; i = i+1)
+		deleted[ind[i]] = 1;
+	j = 0;
+	for (i = 0; i < model->numconstrs; i = i+1){
+		if (deleted[i]){
+			free(model->rows[i].ind);
+			free(model->rows[i].val);
+			free(model->rows[i].name);
+		}
+		else {
+			model->rows[j] = model->rows[i];
+			j = j+1;
+		}
+	}
+	model->numconstrs = j;
+	free(deleted);
+	stub_clear_solution(model);
+	return 0;
+}
+
+int GRBchgcoeffs(GRBmodel *model, int cnt, int *cind, int *vind, double *val)
+{
+	StubRow *row;
+	int i, k, error;
+	if (model == NULL)
+		return GRB_ERROR_NULL_ARGUMENT;
+	for (i = 0; i < cnt; i = i+1){
+		if (cind[i] < 0 || cind[i] >= model->numconstrs)
+			return stub_error(model->env, GRB_ERROR_INDEX_OUT_OF_RANGE, "Constraint index %d out of range", cind[i]);
+		if (vind[i] < 0 || vind[i] >= model->numvars)
+			return stub_error(model->env, GRB_ERROR_INDEX_OUT_OF_RANGE, "Variable index %d out of range", vind[i]);
+	}
+	for (i = 0; i < cnt; i = i+1){
+		row = &model->rows[cind[i]];
+		for (k = 0; k < row->numnz && row->ind[k] != vind[i]; k = k+1)
+			;
+		if (k == row->numnz){
+			if (val[i] == 0.0)
+				continue;
+			if ((error = stub_reserve_row(model, row, row->numnz + 1)))
+				return error;
+			row->ind[k] = vind[i];
+			row->numnz = row->numnz + 1;
+		}
+		if (val[i] == 0.0){
+			row->numnz = row->numnz - 1;
+			row->ind[k] = row->ind[row->numnz];
+			row->val[k] = row->val[row->numnz];
+		}
+		else
+			row->val[k] = val[i];
+	}
+	stub_clear_solution(model);
+	return 0;
+}
+
+int GRBaddgenconstrIndicator(GRBmodel *model, const char *name, int binvar, int binval, int nvars,
+		const int *ind, const double *val, char sense, double rhs)
+{
+	int error;
+	if (model == NULL)
+		return GRB_ERROR_NULL_ARGUMENT;
+	if (binvar < 0 || (binval != 0 && binval != 1))
+		return stub_error(model->env, GRB_ERROR_INVALID_ARGUMENT, "Invalid indicator variable or value");
+	if ((error = stub_check_sense(model, sense)))
+		return error;
+	return stub_add_genconstr(model, STUB_GENCONSTR_INDICATOR, binvar, binval, nvars, ind, val, sense, rhs);
+}
+
+int GRBaddgenconstrMax(GRBmodel *model, const char *name, int resvar, int nvars, const int *vars, double constant)
+{
+	if (model == NULL)
+		return GRB_ERROR_NULL_ARGUMENT;
+	return stub_add_genconstr(model, STUB_GENCONSTR_MAX, resvar, 0, nvars, vars, NULL, 0, constant);
+}
+
+int GRBaddgenconstrMin(GRBmodel *model, const char *name, int resvar, int nvars, const int *vars, double constant)
+{
+	if (model == NULL)
+		return GRB_ERROR_NULL_ARGUMENT;
+	return stub_add_genconstr(model, STUB_GENCONSTR_MIN, resvar, 0, nvars, vars, NULL, 0, constant);
+}
+
+int GRBaddgenconstrAbs(GRBmodel *model, const char *name, int resvar, int argvar)
+{
+	if (model == NULL)
+		return GRB_ERROR_NULL_ARGUMENT;
+	return stub_add_genconstr(model, STUB_GENCONSTR_ABS, resvar, 0, 1, &argvar, NULL, 0, 0);
+}
+
+int GRBaddgenconstrAnd(GRBmodel *model, const char *name, int resvar, int nvars, const int *vars)
+{
+	if (model == NULL)
+		return GRB_ERROR_NULL_ARGUMENT;
+	return stub_add_genconstr(model, STUB_GENCONSTR_AND, resvar, 0, nvars, vars, NULL, 0, 0);
+}
+
+int GRBaddgenconstrOr(GRBmodel *model, const char *name, int resvar, int nvars, const int *vars)
+{
+	if (model == NULL)
+		return GRB_ERROR_NULL_ARGUMENT;
+	return stub_add_genconstr(model, STUB_GENCONSTR_OR, resvar, 0, nvars, vars, NULL, 0, 0);
+}
+
+int GRBaddsos(GRBmodel *model, int numsos, int nummembers, int *types, int *beg, int *ind, double *weight)
+{
+	int i, end, error;
+	if (model == NULL)
+		return GRB_ERROR_NULL_ARGUMENT;
+	for (i = 0; i < numsos; i = i+1){
+		if (types[i] != GRB_SOS_TYPE1 && types[i] != GRB_SOS_TYPE2)
+			return stub_error(model->env, GRB_ERROR_INVALID_ARGUMENT, "Invalid SOS type %d", types[i]);
+		end = (i+1 < numsos) ? beg[i+1] : nummembers;
+		error = stub_add_genconstr(model, types[i] == GRB_SOS_TYPE1 ? STUB_SOS1 : STUB_SOS2, -1, 0,
+				end - beg[i], ind + beg[i], weight + beg[i], 0, 0);
+		if (error)
+			return error;
+	}
+	return 0;
+}
+
+/*
+	Objectives
+*/
+
+static int stub_set_numobj(GRBmodel *model, int numobj)
+{
+	StubObjective *objectives;
+	int i;
+	for (i = numobj; i < model->numobj; i = i+1){
+		free(model->objectives[i].ind);
+		free(model->objectives[i].val);
+	}
+	objectives = realloc(model->objectives, numobj * sizeof(StubObjective));
+	if (objectives == NULL)
+		return stub_error(model->env, GRB_ERROR_OUT_OF_MEMORY, "Out of memory");
+	for (i = model->numobj; i < numobj; i = i+1){
+		memset(&objectives[i], 0, sizeof(StubObjective));
+		objectives[i].weight = 1.0;
+		objectives[i].abstol = 1e-6;
+	}
+	model->objectives = objectives;
+	model->numobj = numobj;
+	return 0;
+}
+
+int GRBsetobjectiven(GRBmodel *model, int index, int priority, double weight, double abstol, double reltol,
+		const char *name, double constant, int lnz, int *lind, double *lval)
+{
+	StubObjective *o;
+	int k, error;
+	if (model == NULL)
+		return GRB_ERROR_NULL_ARGUMENT;
+	if (index < 0)
+		return stub_error(model->env, GRB_ERROR_INDEX_OUT_OF_RANGE, "Objective index %d out of range", index);
+	for (k = 0; k < lnz; k = k+1)
+		if (lind[k] < 0 || lind[k] >= model->numvars)
+			return stub_error(model->env, GRB_ERROR_INDEX_OUT_OF_RANGE, "Variable index %d out of range", lind[k]);
+	if (index >= model->numobj){
+		error = stub_set_numobj(model, index+1);
+		if (error)
+			return error;
+	}
+	o = &model->objectives[index];
+	o->priority = priority;
+	o->weight = weight;
+	o->abstol = abstol;
+	o->reltol = reltol;
+	if (index == 0){
+		memset(model->obj, 0, model->numvars * sizeof(double));
+		for (k = 0; k < lnz; k = k+1)
+			model->obj[lind[k]] = model->obj[lind[k]] + lval[k];
+		model->objcon = constant;
+	}
+	else {
+		o->constant = constant;
+		o->ind = realloc(o->ind, (lnz + 1) * sizeof(int));
+		o->val = realloc(o->val, (lnz + 1) * sizeof(double));
+		if (o->ind == NULL || o->val == NULL)
+			return stub_error(model->env, GRB_ERROR_OUT_OF_MEMORY, "Out of memory");
+		memcpy(o->ind, lind, lnz * sizeof(int));
+		memcpy(o->val, lval, lnz * sizeof(double));
+		o->numnz = lnz;
+	}
+	stub_clear_solution(model);
+	return 0;
+}
+
+static double stub_objective_value(GRBmodel *model, int index, double *x)
+{
+	StubObjective *o;
+	double value;
+	int k;
+	if (index == 0){
+		value = model->objcon;
+		for (k = 0; k < model->numvars; k = k+1)
+			value = value + model->obj[k] * x[k];
+		return value;
+	}
+	o = &model->objectives[index];
+	value = o->constant;
+	for (k = 0; k < o->numnz; k = k+1)
+		value = value + o->val[k] * x[o->ind[k]];
+	return value;
+}
+
+int GRBgetconstrs(GRBmodel *model, int *numnzP, int *cbeg, int *cind, double *cval,
+		int start, int len)
+{
+	int i, k, numnz;
+	if (model == NULL || numnzP == NULL)
+		return GRB_ERROR_NULL_ARGUMENT;
+	if (start < 0 || len < 0 || start + len > model->numconstrs)
+		return stub_error(model->env, GRB_ERROR_INDEX_OUT_OF_RANGE, "Constraint index out of range");
+	numnz = 0;
+	for (i = 0; i < len; i = i+1){
+		if (cbeg != NULL)
+			cbeg[i] = numnz;
+		for (k = 0; k < model->rows[start + i].numnz; k = k+1){
+			if (cind != NULL)
+				cind[numnz] = model->rows[start + i].ind[k];
+			if (cval != NULL)
+				cval[numnz] = model->rows[start + i].val[k];
+			numnz = numnz + 1;
+		}
+	}
+	*numnzP = numnz;
+	return 0;
+}
+
+int GRBgetconstrbyname(GRBmodel *model, const char *name, int *constrnumP)
+{
+	int i;
+	if (model == NULL || name == NULL || constrnumP == NULL)
+		return GRB_ERROR_NULL_ARGUMENT;
+	*constrnumP = -1;
+	for (i = 0; i < model->numconstrs; i = i+1)
+		if (strcmp(model->rows[i].name, name) == 0){
+			*constrnumP = i;
+			break;
+		}
+	return 0;
+}
+
+int GRBgetvarbyname(GRBmodel *model, const char *name, int *varnumP)
+{
+	int i;
+	if (model == NULL || name == NULL || varnumP == NULL)
+		return GRB_ERROR_NULL_ARGUMENT;
+	*varnumP = -1;
+	for (i = 0; i < model->numvars; i = i+1)
+		if (strcmp(model->varnames[i], name) == 0){
+			*varnumP = i;
+			break;
+		}
+	return 0;
+}
+
+/*
+	Attributes
+*/
+
+static int stub_unknown_attribute(GRBmodel *model, const char *attrname)
+{
+	return stub_error(model->env, GRB_ERROR_UNKNOWN_ATTRIBUTE, "Unknown attribute '%s'", attrname);
+}
+
+static int stub_is_attribute(const char *attrname, const char *name)
+{
+	return attrname != NULL && strcasecmp(attrname, name) == 0;
+}
+
+static int stub_no_solution(GRBmodel *model)
+{
+	return stub_error(model->env, GRB_ERROR_DATA_NOT_AVAILABLE, "Unable to retrieve attribute, no solution available");
+}
+
+static int stub_check_var(GRBmodel *model, int element)
+{
+	if (element < 0 || element >= model->numvars)
+		return stub_error(model->env, GRB_ERROR_INDEX_OUT_OF_RANGE, "Variable index %d out of range", element);
+	return 0;
+}
+
+static int stub_check_constr(GRBmodel *model, int element)
+{
+	if (element < 0 || element >= model->numconstrs)
+		return stub_error(model->env, GRB_ERROR_INDEX_OUT_OF_RANGE, "Constraint index %d out of range", element);
+	return 0;
+}
+
+static int stub_is_integral(char vtype)
+{
+	return vtype == GRB_BINARY || vtype == GRB_INTEGER || vtype == GRB_SEMIINT;
+}
+
+int GRBgetintattr(GRBmodel *model, const char *attrname, int *valueP)
+{
+	int i, count;
+	if (model == NULL || valueP == NULL)
+		return GRB_ERROR_NULL_ARGUMENT;
+	if (stub_is_attribute(attrname, "NumVars"))
+		*valueP = model->numvars;
+	else if (stub_is_attribute(attrname, "NumConstrs"))
+		*valueP = model->numconstrs;
+	else if (stub_is_attribute(attrname, "NumNZs")){
+		count = 0;
+		for (i = 0; i < model->numconstrs; i = i+1)
+			count = count + model->rows[i].numnz;
+		*valueP = count;
+	}
+	else if (stub_is_attribute(attrname, "NumIntVars") || stub_is_attribute(attrname, "IsMIP")){
+		count = 0;
+		for (i = 0; i < model->numvars; i = i+1)
+			if (stub_is_integral(model->vtype[i]))
+				count = count + 1;
+		*valueP = stub_is_attribute(attrname, "IsMIP") ? (count > 0) : count;
+	}
+	else if (stub_is_attribute(attrname, "NumBinVars")){
+		count = 0;
+		for (i = 0; i < model->numvars; i = i+1)
+			if (model->vtype[i] == GRB_BINARY || (model->vtype[i] == GRB_INTEGER && model->lb[i] == 0.0 && model->ub[i] == 1.0))
+				count = count + 1;
+		*valueP = count;
+	}
+	else if (stub_is_attribute(attrname, "ModelSense"))
+		*valueP = model->sense;
+	else if (stub_is_attribute(attrname, "Status"))
+		*valueP = model->status;
+	else if (stub_is_attribute(attrname, "SolCount"))
+		*valueP = model->solcount;
+	else if (stub_is_attribute(attrname, "NumGenConstrs") || stub_is_attribute(attrname, "NumSOS")){
+		count = 0;
+		for (i = 0; i < model->numgenconstrs; i = i+1)
+			if ((model->genconstrs[i].type >= STUB_SOS1) == stub_is_attribute(attrname, "NumSOS"))
+				count = count + 1;
+		*valueP = count;
+	}
+	else if (stub_is_attribute(attrname, "TuneResultCount"))
+		*valueP = model->tuneresultcount;
+	else if (stub_is_attribute(attrname, "NumObj"))
+		*valueP = model->numobj > 0 ? model->numobj : 1;
+	else
+		return stub_unknown_attribute(model, attrname);
+	return 0;
+}
+
+int GRBsetintattr(GRBmodel *model, const char *attrname, int newvalue)
+{
+	if (model == NULL)
+		return GRB_ERROR_NULL_ARGUMENT;
+	if (stub_is_attribute(attrname, "ModelSense")){
+		if (newvalue != GRB_MINIMIZE && newvalue != GRB_MAXIMIZE)
+			return stub_error(model->env, GRB_ERROR_VALUE_OUT_OF_RANGE, "Invalid value %d for attribute ModelSense", newvalue);
+		model->sense = newvalue;
+		stub_clear_solution(model);
+		return 0;
+	}
+	if (stub_is_attribute(attrname, "NumObj")){
+		if (newvalue < 1)
+			return stub_error(model->env, GRB_ERROR_VALUE_OUT_OF_RANGE, "Invalid value %d for attribute NumObj", newvalue);
+		stub_clear_solution(model);
+		return stub_set_numobj(model, newvalue);
+	}
+	return stub_unknown_attribute(model, attrname);
+}
+
+int GRBgetdblattr(GRBmodel *model, const char *attrname, double *valueP)
+{
+	if (model == NULL || valueP == NULL)
+		return GRB_ERROR_NULL_ARGUMENT;
+	if (stub_is_attribute(attrname, "ObjCon"))
+		*valueP = model->objcon;
+	else if (stub_is_attribute(attrname, "Runtime"))
+		*valueP = model->runtime;
+	else if (stub_is_attribute(attrname, "NodeCount"))
+		*valueP = model->nodecount;
+	else if (stub_is_attribute(attrname, "IterCount"))
+		*valueP = 0.0;
+	else if (stub_is_attribute(attrname, "ObjVal")){
+		if (model->solcount == 0)
+			return stub_no_solution(model);
+		*valueP = model->objval;
+	}
+	else if (stub_is_attribute(attrname, "ObjNVal")){
+		int k = 0;
+		GRBgetintparam(model->env, "ObjNumber", &k);
+		if (k >= (model->numobj > 0 ? model->numobj : 1))
+			return stub_error(model->env, GRB_ERROR_INDEX_OUT_OF_RANGE, "Objective number %d out of range", k);
+		if (model->solcount == 0)
+			return stub_no_solution(model);
+		*valueP = stub_objective_value(model, k, model->x);
+	}
+	else if (stub_is_attribute(attrname, "ObjBound")){
+		if (model->status == GRB_LOADED)
+			return stub_no_solution(model);
+		*valueP = model->objbound;
+	}
+	else if (stub_is_attribute(attrname, "MIPGap")){
+		if (model->solcount == 0)
+			return stub_no_solution(model);
+		if (model->objval == model->objbound)
+			*valueP = 0.0;
+		else if (model->objval == 0.0)
+			*valueP = GRB_INFINITY;
+		else
+			*valueP = fabs(model->objval - model->objbound) / fabs(model->objval);
+	}
+	else
+		return stub_unknown_attribute(model, attrname);
+	return 0;
+}
+
+int GRBsetdblattr(GRBmodel *model, const char *attrname, double newvalue)
+{
+	if (model == NULL)
+		return GRB_ERROR_NULL_ARGUMENT;
+	if (stub_is_attribute(attrname, "ObjCon")){
+		model->objcon = newvalue;
+		stub_clear_solution(model);
+		return 0;
+	}
+	return stub_unknown_attribute(model, attrname);
+}
+
+int GRBgetstrattr(GRBmodel *model, const char *attrname, char **valueP)
+{
+	if (model == NULL || valueP == NULL)
+		return GRB_ERROR_NULL_ARGUMENT;
+	if (stub_is_attribute(attrname, "ModelName")){
+		*valueP = model->name;
+		return 0;
+	}
+	return stub_unknown_attribute(model, attrname);
+}
+
+int GRBsetstrattr(GRBmodel *model, const char *attrname, const char *newvalue)
+{
+	char *name;
+	if (model == NULL || newvalue == NULL)
+		return GRB_ERROR_NULL_ARGUMENT;
+	if (stub_is_attribute(attrname, "ModelName")){
+		name = stub_strdup(newvalue);
+		if (name == NULL)
+			return stub_error(model->env, GRB_ERROR_OUT_OF_MEMORY, "Out of memory");
+		free(model->name);
+		model->name = name;
+		return 0;
+	}
+	return stub_unknown_attribute(model, attrname);
+}
+
+int GRBgetintattrelement(GRBmodel *model, const char *attrname, int element, int *valueP)
+{
+	int error;
+	if (model == NULL || valueP == NULL)
+		return GRB_ERROR_NULL_ARGUMENT;
+	if (stub_is_attribute(attrname, "IISConstr")){
+		if ((error = stub_check_constr(model, element)))
+			return error;
+		if (model->iis == NULL)
+			return stub_error(model->env, GRB_ERROR_DATA_NOT_AVAILABLE, "No IIS has been computed");
+		*valueP = model->iis[element];
+	}
+	else if (stub_is_attribute(attrname, "IISLB") || stub_is_attribute(attrname, "IISUB")){
+		if ((error = stub_check_var(model, element)))
+			return error;
+		if (model->iis == NULL)
+			return stub_error(model->env, GRB_ERROR_DATA_NOT_AVAILABLE, "No IIS has been computed");
+		*valueP = 0;
+	}
+	else
+		return stub_unknown_attribute(model, attrname);
+	return 0;
+}
+
+int GRBsetintattrelement(GRBmodel *model, const char *attrname, int element, int newvalue)
+{
+	if (model == NULL)
+		return GRB_ERROR_NULL_ARGUMENT;
+	return stub_unknown_attribute(model, attrname);
+}
+
+static double stub_row_activity(GRBmodel *model, StubRow *row, double *x)
+{
+	double activity = 0.0;
+	int k;
+	for (k = 0; k < row->numnz; k = k+1)
+		activity = activity + row->val[k] * x[row->ind[k]];
+	return activity;
+}
+
+int GRBgetdblattrelement(GRBmodel *model, const char *attrname, int element, double *valueP)
+{
+	int error;
+	if (model == NULL || valueP == NULL)
+		return GRB_ERROR_NULL_ARGUMENT;
+	if (stub_is_attribute(attrname, "RHS") || stub_is_attribute(attrname, "Slack")){
+		if ((error = stub_check_constr(model, element)))
+			return error;
+		if (stub_is_attribute(attrname, "RHS"))
+			*valueP = model->rows[element].rhs;
+		else if (model->solcount == 0)
+			return stub_no_solution(model);
+		else
+			*valueP = model->rows[element].rhs - stub_row_activity(model, &model->rows[element], model->x);
+		return 0;
+	}
+	if (!stub_is_attribute(attrname, "Obj") && !stub_is_attribute(attrname, "LB") && !stub_is_attribute(attrname, "UB")
+			&& !stub_is_attribute(attrname, "Start") && !stub_is_attribute(attrname, "X"))
+		return stub_unknown_attribute(model, attrname);
+	if ((error = stub_check_var(model, element)))
+		return error;
+	if (stub_is_attribute(attrname, "Obj"))
+		*valueP = model->obj[element];
+	else if (stub_is_attribute(attrname, "LB"))
+		*valueP = model->lb[element];
+	else if (stub_is_attribute(attrname, "UB"))
+		*valueP = model->ub[element];
+	else if (stub_is_attribute(attrname, "Start"))
+		*valueP = model->start[element];
+	else if (model->solcount == 0)
+		return stub_no_solution(model);
+	else
+		*valueP = model->x[element];
+	return 0;
+}
+
+int GRBsetdblattrelement(GRBmodel *model, const char *attrname, int element, double newvalue)
+{
+	int error;
+	if (model == NULL)
+		return GRB_ERROR_NULL_ARGUMENT;
+	if (stub_is_attribute(attrname, "RHS")){
+		if ((error = stub_check_constr(model, element)))
+			return error;
+		model->rows[element].rhs = newvalue;
+	}
+	else if (stub_is_attribute(attrname, "Obj") || stub_is_attribute(attrname, "LB")
+			|| stub_is_attribute(attrname, "UB") || stub_is_attribute(attrname, "Start")){
+		if ((error = stub_check_var(model, element)))
+			return error;
+		if (stub_is_attribute(attrname, "Obj"))
+			model->obj[element] = newvalue;
+		else if (stub_is_attribute(attrname, "LB"))
+			model->lb[element] = newvalue;
+		else if (stub_is_attribute(attrname, "UB"))
+			model->ub[element] = newvalue;
+		else {
+			model->start[element] = newvalue;
+			return 0;
+		}
+	}
+	else
+		return stub_unknown_attribute(model, attrname);
+	stub_clear_solution(model);
+	return 0;
+}
+
+int GRBgetcharattrelement(GRBmodel *model, const char *attrname, int element, char *valueP)
+{
+	int error;
+	if (model == NULL || valueP == NULL)
+		return GRB_ERROR_NULL_ARGUMENT;
+	if (stub_is_attribute(attrname, "VType")){
+		if ((error = stub_check_var(model, element)))
+			return error;
+		*valueP = model->vtype[element];
+		return 0;
+	}
+	if (stub_is_attribute(attrname, "Sense")){
+		if ((error = stub_check_constr(model, element)))
+			return error;
+		*valueP = model->rows[element].sense;
+		return 0;
+	}
+	return stub_unknown_attribute(model, attrname);
+}
+
+int GRBsetcharattrelement(GRBmodel *model, const char *attrname, int element, char newvalue)
+{
+	int error;
+	if (model == NULL)
+		return GRB_ERROR_NULL_ARGUMENT;
+	if (stub_is_attribute(attrname, "VType")){
+		if ((error = stub_check_var(model, element)) || (error = stub_check_vtype(model, newvalue)))
+			return error;
+		model->vtype[element] = newvalue;
+	}
+	else if (stub_is_attribute(attrname, "Sense")){
+		if ((error = stub_check_constr(model, element)) || (error = stub_check_sense(model, newvalue)))
+			return error;
+		model->rows[element].sense = newvalue;
+	}
+	else
+		return stub_unknown_attribute(model, attrname);
+	stub_clear_solution(model);
+	return 0;
+}
+
+int GRBgetstrattrelement(GRBmodel *model, const char *attrname, int element, char **valueP)
+{
+	int error;
+	if (model == NULL || valueP == NULL)
+		return GRB_ERROR_NULL_ARGUMENT;
+	if (stub_is_attribute(attrname, "VarName")){
+		if ((error = stub_check_var(model, element)))
+			return error;
+		*valueP = model->varnames[element];
+		return 0;
+	}
+	if (stub_is_attribute(attrname, "ConstrName")){
+		if ((error = stub_check_constr(model, element)))
+			return error;
+		*valueP = model->rows[element].name;
+		return 0;
+	}
+	return stub_unknown_attribute(model, attrname);
+}
+
+int GRBsetstrattrelement(GRBmodel *model, const char *attrname, int element, const char *newvalue)
+{
+	char **target;
+	char *name;
+	int error;
+	if (model == NULL || newvalue == NULL)
+		return GRB_ERROR_NULL_ARGUMENT;
+	if (stub_is_attribute(attrname, "VarName")){
+		if ((error = stub_check_var(model, element)))
+			return error;
+		target = &model->varnames[element];
+	}
+	else if (stub_is_attribute(attrname, "ConstrName")){
+		if ((error = stub_check_constr(model, element)))
+			return error;
+		target = &model->rows[element].name;
+	}
+	else
+		return stub_unknown_attribute(model, attrname);
+	name = stub_strdup(newvalue);
+	if (name == NULL)
+		return stub_error(model->env, GRB_ERROR_OUT_OF_MEMORY, "Out of memory");
+	free(*target);
+	*target = name;
+	return 0;
+}
+
+#define STUB_ATTRIBUTE_ARRAY(type, get, set, getelement, setelement) \
+int get(GRBmodel *model, const char *attrname, int first, int len, type *values) \
+{ \
+	int i, error; \
+	if (values == NULL) \
+		return GRB_ERROR_NULL_ARGUMENT; \
+	for (i = 0; i < len; i = i+1) \
+		if ((error = getelement(model, attrname, first + i, &values[i]))) \
+			return error; \
+	return 0; \
+} \
+int set(GRBmodel *model, const char *attrname, int first, int len, type *newvalues) \
+{ \
+	int i, error; \
+	if (newvalues == NULL) \
+		return GRB_ERROR_NULL_ARGUMENT; \
+	for (i = 0; i < len; i = i+1) \
+		if ((error = setelement(model, attrname, first + i, newvalues[i]))) \
+			return error; \
+	return 0; \
+}
+
+STUB_ATTRIBUTE_ARRAY(int, GRBgetintattrarray, GRBsetintattrarray, GRBgetintattrelement, GRBsetintattrelement)
+STUB_ATTRIBUTE_ARRAY(double, GRBgetdblattrarray, GRBsetdblattrarray, GRBgetdblattrelement, GRBsetdblattrelement)
+STUB_ATTRIBUTE_ARRAY(char, GRBgetcharattrarray, GRBsetcharattrarray, GRBgetcharattrelement, GRBsetcharattrelement)
+STUB_ATTRIBUTE_ARRAY(char *, GRBgetstrattrarray, GRBsetstrattrarray, GRBgetstrattrelement, GRBsetstrattrelement)
+
+int GRBgetdblattrlist(GRBmodel *model, const char *attrname, int len, int *ind, double *values)
+{
+	int i, error;
+	if (ind == NULL || values == NULL)
+		return GRB_ERROR_NULL_ARGUMENT;
+	for (i = 0; i < len; i = i+1)
+		if ((error = GRBgetdblattrelement(model, attrname, ind[i], &values[i])))
+			return error;
+	return 0;
+}
+
+int GRBsetdblattrlist(GRBmodel *model, const char *attrname, int len, int *ind, double *newvalues)
+{
+	int i, error;
+	if (ind == NULL || newvalues == NULL)
+		return GRB_ERROR_NULL_ARGUMENT;
+	for (i = 0; i < len; i = i+1)
+		if ((error = GRBsetdblattrelement(model, attrname, ind[i], newvalues[i])))
+			return error;
+	return 0;
+}
+
+/*
+	The solver
+*/
+
+typedef struct {
+	GRBmodel *model;
+	int n;
+	double tolerance;
+
+	/* The constraint matrix by columns */
+	int *col_begin;
+	int *col_row;
+	double *col_val;
+
+	/* The least and greatest activity of each row, given the variables fixed so far */
+	double *min_activity;
+	double *max_activity;
+
+	/* The objective, always minimised, and a bound on what the unfixed variables can add */
+	double *cost;
+	double *remaining;
+	double current;
+
+	double *value;
+	double best;
+	int found;
+
+	double cutoff;
+	double objective_stop;
+	double node_limit;
+	double time_limit;
+	int solution_limit;
+	double start_time;
+	int stopped;
+} StubSearch;
+
+/*
+	The data passed to a callback. The search is NULL outside the search, and the message is only
+	set where GRB_CB_MESSAGE.
+*/
+
+typedef struct StubCallbackData {
+	GRBmodel *model;
+	StubSearch *search;
+	double start_time;
+	const char *message;
+	int error;
+} StubCallbackData;
+
+static int stub_callback(GRBmodel *model, int where, const char *message)
+{
+	if (model->callback == NULL || model->cbdata == NULL)
+		return 0;
+	model->cbdata->message = message;
+	if (model->callback(model, model->cbdata, where, model->usrdata)){
+		model->terminate = 1;
+		model->cbdata->error = GRB_ERROR_CALLBACK;
+	}
+	return model->cbdata->error;
+}
+
+static void stub_log(GRBmodel *model, const char *format, ...)
+{
+	va_list args;
+	FILE *file;
+	int output = 1, console = 1;
+	char logfile[GRB_MAX_STRLEN];
+	char message[GRB_MAX_STRLEN];
+	GRBgetintparam(model->env, "OutputFlag", &output);
+	GRBgetintparam(model->env, "LogToConsole", &console);
+	GRBgetstrparam(model->env, "LogFile", logfile);
+	if (!output)
+		return;
+	va_start(args, format);
+	vsnprintf(message, sizeof(message), format, args);
+	va_end(args);
+	if (console){
+		fputs(message, stdout);
+		fflush(stdout);
+	}
+	if (logfile[0] != '\0' && (file = fopen(logfile, "a")) != NULL){
+		fputs(message, file);
+		fclose(file);
+	}
+	stub_callback(model, GRB_CB_MESSAGE, message);
+}
+
+static int stub_row_feasible(StubSearch *search, int r)
+{
+	StubRow *row = &search->model->rows[r];
+	if (row->sense != GRB_GREATER_EQUAL && search->min_activity[r] > row->rhs + search->tolerance)
+		return 0;
+	if (row->sense != GRB_LESS_EQUAL && search->max_activity[r] < row->rhs - search->tolerance)
+		return 0;
+	return 1;
+}
+
+/*
+	Fix variable j to the given value, or undo this if undo is set, updating the row
+	activities. Returns whether all rows containing j can still be satisfied.
+*/
+
+static int stub_fix(StubSearch *search, int j, double value, int undo)
+{
+	double lb = search->model->lb[j];
+	double ub = search->model->ub[j];
+	double a, least, greatest, sign;
+	int k, r, feasible = 1;
+	sign = undo ? -1.0 : 1.0;
+	for (k = search->col_begin[j]; k < search->col_begin[j+1]; k = k+1){
+		r = search->col_row[k];
+		a = search->col_val[k];
+		least = a > 0 ? a*lb : a*ub;
+		greatest = a > 0 ? a*ub : a*lb;
+		search->min_activity[r] = search->min_activity[r] + sign * (a*value - least);
+		search->max_activity[r] = search->max_activity[r] + sign * (a*value - greatest);
+		if (!undo && !stub_row_feasible(search, r))
+			feasible = 0;
+	}
+	return feasible;
+}
+
+static void stub_check_limits(StubSearch *search)
+{
+	stub_callback(search->model, GRB_CB_MIP, NULL);
+	if (search->model->terminate)
+		search->stopped = GRB_INTERRUPTED;
+	else if (search->model->nodecount >= search->node_limit)
+		search->stopped = GRB_NODE_LIMIT;
+	else if (search->time_limit < GRB_INFINITY && stub_now() - search->start_time >= search->time_limit)
+		search->stopped = GRB_TIME_LIMIT;
+}
+
+/* Whether the values x satisfy the general and SOS constraints of the model */
+static int stub_genconstrs_feasible(GRBmodel *model, double *x, double tolerance)
+{
+	StubGenConstr *g;
+	int i, k, nonzeros, first, last, position;
+	double result, activity;
+	for (i = 0; i < model->numgenconstrs; i = i+1){
+		g = &model->genconstrs[i];
+		switch (g->type){
+			case STUB_GENCONSTR_MAX:
+			case STUB_GENCONSTR_MIN:
+				result = g->rhs;
+				for (k = 0; k < g->nvars; k = k+1)
+					if (g->type == STUB_GENCONSTR_MAX ? x[g->vars[k]] > result : x[g->vars[k]] < result)
+						result = x[g->vars[k]];
+				break;
+			case STUB_GENCONSTR_ABS:
+				result = fabs(x[g->vars[0]]);
+				break;
+			case STUB_GENCONSTR_AND:
+			case STUB_GENCONSTR_OR:
+				nonzeros = 0;
+				for (k = 0; k < g->nvars; k = k+1)
+					if (x[g->vars[k]] > 0.5)
+						nonzeros = nonzeros + 1;
+				result = (g->type == STUB_GENCONSTR_AND) ? (nonzeros == g->nvars) : (nonzeros > 0);
+				break;
+			case STUB_GENCONSTR_INDICATOR:
+				if ((x[g->resvar] > 0.5) != g->binval)
+					continue;
+				activity = 0;
+				for (k = 0; k < g->nvars; k = k+1)
+					activity = activity + g->vals[k] * x[g->vars[k]];
+				if ((g->sense != GRB_GREATER_EQUAL && activity > g->rhs + tolerance)
+						|| (g->sense != GRB_LESS_EQUAL && activity < g->rhs - tolerance))
+					return 0;
+				continue;
+			default:
+				/* At most one nonzero for SOS1, and at most two consecutive ones (by weight) for SOS2 */
+				nonzeros = 0;
+				first = -1;
+				last = -1;
+				for (k = 0; k < g->nvars; k = k+1){
+					if (fabs(x[g->vars[k]]) <= tolerance)
+						continue;
+					nonzeros = nonzeros + 1;
+					/* The position of member k in the order of the weights */
+					position = 0;
+					for (first = 0; first < g->nvars; first = first+1)
+						if (g->vals[first] < g->vals[k])
+							position = position + 1;
+					if (nonzeros == 1)
+						last = position;
+					else if (abs(position - last) != 1)
+						return 0;
+				}
+				if (nonzeros > (g->type == STUB_SOS1 ? 1 : 2))
+					return 0;
+				continue;
+		}
+		if (fabs(x[g->resvar] - result) > tolerance)
+			return 0;
+	}
+	return 1;
+}
+
+static void stub_search(StubSearch *search, int j)
+{
+	GRBmodel *model = search->model;
+	double lb, ub, value, step, last;
+
+	if (search->stopped)
+		return;
+	model->nodecount = model->nodecount + 1;
+	if (((long) model->nodecount & 1023) == 0)
+		stub_check_limits(search);
+	if (search->stopped)
+		return;
+	if (search->current + search->remaining[j] > search->cutoff - search->tolerance)
+		return;
+	if (search->found && search->current + search->remaining[j] >= search->best - search->tolerance)
+		return;
+
+	if (j == search->n){
+		if (!stub_genconstrs_feasible(model, search->value, search->tolerance))
+			return;
+		search->best = search->current;
+		search->found = search->found + 1;
+		memcpy(model->x, search->value, search->n * sizeof(double));
+		if (search->found >= search->solution_limit)
+			search->stopped = GRB_SOLUTION_LIMIT;
+		else if (search->best <= search->objective_stop)
+			search->stopped = GRB_USER_OBJ_LIMIT;
+		return;
+	}
+
+	lb = ceil(model->lb[j] - search->tolerance);
+	ub = floor(model->ub[j] + search->tolerance);
+	/* Try the values in order of increasing cost */
+	if (search->cost[j] < 0){
+		value = ub;
+		step = -1.0;
+		last = lb;
+	}
+	else {
+		value = lb;
+		step = 1.0;
+		last = ub;
+	}
+	while (!search->stopped){
+		search->value[j] = value;
+		search->current = search->current + search->cost[j] * value;
+		if (stub_fix(search, j, value, 0))
+			stub_search(search, j+1);
+		stub_fix(search, j, value, 1);
+		search->current = search->current - search->cost[j] * value;
+		if (value == last)
+			break;
+		value = value + step;
+	}
+}
+
+/*
+	The range of values variable j takes in the search, or -1 if the solver can not handle it.
+*/
+
+static double stub_domain_size(GRBmodel *model, int j)
+{
+	double lb = model->lb[j];
+	double ub = model->ub[j];
+	if (lb > ub)
+		return 0;
+	if (model->vtype[j] == GRB_CONTINUOUS && lb == ub)
+		return 1;
+	if (model->vtype[j] != GRB_BINARY && model->vtype[j] != GRB_INTEGER)
+		return -1;
+	if (lb <= -GRB_INFINITY || ub >= GRB_INFINITY || ub - lb > 1e6)
+		return -1;
+	return floor(ub + 1e-9) - ceil(lb - 1e-9) + 1;
+}
+
+static int stub_solve(GRBmodel *model)
+{
+	StubSearch search;
+	StubRow *row;
+	int n = model->numvars;
+	int m = model->numconstrs;
+	int i, j, k, r, numnz, solution_limit = 2000000000;
+	double a, size, cutoff = GRB_INFINITY, objective_stop = -GRB_INFINITY;
+
+	memset(&search, 0, sizeof(search));
+	search.model = model;
+	search.n = n;
+	GRBgetdblparam(model->env, "FeasibilityTol", &search.tolerance);
+	GRBgetdblparam(model->env, "NodeLimit", &search.node_limit);
+	GRBgetdblparam(model->env, "TimeLimit", &search.time_limit);
+	GRBgetintparam(model->env, "SolutionLimit", &solution_limit);
+	search.solution_limit = solution_limit;
+	/* The defaults of Cutoff and BestObjStop mean no limit, whatever the objective sense */
+	GRBgetdblparam(model->env, "Cutoff", &cutoff);
+	search.cutoff = GRB_INFINITY;
+	if (cutoff > -GRB_INFINITY && cutoff < GRB_INFINITY)
+		search.cutoff = model->sense * (cutoff - model->objcon);
+	GRBgetdblparam(model->env, "BestObjStop", &objective_stop);
+	search.objective_stop = -GRB_INFINITY;
+	if (objective_stop > -GRB_INFINITY && objective_stop < GRB_INFINITY)
+		search.objective_stop = model->sense * (objective_stop - model->objcon);
+	search.start_time = stub_now();
+
+	for (j = 0; j < n; j = j+1){
+		size = stub_domain_size(model, j);
+		if (size < 0){
+			stub_log(model, "Variable %s is not supported by the stub solver\n", model->varnames[j]);
+			model->status = GRB_NUMERIC;
+			return 0;
+		}
+		if (size == 0){
+			model->status = GRB_INFEASIBLE;
+			return 0;
+		}
+	}
+
+	numnz = 0;
+	for (r = 0; r < m; r = r+1)
+		numnz = numnz + model->rows[r].numnz;
+	search.col_begin = calloc(n + 1, sizeof(int));
+	search.col_row = malloc((numnz + 1) * sizeof(int));
+	search.col_val = malloc((numnz + 1) * sizeof(double));
+	search.min_activity = calloc(m + 1, sizeof(double));
+	search.max_activity = calloc(m + 1, sizeof(double));
+	search.cost = malloc((n + 1) * sizeof(double));
+	search.remaining = calloc(n + 1, sizeof(double));
+	search.value = calloc(n + 1, sizeof(double));
+	if (search.col_begin == NULL || search.col_row == NULL || search.col_val == NULL || search.min_activity == NULL
+			|| search.max_activity == NULL || search.cost == NULL || search.remaining == NULL || search.value == NULL){
+		free(search.col_begin); free(search.col_row); free(search.col_val); free(search.min_activity);
+		free(search.max_activity); free(search.cost); free(search.remaining); free(search.value);
+		return stub_error(model->env, GRB_ERROR_OUT_OF_MEMORY, "Out of memory");
+	}
+
+	for (r = 0; r < m; r = r+1)
+		for (k = 0; k < model->rows[r].numnz; k = k+1)
+			search.col_begin[model->rows[r].ind[k] + 1] = search.col_begin[model->rows[r].ind[k] + 1] + 1;
+	for (j = 0; j < n; j = j+1)
+		search.col_begin[j+1] = search.col_begin[j+1] + search.col_begin[j];
+	for (r = 0; r < m; r = r+1){
+		row = &model->rows[r];
+		for (k = 0; k < row->numnz; k = k+1){
+			j = row->ind[k];
+			a = row->val[k];
+			/* col_begin[j] is used as a cursor here, and restored afterwards */
+			i = search.col_begin[j];
+			search.col_row[i] = r;
+			search.col_val[i] = a;
+			search.col_begin[j] = i + 1;
+			search.min_activity[r] = search.min_activity[r] + (a > 0 ? a*model->lb[j] : a*model->ub[j]);
+			search.max_activity[r] = search.max_activity[r] + (a > 0 ? a*model->ub[j] : a*model->lb[j]);
+		}
+	}
+	for (j = n; j > 0; j = j-1)
+		search.col_begin[j] = search.col_begin[j-1];
+	search.col_begin[0] = 0;
+
+	for (j = 0; j < n; j = j+1)
+		search.cost[j] = model->sense * model->obj[j];
+	for (j = n-1; j >= 0; j = j-1)
+		search.remaining[j] = search.remaining[j+1]
+				+ (search.cost[j] > 0 ? search.cost[j] * model->lb[j] : search.cost[j] * model->ub[j]);
+
+	if (model->cbdata != NULL)
+		model->cbdata->search = &search;
+	stub_callback(model, GRB_CB_PRESOLVE, NULL);
+	for (r = 0; r < m && stub_row_feasible(&search, r); r = r+1)
+		;
+	if (r == m && !model->terminate)
+		stub_search(&search, 0);
+	else if (model->terminate)
+		search.stopped = GRB_INTERRUPTED;
+	if (model->cbdata != NULL)
+		model->cbdata->search = NULL;
+
+	if (search.found){
+		model->solcount = 1;
+		model->objval = model->sense * search.best + model->objcon;
+	}
+	if (search.stopped)
+		model->status = search.stopped;
+	else if (search.found)
+		model->status = GRB_OPTIMAL;
+	else if (search.cutoff < GRB_INFINITY)
+		model->status = GRB_CUTOFF;
+	else
+		model->status = GRB_INFEASIBLE;
+	if (model->status == GRB_OPTIMAL)
+		model->objbound = model->objval;
+	else
+		model->objbound = model->sense * search.remaining[0] + model->objcon;
+
+	free(search.col_begin); free(search.col_row); free(search.col_val); free(search.min_activity);
+	free(search.max_activity); free(search.cost); free(search.remaining); free(search.value);
+	return 0;
+}
+
+/*
+	Optimises a model with several objectives by priority, from the highest. The objectives of a level are blended
+	by their weights, and once the level is optimal a constraint keeps its blended objective within the tolerances
+	of that optimum while the lower levels are optimised. These constraints are removed again at the end.
+*/
+static int stub_solve_hierarchy(GRBmodel *model)
+{
+	StubObjective *o;
+	int n = model->numvars;
+	int m = model->numconstrs;
+	int i, j, k, numnz, priority, next, more, found = 0, error = 0, status = GRB_LOADED;
+	double value, abstol, reltol, nodecount = 0;
+	double objcon = model->objcon, level_constant;
+	double *obj = malloc((n + 1) * sizeof(double));
+	double *level = malloc((n + 1) * sizeof(double));
+	double *x = malloc((n + 1) * sizeof(double));
+	int *ind = malloc((n + 1) * sizeof(int));
+	int *added;
+	if (obj == NULL || level == NULL || x == NULL || ind == NULL){
+		free(obj); free(level); free(x); free(ind);
+		return stub_error(model->env, GRB_ERROR_OUT_OF_MEMORY, "Out of memory");
+	}
+	memcpy(obj, model->obj, n * sizeof(double));
+
+	more = 1;
+	priority = 0;
+	for (i = 0; i < model->numobj; i = i+1)
+		if (i == 0 || model->objectives[i].priority > priority)
+			priority = model->objectives[i].priority;
+	while (more && error == 0){
+		memset(level, 0, n * sizeof(double));
+		level_constant = 0;
+		abstol = 0;
+		reltol = 0;
+		for (i = 0; i < model->numobj; i = i+1){
+			o = &model->objectives[i];
+			if (o->priority != priority)
+				continue;
+			if (i == 0){
+				for (j = 0; j < n; j = j+1)
+					level[j] = level[j] + o->weight * obj[j];
+				level_constant = level_constant + o->weight * objcon;
+			}
+			else {
+				for (k = 0; k < o->numnz; k = k+1)
+					level[o->ind[k]] = level[o->ind[k]] + o->weight * o->val[k];
+				level_constant = level_constant + o->weight * o->constant;
+			}
+			abstol = fmax(abstol, o->abstol);
+			reltol = fmax(reltol, o->reltol);
+		}
+		memcpy(model->obj, level, n * sizeof(double));
+		model->objcon = level_constant;
+		error = stub_solve(model);
+		nodecount = nodecount + model->nodecount;
+		status = model->status;
+		if (error || status != GRB_OPTIMAL)
+			break;
+		found = 1;
+		memcpy(x, model->x, n * sizeof(double));
+
+		more = 0;
+		next = 0;
+		for (i = 0; i < model->numobj; i = i+1)
+			if (model->objectives[i].priority < priority && (! more || model->objectives[i].priority > next)){
+				next = model->objectives[i].priority;
+				more = 1;
+			}
+		if (more){
+			numnz = 0;
+			for (j = 0; j < n; j = j+1)
+				if (level[j] != 0.0){
+					ind[numnz] = j;
+					level[numnz] = level[j];
+					numnz = numnz + 1;
+				}
+			value = model->objval - level_constant;
+			abstol = fmax(abstol, reltol * fabs(model->objval));
+			error = GRBaddconstr(model, numnz, ind, level, model->sense == GRB_MINIMIZE ? GRB_LESS_EQUAL : GRB_GREATER_EQUAL,
+					model->sense == GRB_MINIMIZE ? value + abstol : value - abstol, NULL);
+			priority = next;
+		}
+	}
+
+	added = malloc((model->numconstrs - m + 1) * sizeof(int));
+	for (i = m; added != NULL && i < model->numconstrs; i = i+1)
+		added[i - m] = i;
+	if (added != NULL)
+		GRBdelconstrs(model, model->numconstrs - m, added);
+	free(added);
+	memcpy(model->obj, obj, n * sizeof(double));
+	model->objcon = objcon;
+	model->status = status;
+	model->nodecount = nodecount;
+	if (found){
+		memcpy(model->x, x, n * sizeof(double));
+		model->solcount = 1;
+		model->objval = stub_objective_value(model, 0, x);
+		model->objbound = model->objval;
+	}
+	free(obj); free(level); free(x); free(ind);
+	return error;
+}
+
+int GRBoptimize(GRBmodel *model)
+{
+	StubCallbackData cbdata;
+	int error;
+	if (model == NULL)
+		return GRB_ERROR_NULL_ARGUMENT;
+	stub_clear_solution(model);
+	model->terminate = 0;
+	memset(&cbdata, 0, sizeof(cbdata));
+	cbdata.model = model;
+	cbdata.start_time = stub_now();
+	model->cbdata = &cbdata;
+	stub_log(model, "Optimize a model with %d rows, %d columns\n", model->numconstrs, model->numvars);
+	error = model->numobj > 1 ? stub_solve_hierarchy(model) : stub_solve(model);
+	model->runtime = stub_now() - cbdata.start_time;
+	if (!error){
+		stub_log(model, "Explored %.0f nodes in %.2f seconds\n", model->nodecount, model->runtime);
+		if (model->status == GRB_OPTIMAL)
+			stub_log(model, "Optimal solution found, objective %.10g\n", model->objval);
+		else
+			stub_log(model, "Finished with status %d\n", model->status);
+		error = cbdata.error;
+	}
+	model->cbdata = NULL;
+	if (error)
+		model->status = GRB_LOADED;
+	if (error == GRB_ERROR_CALLBACK)
+		stub_error(model->env, error, "Callback returned an error");
+	return error;
+}
+
+/*
+	Infeasibility analysis. The IIS is found by a deletion filter over the constraints, which
+	solves the model without each constraint in turn, so it is only feasible for small models.
+	The bounds of the variables are all kept, and never reported as part of the IIS.
+	Feasibility relaxations need continuous variables, which the stub cannot optimise over.
+*/
+
+/* Solves the model restricted to the active constraints, ignoring the objective */
+static int stub_subset_status(GRBmodel *model, char *active, int *statusP)
+{
+	GRBmodel *copy;
+	int i, error, number_of_inactive = 0;
+	int *inactive = malloc((model->numconstrs + 1) * sizeof(int));
+	copy = GRBcopymodel(model);
+	if (inactive == NULL || copy == NULL){
+		free(inactive);
+		GRBfreemodel(copy);
+		return stub_error(model->env, GRB_ERROR_OUT_OF_MEMORY, "Out of memory");
+	}
+	for (i = 0; i < model->numconstrs; i = i+1)
+		if (!active[i])
+			inactive[number_of_inactive++] = i;
+	for (i = 0; i < model->numvars; i = i+1)
+		copy->obj[i] = 0;
+	error = GRBdelconstrs(copy, number_of_inactive, inactive);
+	if (!error)
+		error = GRBsetintparam(copy->env, "SolutionLimit", 1);
+	if (!error)
+		error = GRBsetintparam(copy->env, "OutputFlag", 0);
+	if (!error)
+		error = GRBoptimize(copy);
+	*statusP = copy->status;
+	free(inactive);
+	GRBfreemodel(copy);
+	return error;
+}
+
+int GRBcomputeIIS(GRBmodel *model)
+{
+	char *active;
+	int i, error, status, count;
+	if (model == NULL)
+		return GRB_ERROR_NULL_ARGUMENT;
+	active = malloc(model->numconstrs + 1);
+	if (active == NULL)
+		return stub_error(model->env, GRB_ERROR_OUT_OF_MEMORY, "Out of memory");
+	memset(active, 1, model->numconstrs + 1);
+	error = stub_subset_status(model, active, &status);
+	if (!error && status != GRB_INFEASIBLE)
+		error = stub_error(model->env, (status == GRB_OPTIMAL || status == GRB_SOLUTION_LIMIT) ? GRB_ERROR_IIS_NOT_INFEASIBLE : GRB_ERROR_NOT_SUPPORTED,
+				"Cannot compute an IIS, the model finished with status %d", status);
+	for (i = 0; !error && i < model->numconstrs; i = i+1){
+		active[i] = 0;
+		error = stub_subset_status(model, active, &status);
+		if (!error && status != GRB_INFEASIBLE)
+			active[i] = 1;
+	}
+	if (error){
+		free(active);
+		return error;
+	}
+	count = 0;
+	for (i = 0; i < model->numconstrs; i = i+1)
+		count = count + active[i];
+	stub_log(model, "IIS computed: %d constraints\n", count);
+	free(model->iis);
+	model->iis = active;
+	return 0;
+}
+
+int GRBfeasrelax(GRBmodel *model, int relaxobjtype, int minrelax, double *lbpen, double *ubpen,
+		double *rhspen, double *feasobjP)
+{
+	if (model == NULL)
+		return GRB_ERROR_NULL_ARGUMENT;
+	return stub_error(model->env, GRB_ERROR_NOT_SUPPORTED, "Feasibility relaxations are not supported");
+}
+
+/*
+	Tuning. The solver of the stub hardly depends on its parameters, so tuning only solves the
+	models once with the parameters of the first model, which are then the single result.
+*/
+
+int GRBtunemodels(int nummodels, GRBmodel **models, GRBmodel *ignore, GRBmodel *hint)
+{
+	int i, error;
+	if (nummodels < 1 || models == NULL)
+		return GRB_ERROR_NULL_ARGUMENT;
+	models[0]->tuneresultcount = 0;
+	for (i = 0; i < nummodels; i = i+1){
+		if (i > 0)
+			GRBcopyparams(models[i]->env, models[0]->env);
+		error = GRBoptimize(models[i]);
+		if (error)
+			return error;
+	}
+	models[0]->tuneresultcount = 1;
+	return 0;
+}
+
+int GRBtunemodel(GRBmodel *model)
+{
+	return GRBtunemodels(1, &model, NULL, NULL);
+}
+
+int GRBgettuneresult(GRBmodel *model, int i)
+{
+	if (model == NULL)
+		return GRB_ERROR_NULL_ARGUMENT;
+	if (i < 0 || i >= model->tuneresultcount)
+		return stub_error(model->env, GRB_ERROR_INDEX_OUT_OF_RANGE, "Tuning result %d does not exist", i);
+	return 0;
+}
+
+int GRBsetcallbackfunc(GRBmodel *model, int (*cb)(CB_ARGS), void *usrdata)
+{
+	if (model == NULL)
+		return GRB_ERROR_NULL_ARGUMENT;
+	model->callback = cb;
+	model->usrdata = usrdata;
+	return 0;
+}
+
+int GRBcbget(void *cbdata, int where, int what, void *resultP)
+{
+	StubCallbackData *data = (StubCallbackData *) cbdata;
+	GRBmodel *model;
+	StubSearch *search;
+	if (data == NULL || resultP == NULL)
+		return GRB_ERROR_NULL_ARGUMENT;
+	model = data->model;
+	search = data->search;
+	if (what == GRB_CB_RUNTIME){
+		*(double *) resultP = stub_now() - data->start_time;
+		return 0;
+	}
+	if (where == GRB_CB_PRESOLVE && what >= GRB_CB_PRE_COLDEL && what <= GRB_CB_PRE_COECHG){
+		*(int *) resultP = 0;
+		return 0;
+	}
+	if (where == GRB_CB_MESSAGE && what == GRB_CB_MSG_STRING){
+		*(char **) resultP = (char *) data->message;
+		return 0;
+	}
+	if (where == GRB_CB_MIP && search != NULL){
+		switch (what){
+		case GRB_CB_MIP_OBJBST:
+			*(double *) resultP = search->found ? model->sense * search->best + model->objcon : model->sense * GRB_INFINITY;
+			return 0;
+		case GRB_CB_MIP_OBJBND:
+			*(double *) resultP = model->sense * search->remaining[0] + model->objcon;
+			return 0;
+		case GRB_CB_MIP_NODCNT:
+		case GRB_CB_MIP_NODLFT:
+			*(double *) resultP = what == GRB_CB_MIP_NODCNT ? model->nodecount : 0.0;
+			return 0;
+		case GRB_CB_MIP_ITRCNT:
+			*(double *) resultP = 0.0;
+			return 0;
+		case GRB_CB_MIP_SOLCNT:
+		case GRB_CB_MIP_CUTCNT:
+			*(int *) resultP = what == GRB_CB_MIP_SOLCNT ? search->found : 0;
+			return 0;
+		}
+	}
+	return stub_error(model->env, GRB_ERROR_INVALID_ARGUMENT, "Invalid callback request %d where %d", what, where);
+}
+
+void GRBterminate(GRBmodel *model)
+{
+	if (model != NULL)
+		model->terminate = 1;
+}
+
+/*
+	Reading and writing models
+*/
+
+static const char *stub_extension(const char *filename)
+{
+	const char *dot = strrchr(filename, '.');
+	return dot == NULL ? "" : dot + 1;
+}
+
+static void stub_write_number(FILE *file, double value)
+{
+	if (value >= GRB_INFINITY)
+		fprintf(file, "inf");
+	else if (value <= -GRB_INFINITY)
+		fprintf(file, "-inf");
+	else
+		fprintf(file, "%.17g", value);
+}
+
+static void stub_write_lp(GRBmodel *model, FILE *file)
+{
+	StubRow *row;
+	int i, j, k, first;
+	fprintf(file, "\\ Model %s\n", model->name);
+	fprintf(file, "%s\n", model->sense == GRB_MAXIMIZE ? "Maximize" : "Minimize");
+	fprintf(file, " ");
+	for (j = 0; j < model->numvars; j = j+1)
+		if (model->obj[j] != 0.0){
+			fprintf(file, " %+.17g %s", model->obj[j], model->varnames[j]);
+		}
+	if (model->objcon != 0.0)
+		fprintf(file, " %+.17g", model->objcon);
+	fprintf(file, "\nSubject To\n");
+	for (i = 0; i < model->numconstrs; i = i+1){
+		row = &model->rows[i];
+		fprintf(file, " %s:", row->name);
+		for (k = 0; k < row->numnz; k = k+1)
+			fprintf(file, " %+.17g %s", row->val[k], model->varnames[row->ind[k]]);
+		if (row->numnz == 0)
+			fprintf(file, " 0 %s", model->numvars > 0 ? model->varnames[0] : "");
+		fprintf(file, " %s %.17g\n", row->sense == GRB_LESS_EQUAL ? "<=" : (row->sense == GRB_GREATER_EQUAL ? ">=" : "="), row->rhs);
+	}
+	fprintf(file, "Bounds\n");
+	for (j = 0; j < model->numvars; j = j+1){
+		if (model->vtype[j] == GRB_BINARY)
+			continue;
+		fprintf(file, " ");
+		stub_write_number(file, model->lb[j]);
+		fprintf(file, " <= %s <= ", model->varnames[j]);
+		stub_write_number(file, model->ub[j]);
+		fprintf(file, "\n");
+	}
+	first = 1;
+	for (j = 0; j < model->numvars; j = j+1)
+		if (model->vtype[j] == GRB_BINARY){
+			fprintf(file, "%s %s", first ? "Binaries\n" : "", model->varnames[j]);
+			first = 0;
+		}
+	if (!first)
+		fprintf(file, "\n");
+	first = 1;
+	for (j = 0; j < model->numvars; j = j+1)
+		if (model->vtype[j] == GRB_INTEGER){
+			fprintf(file, "%s %s", first ? "Generals\n" : "", model->varnames[j]);
+			first = 0;
+		}
+	if (!first)
+		fprintf(file, "\n");
+	fprintf(file, "End\n");
+}
+
+static void stub_write_mps(GRBmodel *model, FILE *file)
+{
+	StubRow *row;
+	int i, j, k, integral = 0;
+	int *count, **rows;
+	double **values;
+
+	/* Gather the coefficients by column */
+	count = calloc(model->numvars + 1, sizeof(int));
+	rows = calloc(model->numvars + 1, sizeof(int *));
+	values = calloc(model->numvars + 1, sizeof(double *));
+	for (i = 0; i < model->numconstrs; i = i+1)
+		for (k = 0; k < model->rows[i].numnz; k = k+1)
+			count[model->rows[i].ind[k]] = count[model->rows[i].ind[k]] + 1;
+	for (j = 0; j < model->numvars; j = j+1){
+		rows[j] = malloc((count[j] + 1) * sizeof(int));
+		values[j] = malloc((count[j] + 1) * sizeof(double));
+		count[j] = 0;
+	}
+	for (i = 0; i < model->numconstrs; i = i+1){
+		row = &model->rows[i];
+		for (k = 0; k < row->numnz; k = k+1){
+			j = row->ind[k];
+			rows[j][count[j]] = i;
+			values[j][count[j]] = row->val[k];
+			count[j] = count[j] + 1;
+		}
+	}
+
+	fprintf(file, "NAME %s\n", model->name[0] == '\0' ? "Unnamed" : model->name);
+	if (model->sense == GRB_MAXIMIZE)
+		fprintf(file, "OBJSENSE\n    MAX\n");
+	fprintf(file, "ROWS\n N  OBJ\n");
+	for (i = 0; i < model->numconstrs; i = i+1)
+		fprintf(file, " %c  %s\n", model->rows[i].sense == GRB_LESS_EQUAL ? 'L' : (model->rows[i].sense == GRB_GREATER_EQUAL ? 'G' : 'E'),
+				model->rows[i].name);
+	fprintf(file, "COLUMNS\n");
+	for (j = 0; j < model->numvars; j = j+1){
+		if (stub_is_integral(model->vtype[j]) != integral){
+			integral = !integral;
+			fprintf(file, "    MARKER 'MARKER' '%s'\n", integral ? "INTORG" : "INTEND");
+		}
+		fprintf(file, "    %s OBJ %.17g\n", model->varnames[j], model->obj[j]);
+		for (k = 0; k < count[j]; k = k+1)
+			fprintf(file, "    %s %s %.17g\n", model->varnames[j], model->rows[rows[j][k]].name, values[j][k]);
+	}
+	if (integral)
+		fprintf(file, "    MARKER 'MARKER' 'INTEND'\n");
+	fprintf(file, "RHS\n");
+	if (model->objcon != 0.0)
+		fprintf(file, "    RHS OBJ %.17g\n", -model->objcon);
+	for (i = 0; i < model->numconstrs; i = i+1)
+		if (model->rows[i].rhs != 0.0)
+			fprintf(file, "    RHS %s %.17g\n", model->rows[i].name, model->rows[i].rhs);
+	fprintf(file, "BOUNDS\n");
+	for (j = 0; j < model->numvars; j = j+1){
+		if (model->vtype[j] == GRB_BINARY){
+			fprintf(file, " BV BND %s\n", model->varnames[j]);
+			continue;
+		}
+		if (model->lb[j] <= -GRB_INFINITY && model->ub[j] >= GRB_INFINITY){
+			fprintf(file, " FR BND %s\n", model->varnames[j]);
+			continue;
+		}
+		if (model->lb[j] <= -GRB_INFINITY)
+			fprintf(file, " MI BND %s\n", model->varnames[j]);
+		else
+			fprintf(file, " LO BND %s %.17g\n", model->varnames[j], model->lb[j]);
+		if (model->ub[j] >= GRB_INFINITY)
+			fprintf(file, " PL BND %s\n", model->varnames[j]);
+		else
+			fprintf(file, " UP BND %s %.17g\n", model->varnames[j], model->ub[j]);
+	}
+	fprintf(file, "ENDATA\n");
+
+	for (j = 0; j < model->numvars; j = j+1){
+		free(rows[j]);
+		free(values[j]);
+	}
+	free(count);
+	free(rows);
+	free(values);
+}
+
+int GRBwrite(GRBmodel *model, const char *filename)
+{
+	const char *extension;
+	FILE *file;
+	int j;
+	if (model == NULL || filename == NULL)
+		return GRB_ERROR_NULL_ARGUMENT;
+	extension = stub_extension(filename);
+	if (strcasecmp(extension, "prm") == 0)
+		return GRBwriteparams(model->env, filename);
+	if (strcasecmp(extension, "lp") != 0 && strcasecmp(extension, "mps") != 0 && strcasecmp(extension, "sol") != 0)
+		return stub_error(model->env, GRB_ERROR_NOT_SUPPORTED, "Unable to write file '%s', unsupported file type", filename);
+	if (strcasecmp(extension, "sol") == 0 && model->solcount == 0)
+		return stub_no_solution(model);
+	file = fopen(filename, "w");
+	if (file == NULL)
+		return stub_error(model->env, GRB_ERROR_FILE_WRITE, "Unable to open file '%s' for output", filename);
+	if (strcasecmp(extension, "lp") == 0)
+		stub_write_lp(model, file);
+	else if (strcasecmp(extension, "mps") == 0)
+		stub_write_mps(model, file);
+	else {
+		fprintf(file, "# Objective value = %.17g\n", model->objval);
+		for (j = 0; j < model->numvars; j = j+1)
+			fprintf(file, "%s %.17g\n", model->varnames[j], model->x[j]);
+	}
+	fclose(file);
+	return 0;
+}
+
+/*
+	A hash table from names to indices, used when reading MPS files.
+*/
+
+typedef struct {
+	int size;
+	char **names;
+	int *indices;
+} StubNames;
+
+static unsigned long stub_hash(const char *s)
+{
+	unsigned long h = 5381;
+	while (*s != '\0'){
+		h = 33*h + (unsigned char) *s;
+		s = s+1;
+	}
+	return h;
+}
+
+static int stub_names_init(StubNames *table, int size)
+{
+	table->size = size;
+	table->names = calloc(size, sizeof(char *));
+	table->indices = calloc(size, sizeof(int));
+	return table->names != NULL && table->indices != NULL;
+}
+
+static void stub_names_free(StubNames *table)
+{
+	free(table->names);
+	free(table->indices);
+}
+
+static int stub_names_grow(StubNames *table)
+{
+	StubNames bigger;
+	unsigned long h;
+	int i;
+	if (!stub_names_init(&bigger, 2*table->size))
+		return 0;
+	for (i = 0; i < table->size; i = i+1)
+		if (table->names[i] != NULL){
+			for (h = stub_hash(table->names[i]) % bigger.size; bigger.names[h] != NULL; h = (h+1) % bigger.size)
+				;
+			bigger.names[h] = table->names[i];
+			bigger.indices[h] = table->indices[i];
+		}
+	stub_names_free(table);
+	*table = bigger;
+	return 1;
+}
+
+/* The names themselves are owned by the model */
+static int stub_names_add(StubNames *table, int *count, char *name, int index)
+{
+	unsigned long h;
+	if (2*(*count + 1) > table->size && !stub_names_grow(table))
+		return 0;
+	for (h = stub_hash(name) % table->size; table->names[h] != NULL; h = (h+1) % table->size)
+		;
+	table->names[h] = name;
+	table->indices[h] = index;
+	*count = *count + 1;
+	return 1;
+}
+
+static int stub_names_find(StubNames *table, const char *name)
+{
+	unsigned long h;
+	for (h = stub_hash(name) % table->size; table->names[h] != NULL; h = (h+1) % table->size)
+		if (strcmp(table->names[h], name) == 0)
+			return table->indices[h];
+	return -1;
+}
+
+/*
+	Reads free format MPS files, as written by GRBwrite. RANGES are not supported.
+*/
+
+#define STUB_MPS_TOKENS 6
+
+static int stub_read_mps(GRBmodel *model, FILE *file, const char *filename)
+{
+	char line[4096], objective[GRB_MAX_STRLEN];
+	char *tokens[STUB_MPS_TOKENS];
+	int number_of_tokens, section = 0, integral = 0, error = 0, r, j, t, line_number = 0;
+	int row_count = 0, column_count = 0;
+	StubNames row_names, column_names;
+	StubRow *row;
+	double value;
+	char sense;
+
+	objective[0] = '\0';
+	if (!stub_names_init(&row_names, 1024) || !stub_names_init(&column_names, 1024))
+		return stub_error(model->env, GRB_ERROR_OUT_OF_MEMORY, "Out of memory");
+
+	while (error == 0 && fgets(line, sizeof(line), file) != NULL){
+		line_number = line_number + 1;
+		if (line[0] == '*' || line[0] == '\n' || line[0] == '\r')
+			continue;
+		number_of_tokens = 0;
+		tokens[0] = strtok(line, " \t\r\n");
+		while (tokens[number_of_tokens] != NULL && number_of_tokens + 1 < STUB_MPS_TOKENS){
+			number_of_tokens = number_of_tokens + 1;
+			tokens[number_of_tokens] = strtok(NULL, " \t\r\n");
+		}
+		if (number_of_tokens == 0)
+			continue;
+
+		if (line[0] != ' ' && line[0] != '\t'){
+			if (strcmp(tokens[0], "NAME") == 0){
+				if (number_of_tokens > 1)
+					GRBsetstrattr(model, "ModelName", tokens[1]);
+				section = 0;
+			}
+			else if (strcmp(tokens[0], "OBJSENSE") == 0){
+				section = 1;
+				if (number_of_tokens > 1)
+					model->sense = strcmp(tokens[1], "MAX") == 0 ? GRB_MAXIMIZE : GRB_MINIMIZE;
+			}
+			else if (strcmp(tokens[0], "ROWS") == 0)
+				section = 2;
+			else if (strcmp(tokens[0], "COLUMNS") == 0)
+				section = 3;
+			else if (strcmp(tokens[0], "RHS") == 0)
+				section = 4;
+			else if (strcmp(tokens[0], "BOUNDS") == 0)
+				section = 5;
+			else if (strcmp(tokens[0], "ENDATA") == 0)
+				break;
+			else
+				error = stub_error(model->env, GRB_ERROR_FILE_READ, "Unsupported section %s in '%s', line %d", tokens[0], filename, line_number);
+			continue;
+		}
+
+		switch (section){
+		case 1:
+			model->sense = (strcmp(tokens[0], "MAX") == 0 || strcmp(tokens[0], "MAXIMIZE") == 0) ? GRB_MAXIMIZE : GRB_MINIMIZE;
+			break;
+		case 2:
+			if (number_of_tokens < 2){
+				error = GRB_ERROR_FILE_READ;
+				break;
+			}
+			if (tokens[0][0] == 'N'){
+				if (objective[0] == '\0')
+					strncpy(objective, tokens[1], GRB_MAX_STRLEN - 1);
+				break;
+			}
+			sense = tokens[0][0] == 'L' ? GRB_LESS_EQUAL : (tokens[0][0] == 'G' ? GRB_GREATER_EQUAL : GRB_EQUAL);
+			error = GRBaddconstr(model, 0, NULL, NULL, sense, 0.0, tokens[1]);
+			if (error == 0 && !stub_names_add(&row_names, &row_count, model->rows[model->numconstrs - 1].name, model->numconstrs - 1))
+				error = GRB_ERROR_OUT_OF_MEMORY;
+			break;
+		case 3:
+			if (number_of_tokens >= 3 && strcmp(tokens[1], "'MARKER'") == 0){
+				integral = strcmp(tokens[2], "'INTORG'") == 0;
+				break;
+			}
+			j = stub_names_find(&column_names, tokens[0]);
+			if (j < 0){
+				sense = integral ? GRB_INTEGER : GRB_CONTINUOUS;
+				error = GRBaddvars(model, 1, 0, NULL, NULL, NULL, NULL, NULL, NULL, &sense, &tokens[0]);
+				j = model->numvars - 1;
+				if (error == 0 && !stub_names_add(&column_names, &column_count, model->varnames[j], j))
+					error = GRB_ERROR_OUT_OF_MEMORY;
+			}
+			for (t = 1; error == 0 && t+1 < number_of_tokens; t = t+2){
+				value = strtod(tokens[t+1], NULL);
+				if (strcmp(tokens[t], objective) == 0){
+					model->obj[j] = value;
+					continue;
+				}
+				r = stub_names_find(&row_names, tokens[t]);
+				if (r < 0){
+					error = stub_error(model->env, GRB_ERROR_FILE_READ, "Unknown row %s in '%s', line %d", tokens[t], filename, line_number);
+					break;
+				}
+				row = &model->rows[r];
+				if ((error = stub_reserve_row(model, row, row->numnz + 1)))
+					break;
+				row->ind[row->numnz] = j;
+				row->val[row->numnz] = value;
+				row->numnz = row->numnz + 1;
+			}
+			break;
+		case 4:
+			for (t = 1; error == 0 && t+1 < number_of_tokens; t = t+2){
+				value = strtod(tokens[t+1], NULL);
+				if (strcmp(tokens[t], objective) == 0){
+					model->objcon = -value;
+					continue;
+				}
+				r = stub_names_find(&row_names, tokens[t]);
+				if (r < 0)
+					error = stub_error(model->env, GRB_ERROR_FILE_READ, "Unknown row %s in '%s', line %d", tokens[t], filename, line_number);
+				else
+					model->rows[r].rhs = value;
+			}
+			break;
+		case 5:
+			if (number_of_tokens < 3 || (j = stub_names_find(&column_names, tokens[2])) < 0){
+				error = stub_error(model->env, GRB_ERROR_FILE_READ, "Invalid bound in '%s', line %d", filename, line_number);
+				break;
+			}
+			value = number_of_tokens > 3 ? strtod(tokens[3], NULL) : 0.0;
+			if (strcmp(tokens[0], "UP") == 0 || strcmp(tokens[0], "UI") == 0)
+				model->ub[j] = value;
+			else if (strcmp(tokens[0], "LO") == 0 || strcmp(tokens[0], "LI") == 0)
+				model->lb[j] = value;
+			else if (strcmp(tokens[0], "FX") == 0)
+				model->lb[j] = model->ub[j] = value;
+			else if (strcmp(tokens[0], "FR") == 0){
+				model->lb[j] = -GRB_INFINITY;
+				model->ub[j] = GRB_INFINITY;
+			}
+			else if (strcmp(tokens[0], "MI") == 0)
+				model->lb[j] = -GRB_INFINITY;
+			else if (strcmp(tokens[0], "PL") == 0)
+				model->ub[j] = GRB_INFINITY;
+			else if (strcmp(tokens[0], "BV") == 0){
+				model->vtype[j] = GRB_BINARY;
+				model->lb[j] = 0.0;
+				model->ub[j] = 1.0;
+			}
+			else
+				error = stub_error(model->env, GRB_ERROR_FILE_READ, "Unsupported bound type %s in '%s', line %d", tokens[0], filename, line_number);
+			if (error == 0 && (tokens[0][1] == 'I') && model->vtype[j] == GRB_CONTINUOUS)
+				model->vtype[j] = GRB_INTEGER;
+			break;
+		default:
+			error = stub_error(model->env, GRB_ERROR_FILE_READ, "Unexpected data in '%s', line %d", filename, line_number);
+		}
+	}
+	stub_names_free(&row_names);
+	stub_names_free(&column_names);
+	if (error == GRB_ERROR_FILE_READ && model->env->errormsg[0] == '\0')
+		stub_error(model->env, error, "Unable to read '%s', line %d", filename, line_number);
+	return error;
+}
+
+int GRBreadmodel(GRBenv *env, const char *filename, GRBmodel **modelP)
+{
+	GRBmodel *model;
+	FILE *file;
+	int error;
+	if (env == NULL || filename == NULL || modelP == NULL)
+		return GRB_ERROR_NULL_ARGUMENT;
+	*modelP = NULL;
+	if (strcasecmp(stub_extension(filename), "mps") != 0)
+		return stub_error(env, GRB_ERROR_NOT_SUPPORTED, "Unable to read file '%s', only MPS files are supported", filename);
+	file = fopen(filename, "r");
+	if (file == NULL)
+		return stub_error(env, GRB_ERROR_FILE_READ, "Unable to open file '%s' for input", filename);
+	error = GRBnewmodel(env, &model, "", 0, NULL, NULL, NULL, NULL, NULL);
+	if (error){
+		fclose(file);
+		return error;
+	}
+	model->env->errormsg[0] = '\0';
+	error = stub_read_mps(model, file, filename);
+	fclose(file);
+	if (error){
+		strcpy(env->errormsg, model->env->errormsg);
+		GRBfreemodel(model);
+		return error;
+	}
+	*modelP = model;
+	return 0;
+}
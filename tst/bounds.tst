@@ -0,0 +1,54 @@
+#
+# Gurobify: tests of GurobiSetVariableBounds, GurobiFixVariables and GurobiUndoVariableBounds
+#
+gap> START_TEST("bounds.tst");
+gap> model := GurobiNewModel(4, "Binary");;
+gap> GurobiAddConstraint(model, [1, 1, 1, 1], ">", 2);
+true
+gap> GurobiSetObjectiveFunction(model, [1, 2, 3, 4]);
+true
+gap> GurobiUpdateModel(model);;
+gap> nested := GurobiLazyCopy(model, [1, 2], 0);;
+
+# Bounds are undone in reverse order
+gap> GurobiFixVariables(model, [1, 2], 0);
+true
+gap> GurobiOptimiseModel(model);
+2
+gap> Int(Round(GurobiObjectiveValue(model)));
+7
+gap> GurobiSetVariableBounds(model, [3], 0, 0);
+true
+gap> GurobiOptimiseModel(model);
+3
+gap> GurobiUndoVariableBounds(model);
+true
+gap> GurobiOptimiseModel(model);
+2
+gap> Int(Round(GurobiObjectiveValue(model)));
+7
+gap> GurobiUndoVariableBounds(model);
+true
+gap> GurobiOptimiseModel(model);
+2
+gap> Int(Round(GurobiObjectiveValue(model)));
+3
+gap> GurobiUndoVariableBounds(model);
+false
+gap> GurobiFixVariables(model, [1], 0 : undo := false);
+true
+gap> GurobiUndoVariableBounds(model);
+false
+
+# Undoing the bounds of a lazy copy leaves its fixings
+gap> GurobiFixVariables(nested, [3], 0);
+true
+gap> GurobiOptimiseModel(nested);
+3
+gap> GurobiUndoVariableBounds(nested);
+true
+gap> GurobiOptimiseModel(nested);
+2
+gap> Int(Round(GurobiObjectiveValue(nested)));
+7
+gap> STOP_TEST("bounds.tst", 0);
@@ -0,0 +1,45 @@
+#
+# Gurobify: tests of GurobiRecordCallStatistics and GurobiCallStatistics
+#
+gap> START_TEST("callstatistics.tst");
+gap> model := GurobiNewModel(4, "Binary");;
+gap> GurobiAddConstraint(model, [1, 1, 1, 1], ">", 2);
+true
+gap> GurobiSetObjectiveFunction(model, [1, 2, 3, 4]);
+true
+
+# Only calls made while recording is switched on are counted
+gap> GurobiResetCallStatistics();
+true
+gap> GurobiOptimiseModel(model);
+2
+gap> GurobiCallStatistics();
+rec( )
+gap> GurobiRecordCallStatistics(true);
+true
+gap> GurobiOptimiseModel(model);
+2
+gap> GurobiOptimiseModel(model);
+2
+gap> GurobiIntegerParameter(model, "NoSuchParameter");
+Error, Error: Unable to get parameter value. Check parameter type and name.
+gap> GurobiRecordCallStatistics(false);
+true
+gap> GurobiOptimiseModel(model);
+2
+gap> stats := GurobiCallStatistics();;
+gap> stats.GurobiOptimiseModel.calls;
+2
+gap> stats.GurobiOptimiseModel.gurobitime <= stats.GurobiOptimiseModel.time;
+true
+
+# A call which stops with an error is counted as well
+gap> stats.GurobiIntegerParameter.calls;
+1
+gap> GurobiResetCallStatistics();
+true
+gap> GurobiCallStatistics();
+rec( )
+gap> GurobiRecordCallStatistics(1);
+Error, Error: on must be true or false.
+gap> STOP_TEST("callstatistics.tst", 0);
@@ -0,0 +1,61 @@
+#
+# Gurobify: tests of GurobiChangeModel
+#
+gap> START_TEST("changemodel.tst");
+gap> model := GurobiNewModel(4, "Binary");;
+gap> GurobiAddConstraint(model, [1, 1, 1, 1], ">", 2);
+true
+gap> GurobiSetObjectiveFunction(model, [1, 2, 3, 4]);
+true
+gap> GurobiOptimiseModel(model);
+2
+gap> Int(Round(GurobiObjectiveValue(model)));
+3
+gap> GurobiChangeModel(model, rec(Obj := [[1], [10]]));
+true
+gap> GurobiOptimiseModel(model);
+2
+gap> Int(Round(GurobiObjectiveValue(model)));
+5
+gap> GurobiChangeModel(model, rec(RHS := [[0], [3]]));
+true
+gap> GurobiOptimiseModel(model);
+2
+gap> Int(Round(GurobiObjectiveValue(model)));
+9
+gap> GurobiChangeModel(model, rec(Coefficients := [[0], [4], [0]]));
+true
+gap> GurobiOptimiseModel(model);
+2
+gap> Int(Round(GurobiObjectiveValue(model)));
+15
+gap> List(GurobiSolution(model), t -> Int(Round(t)));
+[ 1, 1, 1, 0 ]
+
+# An invalid change leaves the model unchanged
+gap> GurobiChangeModel(model, rec(Obj := [[1], [1]], Coefficients := [[5], [1], [1]]));
+Error, Error: constraint index out of range.
+gap> GurobiChangeModel(model, rec(Obj := [[1], [1]], UB := [[7], [0]]));
+Error, Error: Position out of range.
+gap> GurobiOptimiseModel(model);
+2
+gap> Int(Round(GurobiObjectiveValue(model)));
+15
+gap> GurobiChangeModel(model, rec(LB := [[4], [1]]));
+true
+gap> GurobiOptimiseModel(model);
+2
+gap> Int(Round(GurobiObjectiveValue(model)));
+19
+
+# Changing a lazy copy leaves the model it was copied from unchanged
+gap> copy := GurobiLazyCopy(model);;
+gap> GurobiChangeModel(copy, rec(UB := [[1], [0]]));
+true
+gap> GurobiOptimiseModel(copy);
+3
+gap> GurobiOptimiseModel(model);
+2
+gap> Int(Round(GurobiObjectiveValue(model)));
+19
+gap> STOP_TEST("changemodel.tst", 0);
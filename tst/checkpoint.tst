@@ -0,0 +1,40 @@
+#
+# Gurobify: tests of resuming GurobiFindAllBinarySolutions from checkpoints
+#
+gap> START_TEST("checkpoint.tst");
+gap> Quietly := function(f) local out; out := OutputTextNone(); PrintTo1(out, f); CloseStream(out); end;;
+gap> expected := Set(List(Combinations([1 .. 6], 3), s -> IndexSetToCharacteristicVector(s, 6)));;
+gap> model := GurobiNewModel(6, "Binary");;
+gap> solutions := [];; resumed := [];;
+gap> Quietly(function() solutions := GurobiFindAllBinarySolutions(model, 3); end);
+gap> Length(solutions);
+20
+gap> Set(solutions) = expected;
+true
+gap> GurobiNumberOfConstraints(model);
+0
+
+# Resuming from a checkpoint keeps the solutions found before
+gap> file := Filename(DirectoryTemporary(), "checkpoint");;
+gap> GurobiReadCheckpoint(file, 6, 3);
+fail
+gap> GurobiWriteCheckpoint(file, 6, 3, solutions{[1 .. 5]});
+true
+gap> GurobiReadCheckpoint(file, 6, 3) = solutions{[1 .. 5]};
+true
+gap> Quietly(function() resumed := GurobiFindAllBinarySolutions(model, 3 : checkpoint := file, checkpointinterval := 2); end);
+gap> Length(resumed);
+20
+gap> Set(resumed) = expected;
+true
+gap> resumed{[1 .. 5]} = solutions{[1 .. 5]};
+true
+gap> Set(GurobiReadCheckpoint(file, 6, 3)) = expected;
+true
+gap> Length(GurobiReadCheckpoint(file, 6, 3));
+20
+gap> GurobiReadCheckpoint(file, 6, 2);
+Error, Error: The checkpoint file does not belong to solutions of this size of a model with this number of variables.
+gap> GurobiNumberOfConstraints(model);
+0
+gap> STOP_TEST("checkpoint.tst", 0);
@@ -0,0 +1,52 @@
+#
+# Gurobify: tests of GurobiCheckSolutions
+#
+gap> START_TEST("checksolutions.tst");
+gap> model := GurobiNewModel(3, "Binary");;
+gap> GurobiAddConstraint(model, [1, 1, 1], ">", 2);
+true
+gap> GurobiAddConstraint(model, [1, -1, 0], "=", 0);
+true
+gap> GurobiUpdateModel(model);
+true
+
+# Each candidate gets the position of the first constraint it violates, and the bounds are not checked
+gap> candidates := [ [1, 1, 0], [1, 0, 1], [0, 0, 0], [0.5, 0.5, 1], [2, 2, 2] ];;
+gap> result := GurobiCheckSolutions(model, candidates);;
+gap> result.feasible;
+[ true, false, false, true, true ]
+gap> result.violated;
+[ fail, 1, 0, fail, fail ]
+gap> GurobiCheckSolutions(model, candidates : threads := 2) = GurobiCheckSolutions(model, candidates);
+true
+
+# The constraints are read again once the model is updated, even if they were read before the update
+gap> GurobiAddConstraint(model, [0, 0, 1], "<", 0);
+true
+gap> GurobiCheckSolutions(model, candidates);;
+gap> GurobiUpdateModel(model);
+true
+gap> GurobiCheckSolutions(model, candidates).violated;
+[ fail, 1, 0, 2, 2 ]
+
+# Deleting a constraint renumbers the others
+gap> GurobiDeleteConstraints(model, [0]);
+true
+gap> GurobiUpdateModel(model);
+true
+gap> GurobiCheckSolutions(model, candidates).violated;
+[ fail, 0, fail, 1, 1 ]
+
+# A lazy copy is checked with its own constraints, and the model with its constraints
+gap> lazy := GurobiLazyCopy(model);;
+gap> GurobiAddConstraint(lazy, [1, 1, 1], "<", 1);
+true
+gap> GurobiUpdateModel(lazy);
+true
+gap> GurobiCheckSolutions(lazy, candidates).violated;
+[ 2, 0, fail, 1, 1 ]
+gap> GurobiCheckSolutions(model, candidates).violated;
+[ fail, 0, fail, 1, 1 ]
+gap> GurobiCheckSolutions(model, [ [1, 1] ]);
+Error, Error: each candidate must have one value for each variable.
+gap> STOP_TEST("checksolutions.tst", 0);
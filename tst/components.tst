@@ -0,0 +1,53 @@
+#
+# Gurobify: tests of GurobiComponents, GurobiOptimiseComponents and GurobiFindAllComponentSolutions
+#
+gap> START_TEST("components.tst");
+gap> model := GurobiNewModel(6, "Binary");;
+gap> GurobiAddConstraint(model, [1, 1, 1, 0, 0, 0], "=", 1);
+true
+gap> GurobiAddConstraint(model, [0, 0, 0, 1, 1, 1], ">", 2);
+true
+gap> GurobiSetObjectiveFunction(model, [1, 2, 3, 4, 5, 6]);
+true
+gap> GurobiUpdateModel(model);
+true
+gap> components := GurobiComponents(model);;
+gap> Set(List(components, c -> [ c.variables, c.constraints ]));
+[ [ [ 1, 2, 3 ], [ 0 ] ], [ [ 4, 5, 6 ], [ 1 ] ] ]
+gap> List(GurobiComponentModels(model), GurobiNumberOfVariables);
+[ 3, 3 ]
+
+# The components are solved separately, and the model is left without a solution
+gap> result := GurobiOptimiseComponents(model);;
+gap> [ result.status, result.statuses ];
+[ 2, [ 2, 2 ] ]
+gap> Int(Round(result.objective));
+10
+gap> List(result.solution, t -> Int(Round(t)));
+[ 1, 0, 0, 1, 1, 0 ]
+gap> IsBound(GurobiSolveStatistics(model).ObjVal);
+false
+gap> threaded := GurobiOptimiseComponents(model : threads := 2);;
+gap> [ threaded.status, Int(Round(threaded.objective)) ];
+[ 2, 10 ]
+
+# A single infeasible component makes the whole model infeasible
+gap> copy := ShallowCopy(model);;
+gap> GurobiAddConstraint(copy, [0, 0, 0, 1, 1, 1], "<", 1);
+true
+gap> GurobiUpdateModel(copy);
+true
+gap> result := GurobiOptimiseComponents(copy);;
+gap> [ result.status, result.objective, result.solution, Set(result.statuses) ];
+[ 3, fail, fail, [ 2, 3 ] ]
+
+# All solutions are the combinations of the solutions of the components
+gap> solutions := GurobiFindAllComponentSolutions(model);;
+gap> Length(solutions);
+12
+gap> ForAll(solutions, s -> Sum(s{[1 .. 3]}) = 1 and Sum(s{[4 .. 6]}) >= 2);
+true
+gap> separate := GurobiFindAllComponentSolutions(model : components := true);;
+gap> Set(List(separate, c -> [ c.variables, Length(c.solutions) ]));
+[ [ [ 1, 2, 3 ], 3 ], [ [ 4, 5, 6 ], 4 ] ]
+gap> STOP_TEST("components.tst", 0);
@@ -0,0 +1,29 @@
+#
+# Gurobify: tests of counting the orbits of solutions with GurobiFindAllBinarySolutions
+#
+gap> START_TEST("count.tst");
+gap> Quietly := function(f) local out; out := OutputTextNone(); PrintTo1(out, f); CloseStream(out); end;;
+gap> expected := Set(List(Combinations([1 .. 6], 3), s -> IndexSetToCharacteristicVector(s, 6)));;
+gap> model := GurobiNewModel(6, "Binary");;
+gap> counted := rec();; orbits := [];;
+
+# Up to a cyclic group the 3-subsets of 6 points form 4 orbits
+gap> gp := Group((1, 2, 3, 4, 5, 6));;
+gap> Quietly(function() orbits := GurobiFindAllBinarySolutions(model, 3, gp); end);
+gap> Set(orbits) = expected;
+true
+gap> Quietly(function() counted := GurobiFindAllBinarySolutions(model, 3, gp : count := true); end);
+gap> counted.solutions;
+20
+gap> counted.orbits;
+4
+gap> counted.lengths;
+[ [ 2, 1 ], [ 6, 3 ] ]
+gap> Quietly(function() counted := GurobiFindAllBinarySolutions(model, 3, gp : count := true, representatives := true); end);
+gap> Length(counted.representatives);
+4
+gap> Set(List(counted.representatives, s -> Set(Orbit(gp, s, Permuted)))) = Set(List(expected, s -> Set(Orbit(gp, s, Permuted))));
+true
+gap> GurobiNumberOfConstraints(model);
+0
+gap> STOP_TEST("count.tst", 0);
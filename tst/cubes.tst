@@ -0,0 +1,21 @@
+#
+# Gurobify: tests of enumerating binary solutions in cubes across worker processes
+#
+gap> START_TEST("cubes.tst");
+gap> expected := Set(List(Combinations([1 .. 6], 3), s -> IndexSetToCharacteristicVector(s, 6)));;
+gap> model := GurobiNewModel(6, "Binary");;
+
+# Workers enumerating cubes find the same solutions as a sequential enumeration
+gap> found := GurobiFindAllBinarySolutions(model, 3 : workers := 2);;
+gap> Length(found);
+20
+gap> Set(found) = expected;
+true
+gap> found := GurobiFindAllBinarySolutions(model, 3 : workers := 3, prefix := [2, 4]);;
+gap> Length(found);
+20
+gap> Set(found) = expected;
+true
+gap> GurobiNumberOfConstraints(model);
+0
+gap> STOP_TEST("cubes.tst", 0);
@@ -0,0 +1,59 @@
+#
+# Gurobify: tests of loading the Gurobi environment only while models exist
+#
+gap> START_TEST("environment.tst");
+
+# Models left by other tests are dropped, so that the environment is released once they are collected
+gap> Sweep := function()
+>   local name, value;
+>   for name in NamesUserGVars() do
+>     if IsBoundGlobal(name) and not IsReadOnlyGlobal(name) then
+>       value := ValueGlobal(name);
+>       if IsGurobiModel(value) or (IsRecord(value) and ForAny(RecNames(value), r -> IsGurobiModel(value.(r))))
+>           or (IsDenseList(value) and ForAny(value, IsGurobiModel)) then
+>         UnbindGlobal(name);
+>       fi;
+>     fi;
+>   od;
+> end;;
+gap> Sweep();
+gap> 1;
+1
+gap> 2;
+2
+gap> 3;
+3
+gap> GASMAN("collect");
+gap> GurobiResetCallStatistics();
+true
+gap> GurobiRecordCallStatistics(true);
+true
+
+# The environment is loaded for the first model, and shared by the models created while it exists
+gap> model := GurobiNewModel(2, "Binary");;
+gap> GurobiCallStatistics().GRBloadenv.calls;
+1
+gap> copy := ShallowCopy(model);;
+gap> other := GurobiNewModel(3, "Binary");;
+gap> GurobiCallStatistics().GRBloadenv.calls;
+1
+
+# Once all models are freed it is released, and loaded again for the next model
+gap> Unbind(model);; Unbind(copy);; Unbind(other);;
+gap> 1;
+1
+gap> 2;
+2
+gap> 3;
+3
+gap> GASMAN("collect");
+gap> model := GurobiNewModel(2, "Binary");;
+gap> GurobiOptimiseModel(model);
+2
+gap> GurobiCallStatistics().GRBloadenv.calls;
+2
+gap> GurobiRecordCallStatistics(false);
+true
+gap> GurobiResetCallStatistics();
+true
+gap> STOP_TEST("environment.tst", 0);
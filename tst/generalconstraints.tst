@@ -0,0 +1,66 @@
+#
+# Gurobify: tests of indicator, SOS and general constraints
+#
+gap> START_TEST("generalconstraints.tst");
+
+# If the first variable is 1, then so are the last two
+gap> model := GurobiNewModel(4, "Binary");;
+gap> GurobiAddConstraint(model, [1, 1, 0, 0], ">", 1);
+true
+gap> GurobiAddIndicatorConstraint(model, 1, 1, [0, 0, 1, 1], ">", 2, "implies");
+true
+gap> GurobiSetObjectiveFunction(model, [1, 4, 1, 1]);
+true
+gap> GurobiOptimiseModel(model);
+2
+gap> List(GurobiSolution(model), t -> Int(Round(t)));
+[ 1, 0, 1, 1 ]
+gap> GurobiIntegerAttribute(model, "NumGenConstrs");
+1
+
+# A batch with an invalid constraint adds none of them
+gap> GurobiAddIndicatorConstraints(model, [ [1, 0], [2, 2] ], [ [0, 0, 1, 0], [0, 0, 0, 1] ], [ "<", "<" ], [ 0, 0 ]);
+Error, Error: the value of an indicator must be 0 or 1.
+gap> GurobiUpdateModel(model);
+true
+gap> GurobiIntegerAttribute(model, "NumGenConstrs");
+1
+
+# At most one of the first two variables is nonzero
+gap> model := GurobiNewModel(3, "Binary");;
+gap> GurobiAddConstraint(model, [1, 1, 1], ">", 2);
+true
+gap> GurobiAddSOSConstraint(model, 1, [1, 2]);
+true
+gap> GurobiSetObjectiveFunction(model, [1, 1, 5]);
+true
+gap> GurobiOptimiseModel(model);
+2
+gap> Int(Round(GurobiObjectiveValue(model)));
+6
+gap> GurobiAddSOSConstraints(model, [ 1, 3 ], [ [2, 3], [1, 3] ]);
+Error, Error: SOS types must be 1 or 2.
+gap> GurobiUpdateModel(model);
+true
+gap> GurobiIntegerAttribute(model, "NumSOS");
+1
+
+# The third variable is the conjunction of the first two
+gap> model := GurobiNewModel(3, "Binary");;
+gap> GurobiAddConstraint(model, [0, 0, 1], ">", 1);
+true
+gap> GurobiAddGeneralConstraints(model, [ "and" ], [ 3 ], [ [1, 2] ]);
+true
+gap> GurobiSetObjectiveFunction(model, [1, 1, 0]);
+true
+gap> GurobiOptimiseModel(model);
+2
+gap> List(GurobiSolution(model), t -> Int(Round(t)));
+[ 1, 1, 1 ]
+gap> GurobiAddGeneralConstraints(model, [ "or", "or" ], [ 1, 9 ], [ [2, 3], [2, 3] ]);
+Error, Error: variable index out of range.
+gap> GurobiUpdateModel(model);
+true
+gap> GurobiIntegerAttribute(model, "NumGenConstrs");
+1
+gap> STOP_TEST("generalconstraints.tst", 0);
@@ -0,0 +1,38 @@
+#
+# Gurobify: tests of GurobiComputeIIS
+#
+gap> START_TEST("iis.tst");
+gap> model := GurobiNewModel(3, "Binary");;
+gap> GurobiAddConstraint(model, [1, 1, 0], ">", 2, "a");
+true
+gap> GurobiAddConstraint(model, [0, 0, 1], "<", 1, "free");
+true
+gap> GurobiAddConstraint(model, [1, 1, 0], "<", 1, "b");
+true
+gap> GurobiOptimiseModel(model);
+3
+
+# Only the two conflicting constraints form the IIS, and they are identified by position and by name
+gap> iis := GurobiComputeIIS(model);;
+gap> [ iis.constraints, iis.constraintnames, iis.lowerbounds, iis.upperbounds ];
+[ [ 0, 2 ], [ "a", "b" ], [  ], [  ] ]
+
+# The positions refer to the current model
+gap> GurobiDeleteConstraints(model, [0]);
+true
+gap> GurobiAddConstraint(model, [1, 0, 1], ">", 3, "c");
+true
+gap> GurobiUpdateModel(model);
+true
+gap> iis := GurobiComputeIIS(model);;
+gap> [ iis.constraints, iis.constraintnames ];
+[ [ 2 ], [ "c" ] ]
+
+# A feasible model has no IIS
+gap> GurobiDeleteConstraintsWithName(model, "c");
+true
+gap> GurobiUpdateModel(model);
+true
+gap> GurobiComputeIIS(model);
+fail
+gap> STOP_TEST("iis.tst", 0);
@@ -0,0 +1,32 @@
+#
+# Gurobify: tests of GurobiKramerMesnerModel
+#
+gap> START_TEST("kramermesner.tst");
+gap> Quietly := function(f) local out; out := OutputTextNone(); PrintTo1(out, f); CloseStream(out); end;;
+gap> solutions := [];;
+
+# Under a cyclic group of order 7 the 2-subsets form 3 orbits and the 3-subsets 5
+gap> km := GurobiKramerMesnerModel(7, [ (1, 2, 3, 4, 5, 6, 7) ], 2, 3, 1);;
+gap> km.torbits;
+[ [ 1, 2 ], [ 1, 3 ], [ 1, 4 ] ]
+gap> km.korbits;
+[ [ 1, 2, 3 ], [ 1, 2, 4 ], [ 1, 3, 4 ], [ 1, 2, 5 ], [ 1, 3, 5 ] ]
+gap> [ GurobiNumberOfConstraints(km.model), GurobiNumberOfVariables(km.model) ];
+[ 3, 5 ]
+gap> Set(GurobiVariableTypes(km.model));
+[ "B" ]
+gap> List(GurobiDoubleAttributeArray(km.model, "RHS"), t -> Int(Round(t)));
+[ 1, 1, 1 ]
+
+# Its two solutions are the Fano planes given by the difference sets {1, 2, 4} and {1, 3, 4}
+gap> Quietly(function() solutions := GurobiFindAllBinarySolutions(km.model, 1); end);
+gap> solutions;
+[ [ 0, 0, 1, 0, 0 ], [ 0, 1, 0, 0, 0 ] ]
+gap> List(solutions, s -> km.korbits[Position(s, 1)]);
+[ [ 1, 3, 4 ], [ 1, 2, 4 ] ]
+
+# The generators may also be given as lists of images, and the result does not depend on the threads
+gap> other := GurobiKramerMesnerModel(7, [ [2, 3, 4, 5, 6, 7, 1] ], 2, 3, 1 : threads := 2);;
+gap> [ other.torbits, other.korbits ] = [ km.torbits, km.korbits ];
+true
+gap> STOP_TEST("kramermesner.tst", 0);
@@ -0,0 +1,51 @@
+#
+# Gurobify: tests of GurobiLazyCopy and GurobiUndoVariableBounds
+#
+gap> START_TEST("lazycopy.tst");
+gap> model := GurobiNewModel(4, "Binary");;
+gap> GurobiAddConstraint(model, [1, 1, 1, 1], ">", 2);
+true
+gap> GurobiSetObjectiveFunction(model, [1, 2, 3, 4]);
+true
+gap> GurobiUpdateModel(model);;
+
+# A lazy copy sees its fixings, and the model it shares does not
+gap> copy := GurobiLazyCopy(model, [1], 0);;
+gap> GurobiOptimiseModel(copy);
+2
+gap> Int(Round(GurobiObjectiveValue(copy)));
+5
+gap> List(GurobiSolution(copy), t -> Int(Round(t)));
+[ 0, 1, 1, 0 ]
+gap> GurobiOptimiseModel(model);
+2
+gap> Int(Round(GurobiObjectiveValue(model)));
+3
+gap> GurobiOptimiseModel(copy);
+2
+gap> Int(Round(GurobiObjectiveValue(copy)));
+5
+
+# A lazy copy of a lazy copy inherits its fixings
+gap> nested := GurobiLazyCopy(copy, [2], 0);;
+gap> GurobiOptimiseModel(nested);
+2
+gap> Int(Round(GurobiObjectiveValue(nested)));
+7
+
+# Constraints added to a lazy copy stay in the copy
+gap> GurobiAddConstraint(copy, [0, 0, 1, 1], "<", 0);
+true
+gap> GurobiOptimiseModel(copy);
+3
+gap> GurobiOptimiseModel(nested);
+2
+gap> Int(Round(GurobiObjectiveValue(nested)));
+7
+gap> GurobiOptimiseModel(model);
+2
+gap> Int(Round(GurobiObjectiveValue(model)));
+3
+gap> GurobiNumberOfConstraints(model);
+1
+gap> STOP_TEST("lazycopy.tst", 0);
@@ -0,0 +1,60 @@
+#
+# Gurobify: tests of GurobiCaptureLog, GurobiLogMessages and GurobiLogProgress
+#
+gap> START_TEST("log.tst");
+gap> model := GurobiNewModel(4, "Binary");;
+gap> GurobiAddConstraint(model, [1, 1, 1, 1], ">", 2);
+true
+gap> GurobiSetObjectiveFunction(model, [1, 2, 3, 4]);
+true
+
+# Nothing is captured until asked for
+gap> GurobiOptimiseModel(model);
+2
+gap> GurobiLogMessages(model);
+[  ]
+gap> GurobiLogProgress(model);
+[  ]
+
+# The log is captured although it is not printed, without the final newlines
+gap> GurobiCaptureLog(model, 100);
+true
+gap> GurobiOptimiseModel(model);
+2
+gap> messages := GurobiLogMessages(model);;
+gap> messages <> [] and ForAll(messages, IsString);
+true
+gap> ForAny(messages, m -> PositionSublist(m, "Optimal solution found") <> fail);
+true
+gap> ForAny(messages, m -> m <> "" and m[Length(m)] = '\n');
+false
+
+# The last row of progress is the state at the end
+gap> progress := GurobiLogProgress(model);;
+gap> last := progress[Length(progress)];;
+gap> [ Int(Round(last.incumbent)), Int(Round(last.bound)), last.gap < 10^-4 ];
+[ 3, 3, true ]
+
+# Only the newest lines are kept, and each optimisation starts afresh
+gap> GurobiCaptureLog(model, 2);
+true
+gap> GurobiOptimiseModel(model);
+2
+gap> GurobiOptimiseModel(model);
+2
+gap> messages := GurobiLogMessages(model);;
+gap> Length(messages) <= 2 and Length(GurobiLogProgress(model)) <= 2;
+true
+gap> ForAny(messages, m -> PositionSublist(m, "Optimal solution found") <> fail);
+true
+
+# A capacity of 0 stops capturing
+gap> GurobiCaptureLog(model, 0);
+true
+gap> GurobiOptimiseModel(model);
+2
+gap> GurobiLogMessages(model);
+[  ]
+gap> GurobiCaptureLog(model, -1);
+Error, Error: Capacity must be a non-negative integer.
+gap> STOP_TEST("log.tst", 0);
@@ -0,0 +1,49 @@
+#
+# Gurobify: tests of GurobiSetObjectiveFunctions and GurobiObjectiveValues
+#
+gap> START_TEST("objectives.tst");
+gap> model := GurobiNewModel(4, "Binary");;
+gap> GurobiAddConstraint(model, [1, 1, 1, 1], ">", 2);
+true
+
+# The objectives are optimised in the order of the list
+gap> GurobiSetObjectiveFunctions(model, [ [3, 1, 1, 1], [0, 4, 4, 0] ]);
+true
+gap> GurobiOptimiseModel(model);
+2
+gap> List(GurobiObjectiveValues(model), t -> Int(Round(t)));
+[ 2, 4 ]
+gap> GurobiSolution(model)[4] > 0.5;
+true
+
+# Objectives of equal priority are blended
+gap> GurobiSetObjectiveFunctions(model, [ [3, 1, 1, 1], [0, 4, 4, 0] ] : priorities := [0, 0]);
+true
+gap> GurobiOptimiseModel(model);
+2
+gap> List(GurobiObjectiveValues(model), t -> Int(Round(t)));
+[ 4, 0 ]
+gap> List(GurobiSolution(model), t -> Int(Round(t)));
+[ 1, 0, 0, 1 ]
+
+# The objective values of a lazy copy are read from the shared model, which is left as it was
+gap> GurobiSetObjectiveFunctions(model, [ [3, 1, 1, 1], [0, 4, 4, 0] ]);
+true
+gap> lazy := GurobiLazyCopy(model, [4], 0);;
+gap> GurobiOptimiseModel(lazy);
+2
+gap> List(GurobiObjectiveValues(lazy), t -> Int(Round(t)));
+[ 2, 8 ]
+gap> GurobiIntegerParameter(lazy, "ObjNumber");
+0
+gap> GurobiOptimiseModel(model);
+2
+gap> List(GurobiObjectiveValues(model), t -> Int(Round(t)));
+[ 2, 4 ]
+
+# An invalid objective leaves the objectives as they were
+gap> GurobiSetObjectiveFunctions(model, [ [1, 1, 1, 1], [1, 1] ]);
+Error, Error: Each objective must have a coefficient for every variable.
+gap> GurobiIntegerAttribute(model, "NumObj");
+2
+gap> STOP_TEST("objectives.tst", 0);
@@ -0,0 +1,34 @@
+#
+# Gurobify: tests of GurobiSolutionOrbitRepresentatives
+#
+gap> START_TEST("orbits.tst");
+gap> solutions := List(Combinations([1 .. 6], 3), s -> IndexSetToCharacteristicVector(s, 6));;
+gap> gp := Group((1, 2, 3, 4, 5, 6));;
+gap> orbits := GurobiSolutionOrbitRepresentatives(solutions, gp);;
+gap> Length(orbits.representatives);
+4
+gap> SortedList(orbits.multiplicities);
+[ 2, 6, 6, 6 ]
+gap> orbits.representatives[1] = solutions[1];
+true
+gap> ForAll([1 .. Length(solutions)], i -> orbits.representatives[orbits.classes[i]] in Orbit(gp, solutions[i], Permuted));
+true
+gap> List(orbits.representatives, s -> Position(solutions, s)) = Set(List(orbits.classes, c -> Position(orbits.classes, c)));
+true
+
+# Threads give the same result
+gap> GurobiSolutionOrbitRepresentatives(solutions, gp : threads := 4) = orbits;
+true
+
+# Repeated solutions are counted in the multiplicities of their orbits
+gap> repeated := Concatenation(solutions, solutions{[1 .. 3]});;
+gap> again := GurobiSolutionOrbitRepresentatives(repeated, gp);;
+gap> again.representatives = orbits.representatives;
+true
+gap> Sum(again.multiplicities);
+23
+gap> again.classes{[21 .. 23]} = orbits.classes{[1 .. 3]};
+true
+gap> GurobiSolutionOrbitRepresentatives([], gp).representatives;
+[  ]
+gap> STOP_TEST("orbits.tst", 0);
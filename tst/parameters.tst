@@ -0,0 +1,47 @@
+#
+# Gurobify: tests of GurobiParameters, GurobiSetParameters and GurobiTuneModels
+#
+gap> START_TEST("parameters.tst");
+gap> model := GurobiNewModel(4, "Binary");;
+gap> GurobiAddConstraint(model, [1, 1, 1, 1], ">", 2);
+true
+gap> GurobiSetObjectiveFunction(model, [1, 2, 3, 4]);
+true
+gap> IsBound(GurobiParameters(model).MIPFocus);
+false
+
+# Only parameters which differ from their defaults are returned, and they can be applied to other models
+gap> GurobiSetParameters(model, rec(MIPFocus := 1, Seed := 3, TimeLimit := 100));
+true
+gap> parameters := GurobiParameters(model);;
+gap> [ parameters.MIPFocus, parameters.Seed, Int(parameters.TimeLimit) ];
+[ 1, 3, 100 ]
+gap> other := GurobiNewModel(4, "Binary");;
+gap> GurobiAddConstraint(other, [1, 1, 1, 1], ">", 3);
+true
+gap> GurobiSetParameters(other, parameters);
+true
+gap> GurobiParameters(other) = parameters;
+true
+gap> GurobiIntegerParameter(other, "Seed");
+3
+gap> GurobiSetParameters(other, rec(MIPFocus := 1.5));
+Error, Error: The value of parameter MIPFocus must be an integer.
+gap> GurobiSetParameters(other, rec(NoSuchParameter := 1));
+Error, Error: Unknown parameter NoSuchParameter.
+
+# The best parameters found by tuning are set for the first model, and the tuning time limit is restored
+gap> tuned := GurobiTuneModels([model, other], 1);;
+gap> IsRecord(tuned);
+true
+gap> GurobiParameters(model) = tuned;
+true
+gap> Int(GurobiDoubleParameter(model, "TuneTimeLimit"));
+-1
+gap> GurobiOptimiseModel(model);
+2
+gap> Int(Round(GurobiObjectiveValue(model)));
+3
+gap> GurobiTuneModels([], 1);
+Error, Error: Models must be a non-empty list of Gurobi models.
+gap> STOP_TEST("parameters.tst", 0);
@@ -0,0 +1,44 @@
+#
+# Gurobify: tests of GurobiPresolveModel, GurobiPresolvedVariables and GurobiPresolvedScenarios
+#
+gap> START_TEST("presolve.tst");
+gap> model := GurobiNewModel(4, "Binary");;
+gap> GurobiSetVariableNames(model, ["a", "b", "c", "d"]);
+true
+gap> GurobiAddConstraint(model, [1, 1, 1, 1], ">", 2);
+true
+gap> GurobiSetObjectiveFunction(model, [1, 2, 3, 4]);
+true
+gap> presolved := GurobiPresolveModel(model);;
+gap> GurobiPresolvedVariables(presolved);
+[ 1, 2, 3, 4 ]
+gap> GurobiPresolvedVariables(model);
+fail
+
+# Presolve leaves the parameters of the original model as they were
+gap> GurobiIntegerParameter(model, "DualReductions");
+1
+gap> GurobiIntegerParameter(model, "Aggregate");
+1
+
+# Scenarios of the original model are solved against the presolved model
+gap> scenarios := [ rec(Obj := [[1, 4], [5, 6]]), rec(UB := [[2], 0]) ];;
+gap> translated := GurobiPresolvedScenarios(presolved, scenarios);
+[ rec( Obj := [ [ 1, 4 ], [ 5, 6 ] ] ), rec( UB := [ [ 2 ], 0 ] ) ]
+gap> result := GurobiSolveScenarios(presolved, translated);;
+gap> result.status;
+[ 2, 2 ]
+gap> List(result.objective, t -> Int(Round(t)));
+[ 5, 4 ]
+
+# Scenarios which presolve may have relied on are refused
+gap> GurobiPresolvedScenarios(presolved, [ rec(UB := [[2], 2]) ]);
+Error: Scenarios can only tighten the bounds of the presolved model.
+fail
+gap> GurobiPresolvedScenarios(presolved, [ rec(RHS := [[0], 3]) ]);
+Error: Scenarios changing RHS cannot be translated to the presolved model.
+fail
+gap> GurobiPresolvedScenarios(model, scenarios);
+Error: Model must be returned by GurobiPresolveModel.
+fail
+gap> STOP_TEST("presolve.tst", 0);
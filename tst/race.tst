@@ -0,0 +1,46 @@
+#
+# Gurobify: tests of GurobiRaceModel
+#
+gap> START_TEST("race.tst");
+gap> model := GurobiNewModel(4, "Binary");;
+gap> GurobiAddConstraint(model, [1, 1, 1, 1], ">", 2);
+true
+gap> GurobiSetObjectiveFunction(model, [1, 2, 3, 4]);
+true
+gap> GurobiSetIntegerParameter(model, "MIPFocus", 2);;
+gap> race := GurobiRaceModel(model, 3);;
+gap> race.status;
+2
+gap> race.winner in [1 .. 3];
+true
+gap> Length(race.statuses);
+3
+gap> Int(Round(GurobiObjectiveValue(model)));
+3
+gap> List(GurobiSolution(model), t -> Int(Round(t)));
+[ 1, 1, 0, 0 ]
+
+# The model keeps its own parameters
+gap> GurobiIntegerParameter(model, "MIPFocus");
+2
+gap> GurobiIntegerParameter(model, "Threads");
+0
+
+# Copies of the winner are independent of it, and it may race again
+gap> copy := ShallowCopy(model);;
+gap> race := GurobiRaceModel(model, [ rec(Seed := 1), rec(MIPFocus := 1) ]);;
+gap> race.status;
+2
+gap> Int(Round(GurobiObjectiveValue(model)));
+3
+gap> GurobiOptimiseModel(copy);
+2
+gap> Int(Round(GurobiObjectiveValue(copy)));
+3
+gap> lazy := GurobiLazyCopy(model, [1], 0);;
+gap> Unbind(model);; GASMAN("collect");
+gap> GurobiOptimiseModel(lazy);
+2
+gap> Int(Round(GurobiObjectiveValue(lazy)));
+5
+gap> STOP_TEST("race.tst", 0);
@@ -0,0 +1,36 @@
+#
+# Gurobify: tests of GurobiSolveScenarios
+#
+gap> START_TEST("scenarios.tst");
+gap> model := GurobiNewModel(4, "Binary");;
+gap> GurobiAddConstraint(model, [1, 1, 1, 1], ">", 2);
+true
+gap> GurobiSetObjectiveFunction(model, [1, 2, 3, 4]);
+true
+gap> scenarios := [ rec(), rec(Obj := [[1], [10]]), rec(RHS := [[0], [3]]),
+>                   rec(UB := [[1, 2], 0]), rec(RHS := [[0], [5]]) ];;
+gap> result := GurobiSolveScenarios(model, scenarios : solutions := true);;
+gap> result.status;
+[ 2, 2, 2, 2, 3 ]
+gap> List(result.objective{[1 .. 4]}, t -> Int(Round(t)));
+[ 3, 5, 6, 7 ]
+gap> result.objective[5];
+fail
+gap> List(result.solutions[1], t -> Int(Round(t)));
+[ 1, 1, 0, 0 ]
+gap> List(result.solutions[4], t -> Int(Round(t)));
+[ 0, 0, 1, 1 ]
+
+# More threads give the same results
+gap> threaded := GurobiSolveScenarios(model, scenarios : threads := 2);;
+gap> threaded.status = result.status;
+true
+gap> List(threaded.objective{[1 .. 4]}, t -> Int(Round(t)));
+[ 3, 5, 6, 7 ]
+
+# The model is left unchanged
+gap> GurobiOptimiseModel(model);
+2
+gap> Int(Round(GurobiObjectiveValue(model)));
+3
+gap> STOP_TEST("scenarios.tst", 0);
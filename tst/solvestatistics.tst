@@ -0,0 +1,45 @@
+#
+# Gurobify: tests of GurobiSolveStatistics
+#
+gap> START_TEST("solvestatistics.tst");
+gap> model := GurobiNewModel(4, "Binary");;
+gap> GurobiAddConstraint(model, [1, 1, 1, 1], ">", 2);
+true
+gap> GurobiSetObjectiveFunction(model, [1, 2, 3, 4]);
+true
+
+# Attributes which are not available yet are left out
+gap> stats := GurobiSolveStatistics(model);;
+gap> stats.Status;
+1
+gap> stats.SolCount;
+0
+gap> IsBound(stats.ObjVal) or IsBound(stats.ObjBound) or IsBound(stats.MIPGap);
+false
+gap> [ stats.NumVars, stats.NumConstrs, stats.NumNZs, stats.NumBinVars, stats.NumIntVars, stats.ModelSense ];
+[ 4, 1, 4, 4, 4, 1 ]
+
+# After optimising, the results are all in the same record
+gap> GurobiOptimiseModel(model);
+2
+gap> stats := GurobiSolveStatistics(model);;
+gap> stats.Status;
+2
+gap> stats.SolCount > 0;
+true
+gap> Int(Round(stats.ObjVal));
+3
+gap> Int(Round(stats.ObjBound));
+3
+gap> stats.MIPGap < 10^-4;
+true
+gap> IsFloat(stats.Runtime) and IsFloat(stats.NodeCount);
+true
+gap> GurobiMaximiseModel(model);
+true
+gap> GurobiOptimiseModel(model);
+2
+gap> stats := GurobiSolveStatistics(model);;
+gap> [ stats.ModelSense, Int(Round(stats.ObjVal)) ];
+[ -1, 10 ]
+gap> STOP_TEST("solvestatistics.tst", 0);